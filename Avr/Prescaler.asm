@@ -1,7 +1,7 @@
 ;----------------------------------------------------------------------------
 
 ;Title	: FC-510 prescaler (LMX2324)
-;Version: 1.00
+;Version: 1.10
 ;Target	: ATtiny12
 ;Author	: wubblick@yahoo.com
 
@@ -12,6 +12,12 @@
 ;Int RCosc, Startup 4.2ms + 6 CK
 ;No BOD function
 
+;    ATmega8   
+;( , pull-up   ):  PB7 (XTAL2) ATmega8 -
+; PB4 ATtiny12 (  RC- ). 
+;    ,   Prescaler_C/Main.c (ATtiny25).
+;   EEPROM ( 0, 1),   - N.
+
 ;----------------------------------------------------------------------------
 
 .include "tn12def.inc"
@@ -20,7 +26,7 @@
 
 ;:
 
-.equ N = 256   ;  
+.equ N = 256   ;   
 
 .equ PRE = 32  ;   
 .equ NR = 2    ;  Ref ( )
@@ -57,13 +63,16 @@
 
 ;----------------------------------------------------------------------------
 
+.equ LINK_BITS = 16 ;   
+.equ LINK_T = 40    ;  ,   3  (~100 )
+
 ;Ports definition:
 
 .equ SDATA  = PB0 ; SDATA
 .equ LE     = PB1 ; LE
 .equ SCLK   = PB2 ; SCLK
 .equ NCPB3  = PB3
-.equ NCPB4  = PB4
+.equ LINK   = PB4 ;   ATmega8 ( )
 
 ;  B:
 .equ DIRB   = (1 << SDATA) | (1 << LE) | (1 << SCLK)
@@ -78,39 +87,133 @@
 .def tempM = r17
 .def tempH = r18
 .def Cnt   = r19
+.def NL    = r20 ; 
+.def NH    = r21
+.def RxL   = r22 ; 
+.def RxH   = r23
+.def LoL   = r24 ;  
+.def LoH   = r25
+.def HiL   = r26 ;  
+.def HiH   = r27
+.def Dly   = r28
 
 ;----------------------------------------------------------------------------
 
 .CSEG
 .org 0
+	rjmp Init
+
+.org PCI0addr
+	reti        ;   :    
 
 ;:
 
+Init:
 	ldi	tempL,PUPB
 	out	PORTB,tempL
 	ldi	tempL,DIRB	
 	out	DDRB,tempL
 
+;  EEPROM:
+
+	clr	tempL
+	rcall EE_Read
+	mov	RxL,tempM
+	ldi	tempL,1
+	rcall EE_Read
+	mov	RxH,tempM
+	rcall Valid
+	brcc Init_N
+	ldi	RxL,low(N)  ; EEPROM  
+	ldi	RxH,high(N)
+Init_N:
+	mov	NL,RxL
+	mov	NH,RxH
+	rcall LMX_Load
+
+;       :
+
+	ldi	tempL,(1 << PCIE)
+	out	GIMSK,tempL
+	ldi	tempL,(1 << SE) ; idle
+	out	MCUCR,tempL
+
 ; :
 
 Main:
+	ldi	tempL,(1 << PCIF) ; ,    
+	out	GIFR,tempL        ; 
+	sei
+	sleep               ; 
+	cli
+	rcall Link_Receive
+	brcs Main           ; 
+	rcall Valid
+	brcs Main_Ans       ;    ()
+	mov	NL,RxL
+	mov	NH,RxH
+	rcall LMX_Load
+	rcall Link_Send     ;  ,
+	rcall EE_Save       ;  ( ~8 )
+	rjmp Main
+Main_Ans:
+	rcall Link_Send     ;  
+	rjmp Main
+
+;----------------------------------------------------------------------------
+
+;  RxH:RxL: tempH:tempM = NB, tempL = NA:
+
+Split:
+	mov	tempL,RxL
+	andi tempL,0x1F
+	mov	tempM,RxL
+	mov	tempH,RxH
+	ldi	Cnt,5
+Split_Sh:
+	lsr	tempH
+	ror	tempM
+	dec	Cnt
+	brne Split_Sh
+	ret
 
-;  N:
+;  RxH:RxL: NB = 3..1023, NA <= NB,
+;C = 1,   :
+
+Valid:
+	sbrc RxH,7      ;NB > 1023
+	rjmp Valid_Bad
+	rcall Split
+	tst	tempH       ;NB > 255: NB >= 3, NA <= NB
+	brne Valid_Ok
+	cpi	tempM,3
+	brlo Valid_Bad  ;NB < 3
+	cp	tempM,tempL
+	brlo Valid_Bad  ;NB < NA
+Valid_Ok:
+	clc
+	ret
+Valid_Bad:
+	sec
+	ret
 
-	ldi tempL,byte1(REG_N)
-	ldi tempM,byte2(REG_N)
-	ldi tempH,byte3(REG_N)
-	rcall SPI_Load
+;----------------------------------------------------------------------------
 
-;  R:
+;  LMX2324  NH:NL:
+
+LMX_Load:
+	mov	RxL,NL
+	mov	RxH,NH
+	rcall Split
+	lsl	tempL       ;NA << 3, N_ADDR = 0
+	lsl	tempL
+	lsl	tempL
+	rcall SPI_Load  ; N
 
 	ldi tempL,byte1(REG_R)
 	ldi tempM,byte2(REG_R)
 	ldi tempH,byte3(REG_R)
-	rcall SPI_Load
-
-	sleep
-	rjmp Main
+	rjmp SPI_Load   ; R
 
 ;----------------------------------------------------------------------------
 
@@ -141,3 +244,134 @@ dataX:
 	ret
 
 ;----------------------------------------------------------------------------
+
+;   RxH:RxL, C = 1  .
+; -       ,  
+;  ,    :
+;0 -  1T,  3T; 1 -  3T,  1T.
+; LINK_BITS   ,    .
+
+Link_Receive:
+	ldi	Cnt,LINK_BITS
+Rx_Bit:
+	clr	LoL
+	clr	LoH
+Rx_Lo:
+	sbic PINB,LINK  ; 
+	rjmp Rx_H
+	inc	LoL
+	brne Rx_Lo
+	inc	LoH
+	brne Rx_Lo
+	rjmp Rx_Err
+Rx_H:
+	clr	HiL
+	clr	HiH
+Rx_Hi:
+	sbis PINB,LINK  ; 
+	rjmp Rx_Val
+	inc	HiL
+	brne Rx_Hi
+	inc	HiH
+	brne Rx_Hi
+	rjmp Rx_Err
+Rx_Val:
+	cp	HiL,LoL     ;C = 1,   
+	cpc	HiH,LoH
+	rol	RxL
+	rol	RxH
+	dec	Cnt
+	brne Rx_Bit
+	clr	LoL
+	clr	LoH
+Rx_Stop:
+	sbic PINB,LINK  ; 
+	rjmp Rx_Ok
+	inc	LoL
+	brne Rx_Stop
+	inc	LoH
+	brne Rx_Stop
+Rx_Err:
+	sec
+	ret
+Rx_Ok:
+	clc
+	ret
+
+;  NH:NL    ,   LINK_T:
+
+Link_Send:
+	mov	RxL,NL
+	mov	RxH,NH
+	ldi	Cnt,LINK_BITS
+Tx_Bit:
+	cbi	PORTB,LINK  ; 
+	sbi	DDRB,LINK
+	rcall Delay_T
+	sbrs RxH,7
+	rjmp Tx_H
+	rcall Delay_T   ;1:  3T
+	rcall Delay_T
+Tx_H:
+	cbi	DDRB,LINK   ;  (pull-up)
+	sbi	PORTB,LINK
+	rcall Delay_T
+	sbrc RxH,7
+	rjmp Tx_Next
+	rcall Delay_T   ;0:  3T
+	rcall Delay_T
+Tx_Next:
+	lsl	RxL
+	rol	RxH
+	dec	Cnt
+	brne Tx_Bit
+	cbi	PORTB,LINK  ; 
+	sbi	DDRB,LINK
+	rcall Delay_T
+	cbi	DDRB,LINK
+	sbi	PORTB,LINK
+	ret
+
+;    LINK_T:
+
+Delay_T:
+	ldi	Dly,LINK_T
+Delay_L:
+	dec	Dly
+	brne Delay_L
+	ret
+
+;----------------------------------------------------------------------------
+
+;  NH:NL  EEPROM:
+
+EE_Save:
+	clr	tempL
+	mov	tempH,NL
+	rcall EE_Write
+	ldi	tempL,1
+	mov	tempH,NH
+
+;  tempH   tempL,   :
+
+EE_Write:
+	rcall EE_Read
+	cp	tempM,tempH
+	breq EE_Done
+	out	EEDR,tempH
+	sbi	EECR,EEMWE
+	sbi	EECR,EEWE
+EE_Done:
+	ret
+
+;    tempL  tempM:
+
+EE_Read:
+	sbic EECR,EEWE  ;  
+	rjmp EE_Read
+	out	EEAR,tempL
+	sbi	EECR,EERE
+	in	tempM,EEDR
+	ret
+
+;----------------------------------------------------------------------------
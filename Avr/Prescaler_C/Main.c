@@ -1,7 +1,7 @@
 //----------------------------------------------------------------------------
 
 //Project:         Prescaler (LMX2324)
-//Version:         V1.0
+//Version:         V1.2
 //Compiler:        IAR EWAVR 5.30
 //Microcontroller: ATtiny25
 //E-mail:          wubblick@yahoo.com
@@ -18,10 +18,11 @@
 
 #include <iotiny25.h>
 #include <intrinsics.h>
+#include <stdbool.h>
 
 //----------------------------------------------------------------------------
 
-#define N      256  //  
+#define N      256  //   
 
 //----------------------------------------------------------------------------
 
@@ -33,6 +34,8 @@
 #endif
 
 #define BITS    18  // 
+#define LINK_BITS 16 //   
+#define LINK_T  1000  //  , 
 
 //  R:
 
@@ -45,8 +48,8 @@
 
 //  N:
 
-#define NB_CNTR  NA //  NA (0..31, NA <= NB)
-#define NA_CNTR  NB //  NB (3..1023)
+//  NB (3..1023),  8
+//  NA (0..31, NA <= NB),  3
 #define CNT_RST  0  //  
 #define PWDN     0  // power down
 #define N_ADDR   0  //  N
@@ -56,13 +59,17 @@
 #define SDATA  (1 << PB0)
 #define LE     (1 << PB1)
 #define SCLK   (1 << PB2)
-#define NC     (1 << PB3)
-#define LED    (1 << PB4)
+#define NC     (1 << PB3) //CLKI,    
+#define LINK   (1 << PB4) //   ATmega8 ( )
+
+//PB4 (XTAL2)     .  LINK
+//   PB7 (XTAL2) ATmega8,   PB4
+// .
 
 //:
-#define I_DDRB  (SDATA | LE | SCLK | LED)
+#define I_DDRB  (SDATA | LE | SCLK)
 // /pull-ups:
-#define I_PORTB (SDATA | LE | SCLK | NC | LED)
+#define I_PORTB (SDATA | LE | SCLK | NC | LINK)
 //:
 #define Port_SDATA_0 (PORTB &= ~SDATA)
 #define Port_SDATA_1 (PORTB |= SDATA)
@@ -70,26 +77,91 @@
 #define Port_LE_1    (PORTB |= LE)
 #define Port_SCLK_0  (PORTB &= ~SCLK)
 #define Port_SCLK_1  (PORTB |= SCLK)
-#define Port_LED_0   (PORTB &= ~SCLOCK)
-#define Port_LED_1   (PORTB |= SCLOCK)
+#define Pin_LINK     (PINB & LINK)
+#define Port_LINK_0  (PORTB &= ~LINK, DDRB |= LINK)
+#define Port_LINK_1  (DDRB &= ~LINK, PORTB |= LINK)
+
+//------------------------------ : ---------------------------------
+
+__no_init __eeprom int EN; //   EEPROM
 
 //--------------------------  : ------------------------------
 
 void main(void);
+bool Valid(int n);
+void LMX_Load(int n);
+int  Link_Receive(void);
+void Link_Send(int n);
 void SPI_Load(long n);
 
+#pragma vector = PCINT0_vect
+__interrupt void Link_Int(void);
+
 //-------------------------  : ------------------------------
 
 void main(void)
 {
   DDRB  = I_DDRB;
   PORTB = I_PORTB;
+  int n = EN;
+  if(!Valid(n)) n = N;      // EEPROM  
+  LMX_Load(n);
+  //       :
+  PCMSK = (1 << PCINT4);
+  GIMSK = (1 << PCIE);
+  MCUCR = (1 << SE);        // idle
+  __enable_interrupt();
+  while(1)
+  {
+    __sleep();              // 
+    __disable_interrupt();
+    int r = Link_Receive();
+    if(r != -1)
+    {
+      bool w = 0;
+      if(Valid(r))          //   
+      {
+        n = r;
+        LMX_Load(n);
+        w = EN != n;
+      }
+      Link_Send(n);         //  ,
+      if(w) EN = n;         //  ( ~8.5 )
+    }
+    GIFR = (1 << PCIF);     // ,    
+    __enable_interrupt();
+  }
+}
+
+//--------------      : ---------------------
+
+#pragma vector = PCINT0_vect
+__interrupt void Link_Int(void)
+{
+  //   
+}
+
+//--------------    : -----------------
+
+bool Valid(int n)
+{
+  int nb = n / PRE;
+  int na = n - nb * PRE;
+  return(n > 0 && nb >= 3 && nb <= 1023 && na <= nb);
+}
+
+//------------------------   LMX2324: -----------------------
+
+void LMX_Load(int n)
+{
+  long nb = n / PRE;
+  long na = n - nb * PRE;
   //  N:
-  SPI_Load((NB_CNTR <<  8) |
-           (NA_CNTR <<  3) |
-           (CNT_RST <<  2) |
-              (PWDN <<  1) |
-            (N_ADDR <<  0));
+  SPI_Load((nb << 8) |
+           (na << 3) |
+           (CNT_RST << 2) |
+              (PWDN << 1) |
+            (N_ADDR << 0));
   //  R:
   SPI_Load(   (TEST << 14) |
                 (RS << 13) |
@@ -97,7 +169,51 @@ void main(void)
             (CP_TRI << 11) |
             (R_CNTR <<  1) |
             (R_ADDR <<  0));
-  __sleep();
+}
+
+//-------------------------    : -------------------------
+
+// -       ,  
+//  ,    :
+//0 -  1T,  3T; 1 -  3T,  1T.
+// LINK_BITS   ,    .
+//    -1  .
+
+int Link_Receive(void)
+{
+  unsigned int n = 0;
+  for(char i = 0; i < LINK_BITS; i++)
+  {
+    unsigned int lo = 0, hi = 0;
+    while(!Pin_LINK) if(!++lo) return(-1); // 
+    while(Pin_LINK) if(!++hi) return(-1);  // 
+    n = (n << 1) | (lo > hi);
+  }
+  unsigned int t = 0;
+  while(!Pin_LINK) if(!++t) return(-1);    // 
+  return(n);
+}
+
+//---------------------------   : ------------------------------
+
+//    ,   LINK_T .
+
+void Link_Send(int n)
+{
+  for(char i = 0; i < LINK_BITS; i++)
+  {
+    bool b = n & (1 << (LINK_BITS - 1));
+    Port_LINK_0;
+    __delay_cycles(LINK_T);
+    if(b) __delay_cycles(2 * LINK_T);
+    Port_LINK_1;
+    __delay_cycles(LINK_T);
+    if(!b) __delay_cycles(2 * LINK_T);
+    n = n << 1;
+  }
+  Port_LINK_0;              // 
+  __delay_cycles(LINK_T);
+  Port_LINK_1;
 }
 
 //------------------   BITS   SPI: ---------------------
@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: Allan, modified Allan, Hadamard and time deviations
+
+//----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "Adev.h"
+
+//------------------------------- Sums: --------------------------------------
+
+//Inner loops have no dependencies but the sum, they are vectorized
+//(-fopenmp-simd, see Makefile).
+
+static double SumA(const double *x, size_t n, size_t m)
+{
+  double s = 0;
+  #pragma omp simd reduction(+:s)
+  for(size_t i = 0; i < n; i++)
+  {
+    double d = x[i + 2 * m] - 2 * x[i + m] + x[i];
+    s += d * d;
+  }
+  return(s);
+}
+
+//HDEV: third differences of phase, MDEV: of prefix sums
+
+static double SumH(const double *x, size_t n, size_t m)
+{
+  double s = 0;
+  #pragma omp simd reduction(+:s)
+  for(size_t i = 0; i < n; i++)
+  {
+    double d = x[i + 3 * m] - 3 * x[i + 2 * m] + 3 * x[i + m] - x[i];
+    s += d * d;
+  }
+  return(s);
+}
+
+//------------------------------- Tau: ---------------------------------------
+
+AdevPoint Adev_Tau(const double *x, const double *s, size_t n, double tau0, uint64_t m)
+{
+  AdevPoint p = {};
+  p.M = m;
+  p.Tau = m * tau0;
+  double t2 = p.Tau * p.Tau;
+  p.Adev = sqrt(SumA(x, n - 2 * m, m) / (2 * t2 * (n - 2 * m)));
+  p.Hdev = sqrt(SumH(x, n - 3 * m, m) / (6 * t2 * (n - 3 * m)));
+  p.Mdev = sqrt(SumH(s, n - 3 * m + 1, m) / (2 * t2 * m * m * (n - 3 * m + 1)));
+  p.Tdev = p.Tau / sqrt(3.0) * p.Mdev;
+  p.Terms = n - 3 * m;
+  return(p);
+}
+
+//------------------------------ Series: -------------------------------------
+
+std::vector<AdevPoint> Adev_Phase(const double *x, size_t n, double tau0, int threads)
+{
+  std::vector<AdevPoint> r;
+  for(uint64_t m = 1; 3 * m < n; m *= 2) r.push_back({m, 0, 0, 0, 0, 0, 0});
+  if(r.empty()) return(r);
+
+  //prefix sums, phase offset removed first to keep them small:
+  std::vector<double> s(n + 1);
+  double x0 = x[0];
+  s[0] = 0;
+  for(size_t i = 0; i < n; i++) s[i + 1] = s[i] + (x[i] - x0);
+
+  //taus to threads, largest first:
+  if(threads <= 0) threads = std::thread::hardware_concurrency();
+  if(threads > (int)r.size()) threads = r.size();
+  if(threads < 1) threads = 1;
+  std::atomic<size_t> next(0);
+  auto work = [&]
+  {
+    for(size_t k; (k = next++) < r.size();)
+    {
+      size_t j = r.size() - 1 - k;
+      r[j] = Adev_Tau(x, s.data(), n, tau0, r[j].M);
+    }
+  };
+  std::vector<std::thread> t;
+  for(int i = 1; i < threads; i++) t.emplace_back(work);
+  work();
+  for(auto &i : t) i.join();
+  return(r);
+}
+
+//phase of mean-removed frequency, so phase and its sums stay small
+
+std::vector<AdevPoint> Adev_Freq(const double *y, size_t n, double tau0, int threads)
+{
+  double mean = 0;
+  for(size_t i = 0; i < n; i++) mean += y[i];
+  if(n) mean /= n;
+  std::vector<double> x(n + 1);
+  x[0] = 0;
+  for(size_t i = 0; i < n; i++) x[i + 1] = x[i] + (y[i] - mean) * tau0;
+  return(Adev_Phase(x.data(), n + 1, tau0, threads));
+}
+
+//----------------------------------------------------------------------------
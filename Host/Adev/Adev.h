@@ -0,0 +1,53 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: Allan, modified Allan, Hadamard and time deviations, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef AdevH
+#define AdevH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//------------------------------- Point: -------------------------------------
+
+//Overlapping estimators at tau = m * tau0 (NIST SP 1065), phase
+//data x of M points:
+//ADEV^2 = 1 / (2 tau^2 (M - 2m)) * sum (x[i+2m] - 2x[i+m] + x[i])^2
+//MDEV^2 = 1 / (2 m^2 tau^2 (M - 3m + 1)) *
+//         sum_j (sum_{i=j}^{j+m-1} (x[i+2m] - 2x[i+m] + x[i]))^2
+//HDEV^2 = 1 / (6 tau^2 (M - 3m)) *
+//         sum (x[i+3m] - 3x[i+2m] + 3x[i+m] - x[i])^2
+//TDEV   = tau / sqrt(3) * MDEV
+
+struct AdevPoint
+{
+  uint64_t M;                        //averaging factor
+  double Tau;                        //tau, s
+  double Adev;                       //overlapping Allan deviation
+  double Mdev;                       //modified Allan deviation
+  double Hdev;                       //overlapping Hadamard deviation
+  double Tdev;                       //time deviation, s
+  uint64_t Terms;                    //terms of HDEV sum, the fewest
+};
+
+//------------------------------ Functions: ----------------------------------
+
+//Phase x (s) and its prefix sums are made once, then each tau takes
+//O(N) with no inner loop over m: MDEV inner sums are differences of
+//prefix sums. Taus are shared out to threads (0 - all cores).
+//Taus are octaves m = 1, 2, 4, ... while 3m < M.
+
+//fractional frequency data y, tau0 - sample interval, s
+std::vector<AdevPoint> Adev_Freq(const double *y, size_t n, double tau0, int threads = 0);
+//phase data x, s
+std::vector<AdevPoint> Adev_Phase(const double *x, size_t n, double tau0, int threads = 0);
+//one tau of phase data x and its prefix sums s (n + 1 values)
+AdevPoint Adev_Tau(const double *x, const double *s, size_t n, double tau0, uint64_t m);
+
+//----------------------------------------------------------------------------
+
+#endif
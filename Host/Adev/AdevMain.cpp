@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: Allan deviations of columnar result file
+
+//Usage: Adev [-m mode] [-g tau0] [-f s] [-t s] [-j threads] file.col
+//-m mode     result mode (Count.h), default - mode of first row
+//-g tau0     sample interval, s, default - median of capture times
+//-f s, -t s  time window, seconds from first row
+//-j threads  threads, default - all cores
+//Results are taken as fractional frequency to their mean (period
+//results give the same deviations). Gaps are joined, their count
+//is written to stderr.
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "Adev.h"
+#include "../Col/Col.h"
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  int mode = -1, threads = 0;
+  double tau0 = 0, f = 0, t = 0;
+  bool win0 = 0, win1 = 0;
+  int o;
+  while((o = getopt(argc, argv, "m:g:f:t:j:")) != -1)
+  {
+    switch(o)
+    {
+    case 'm': mode = atoi(optarg); break;
+    case 'g': tau0 = atof(optarg); break;
+    case 'f': f = atof(optarg); win0 = 1; break;
+    case 't': t = atof(optarg); win1 = 1; break;
+    case 'j': threads = atoi(optarg); break;
+    default:
+      fprintf(stderr, "Usage: Adev [-m mode] [-g tau0] [-f s] [-t s] [-j threads] file.col\n");
+      return(2);
+    }
+  }
+  if(optind != argc - 1) { fprintf(stderr, "Adev: no file\n"); return(2); }
+  ColReader r;
+  if(!r.Open(argv[optind])) { fprintf(stderr, "Adev: bad file %s\n", argv[optind]); return(1); }
+
+  //values and times of mode, column by column:
+  int64_t t0 = win0? r.First() + (int64_t)(f * 1E9) : INT64_MIN;
+  int64_t t1 = win1? r.First() + (int64_t)(t * 1E9) : INT64_MAX;
+  uint64_t a = r.Find(t0), e = r.Find(t1);
+  std::vector<double> y;
+  std::vector<int64_t> tm;
+  for(size_t b = 0; b < r.Blocks(); b++)
+  {
+    const ColIndex &x = r.Index(b);
+    if(x.Row + x.Rows <= a) continue;
+    if(x.Row >= e) break;
+    ColReader::Block c = r.Get(b);
+    for(size_t k = a > x.Row? a - x.Row : 0; k < c.Rows && x.Row + k < e; k++)
+    {
+      if(mode < 0) mode = c.Mode[k];
+      if(c.Mode[k] != mode) continue;
+      ColRow v = {};
+      v.Mant = c.Mant[k];
+      v.Dec = c.Dec[k];
+      y.push_back(v.Value());
+      tm.push_back(c.Time[k]);
+    }
+  }
+  if(y.size() < 4) { fprintf(stderr, "Adev: too few results\n"); return(1); }
+
+  if(tau0 <= 0)
+  {
+    std::vector<int64_t> d(tm.size() - 1);
+    for(size_t i = 0; i < d.size(); i++) d[i] = tm[i + 1] - tm[i];
+    std::nth_element(d.begin(), d.begin() + d.size() / 2, d.end());
+    tau0 = (double)d[d.size() / 2] / 1E9;
+    tau0 = std::max(1, (int)(tau0 * 1000 + 0.5)) / 1000.0; //gate is whole ms
+  }
+  size_t gaps = 0;
+  for(size_t i = 1; i < tm.size(); i++)
+    if((tm[i] - tm[i - 1]) / 1E9 > 1.5 * tau0) gaps++;
+  double mean = 0;
+  for(double v : y) mean += v;
+  mean /= y.size();
+  if(mean == 0) { fprintf(stderr, "Adev: zero mean\n"); return(1); }
+  for(double &v : y) v = v / mean - 1;
+  fprintf(stderr, "mode %d, %zu results, tau0 %g s, %zu gaps\n", mode, y.size(), tau0, gaps);
+
+  printf("#tau m adev mdev hdev tdev terms\n");
+  for(auto &p : Adev_Freq(y.data(), y.size(), tau0, threads))
+    printf("%g %llu %.6e %.6e %.6e %.6e %llu\n", p.Tau, (unsigned long long)p.M,
+           p.Adev, p.Mdev, p.Hdev, p.Tdev, (unsigned long long)p.Terms);
+  return(0);
+}
+
+//----------------------------------------------------------------------------
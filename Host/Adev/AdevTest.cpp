@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of Allan deviations
+
+//White FM noise results are checked against direct sums over
+//averaged frequency (NIST SP 1065, no phase, no prefix sums) for all
+//taus, and against the known white FM slope. Then a long series is
+//timed.
+
+//Usage: AdevTest [-n points of timed series] [-j threads]
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unistd.h>
+#include "Adev.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define N_CHECK 5000                 //points checked by direct sums
+#define N_TIME  10000000             //default points of timed series
+#define SIGMA   1E-9                 //white FM noise, fractional
+#define TOL     1E-7                 //relative tolerance to direct sums
+
+//------------------------------ Variables: ----------------------------------
+
+static int Fails;
+
+//------------------------------- Check: -------------------------------------
+
+static void Check(bool c, const char *what)
+{
+  if(c) return;
+  printf("FAILED: %s\n", what);
+  Fails++;
+}
+
+static bool Near(double a, double b)
+{
+  return(fabs(a - b) <= TOL * fabs(b));
+}
+
+//---------------------------- Direct sums: ----------------------------------
+
+//mean of y[k .. k+m-1]
+
+static long double Avg(const std::vector<double> &y, size_t k, size_t m)
+{
+  long double s = 0;
+  for(size_t i = 0; i < m; i++) s += y[k + i];
+  return(s / m);
+}
+
+static double Adev(const std::vector<double> &y, size_t m)
+{
+  size_t n = y.size(), t = n - 2 * m + 1;
+  long double s = 0;
+  for(size_t k = 0; k < t; k++)
+  {
+    long double d = Avg(y, k + m, m) - Avg(y, k, m);
+    s += d * d;
+  }
+  return(sqrtl(s / (2 * t)));
+}
+
+static double Hdev(const std::vector<double> &y, size_t m)
+{
+  size_t n = y.size(), t = n - 3 * m + 1;
+  long double s = 0;
+  for(size_t k = 0; k < t; k++)
+  {
+    long double d = Avg(y, k + 2 * m, m) - 2 * Avg(y, k + m, m) + Avg(y, k, m);
+    s += d * d;
+  }
+  return(sqrtl(s / (6 * t)));
+}
+
+//MDEV: mean of m consecutive ADEV differences
+
+static double Mdev(const std::vector<double> &y, size_t m)
+{
+  size_t n = y.size(), t = n - 3 * m + 2;
+  std::vector<long double> d(n - 2 * m + 1);
+  for(size_t k = 0; k < d.size(); k++) d[k] = Avg(y, k + m, m) - Avg(y, k, m);
+  long double s = 0;
+  for(size_t j = 0; j < t; j++)
+  {
+    long double a = 0;
+    for(size_t i = 0; i < m; i++) a += d[j + i];
+    a /= m;
+    s += a * a;
+  }
+  return(sqrtl(s / (2 * t)));
+}
+
+//------------------------------- Tests: -------------------------------------
+
+//white FM, fractional frequency
+
+static std::vector<double> Noise(size_t n, std::mt19937_64 &g)
+{
+  std::normal_distribution<double> w(0, SIGMA);
+  std::vector<double> y(n);
+  for(auto &v : y) v = w(g);
+  return(y);
+}
+
+static void TestDirect(int threads)
+{
+  std::mt19937_64 g(510);
+  std::vector<double> y = Noise(N_CHECK, g);
+  double tau0 = 0.1;
+  std::vector<AdevPoint> r = Adev_Freq(y.data(), y.size(), tau0, threads);
+  Check(r.size() == 11 && r.back().M == 1024, "taus");
+  for(auto &p : r)
+  {
+    char s[64];
+    snprintf(s, sizeof(s), "m = %llu", (unsigned long long)p.M);
+    Check(Near(p.Adev, Adev(y, p.M)), s);
+    Check(Near(p.Mdev, Mdev(y, p.M)), s);
+    Check(Near(p.Hdev, Hdev(y, p.M)), s);
+    Check(Near(p.Tdev, p.Tau / sqrt(3.0) * p.Mdev) && p.Tau == p.M * tau0, s);
+  }
+  //white FM: ADEV = sigma / sqrt(m), MDEV = ADEV / sqrt(2) at large m
+  Check(fabs(r[0].Adev / SIGMA - 1) < 0.05 && fabs(r[4].Adev * 4 / SIGMA - 1) < 0.1, "white FM");
+  Check(fabs(r[4].Mdev * sqrt(2.0) / r[4].Adev - 1) < 0.15, "white FM MDEV");
+}
+
+static void TestTime(size_t n, int threads)
+{
+  std::mt19937_64 g(1);
+  std::vector<double> y = Noise(n, g);
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<AdevPoint> r = Adev_Freq(y.data(), y.size(), 1.0, threads);
+  double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  Check(!r.empty() && fabs(r[0].Adev / SIGMA - 1) < 0.01, "long series");
+  printf("%zu points, %zu taus: %.3f s\n", n, r.size(), dt);
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  size_t n = N_TIME;
+  int threads = 0;
+  int o;
+  while((o = getopt(argc, argv, "n:j:")) != -1)
+  {
+    if(o == 'n') n = strtoull(optarg, nullptr, 10);
+    else if(o == 'j') threads = atoi(optarg);
+    else { fprintf(stderr, "Usage: AdevTest [-n points] [-j threads]\n"); return(2); }
+  }
+  TestDirect(threads);
+  TestTime(n, threads);
+  printf(Fails? "FAILED\n" : "PASSED\n");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
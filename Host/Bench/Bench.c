@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//firmware hot path benchmark: ATmega8 program for simavr (avr-gcc)
+
+//Built once per BENCH_xxx of Main.h (-DBENCH=n) with Bench/Hal headers.
+//Count.c is included to preset its counters, the other modules are
+//linked as they are. The selected path is called with fixed arguments,
+//BenchRun times the PROBE pulse of each call. The first pulse is empty,
+//its width is the probe overhead. Pulses are in BENCH_LABELS order of
+//the Makefile. The program ends by sleep with interrupts off.
+
+//----------------------------------------------------------------------------
+
+#include "Count.c"
+#include "Disp.h"
+#include "Keyboard.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define B_FREF  128000000  //reference, x0.1 Hz
+#define B_GATE  1000       //gate, ms
+#define B_MX    12800123LL //reference pulses, 1 s gate
+#define B_NX    1234567LL  //input pulses, 1.234567 MHz
+#define B_IX    37         //interpolator count
+#define B_CAL   1280       //calibration sum
+#define B_VAL   12345678901234LL //averaged result, 1E-9 units
+
+//------------------------- Function prototypes: -----------------------------
+
+void Long2BCD(unsigned long x, char *buff); //Disp.c
+
+//------------------------------ Variables: ----------------------------------
+
+volatile long Sink;  //results are kept
+
+//------------------------------ Main: ---------------------------------------
+
+int main(void)
+{
+  DDRB  = I_DDRB;                     //as Main_Ports_Init()
+  PORTB = I_PORTB;
+  DDRC  = I_DDRC;
+  PORTC = I_PORTC;
+  DDRD  = I_DDRD;
+  PORTD = I_PORTD;
+  Bench_Start(BENCH);                 //probe overhead
+  Bench_Stop(BENCH);
+
+  Count_Init();
+  Count_SetFref(B_FREF);
+  Count_SetGate(B_GATE);
+  Count_SetAvg(1);
+  Count_SetInt(1);
+  Count_SetPre(1, 0);
+  Count_SetScale(1);
+  Cal = B_CAL;
+
+#if BENCH == BENCH_MAKE
+  for(char m = 0; m < MODES; m++)     //make.<mode>, Count.h order
+  {
+    Count_SetMode(m);
+    Count_Mx = B_MX;
+    Count_Nx = B_NX;
+    Count_Ix = B_IX;
+    Count_Make();
+  }
+#elif BENCH == BENCH_VALUE
+  ResVal = B_VAL;                     //value.s1, value.s8, value.neg
+  Count_SetScale(1);
+  Sink = Count_GetValue();
+  Count_SetScale(MAX_SCALE);
+  Sink = Count_GetValue();
+  ResVal = -B_VAL;
+  Sink = Count_GetValue();
+#elif BENCH == BENCH_BCD
+  char b[10];                         //bcd.0, bcd.max
+  Long2BCD(0, b);
+  Long2BCD(0xFFFFFFFF, b);
+  Sink = b[0];
+#elif BENCH == BENCH_VAL
+  Disp_Val(1, 0, 1999999999);         //val.max, val.neg
+  Disp_Val(1, 5, -123456);
+#elif BENCH == BENCH_UPDATE
+  Disp_Update();                      //update
+#elif BENCH == BENCH_CPLD
+  Sink = Get_CPLD();                  //cpld
+#elif BENCH == BENCH_CALIB
+  Sink = Count_Calib();               //calib
+#elif BENCH == BENCH_SCAN
+  Sink = Keyboard_Scan();             //scan
+#endif
+
+  __disable_interrupt();              //simavr stops here
+  MCUCR |= 1 << SE;
+  __asm__ __volatile__("sleep");
+  return(0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: hot path cycle counter, runs Bench.c program under simavr
+
+//PROBE (PC1) pulses are timed in CPU cycles. The first pulse is the
+//probe overhead, it is taken from the others, which get the labels
+//in order: one "label cycles" line each. Exit code is 1 if the pulse
+//count is not the label count or the program does not end in time.
+
+//Usage: BenchRun elf label...
+
+//----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/avr_ioport.h>
+
+//----------------------------- Constants: -----------------------------------
+
+#define MCU       "atmega8"
+#define F_CPU     8000000     //MCU clock, Hz
+#define PROBE_PORT 'C'        //PROBE pin of Main.h in BENCH build
+#define PROBE_BIT 1
+#define PULSES    64          //max pulses
+#define CYCLES    100000000   //max run time, cycles
+
+//------------------------------ Variables: ----------------------------------
+
+static uint64_t Rise;         //last rising edge cycle
+static uint64_t Width[PULSES];
+static int Pulses;
+
+//------------------------------ Probe pin: ----------------------------------
+
+static void Probe(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+  avr_t *avr = param;
+  (void)irq;
+  if(value) Rise = avr->cycle;
+    else if(Pulses < PULSES) Width[Pulses++] = avr->cycle - Rise;
+}
+
+//------------------------------- Main: --------------------------------------
+
+int main(int argc, char *argv[])
+{
+  if(argc < 3)
+  {
+    fprintf(stderr, "Usage: BenchRun elf label...\n");
+    return(1);
+  }
+  elf_firmware_t f = {0};
+  if(elf_read_firmware(argv[1], &f))
+  {
+    fprintf(stderr, "BenchRun: cannot read %s\n", argv[1]);
+    return(1);
+  }
+  avr_t *avr = avr_make_mcu_by_name(MCU);
+  if(!avr) { fprintf(stderr, "BenchRun: no %s in simavr\n", MCU); return(1); }
+  avr_init(avr);
+  avr->frequency = F_CPU;
+  avr_load_firmware(avr, &f);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(PROBE_PORT), PROBE_BIT),
+                          Probe, avr);
+
+  int st = cpu_Running;
+  while(st != cpu_Done && st != cpu_Crashed && avr->cycle < CYCLES)
+    st = avr_run(avr);
+  if(st != cpu_Done)
+  {
+    fprintf(stderr, "BenchRun: %s %s\n", argv[1], st == cpu_Crashed? "crashed" : "did not end");
+    return(1);
+  }
+  int n = argc - 2;
+  if(Pulses != n + 1)
+  {
+    fprintf(stderr, "BenchRun: %s: %d pulses, %d labels + overhead\n", argv[1], Pulses, n);
+    return(1);
+  }
+  for(int i = 0; i < n; i++)
+    printf("%-12s %llu\n", argv[i + 2], (unsigned long long)(Width[i + 1] - Width[0]));
+  return(0);
+}
+
+//----------------------------------------------------------------------------
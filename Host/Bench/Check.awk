@@ -0,0 +1,35 @@
+#-----------------------------------------------------------------------------
+
+#Frequency Counter FC-510
+#host: hot path cycles against the baseline
+
+#Usage: awk -v tol=2 -f Check.awk Cycles.txt Bench.txt
+#Prints baseline, measured cycles and change for each label. Fails
+#when a path takes over tol percent more cycles than its baseline or
+#a baseline label is not measured. "-" baseline is reported only.
+
+#-----------------------------------------------------------------------------
+
+/^#/ || NF < 2 { next }
+
+FNR == NR { Base[$1] = $2; Order[++N] = $1; next }
+
+{ Now[$1] = $2; if(!($1 in Base)) New[++M] = $1 }
+
+END {
+  printf "%-12s %10s %10s %8s\n", "path", "baseline", "cycles", "change"
+  for(i = 1; i <= N; i++)
+  {
+    l = Order[i]
+    if(!(l in Now)) { printf "%-12s %10s %10s  missing\n", l, Base[l], "-"; Bad++; continue }
+    if(Base[l] == "-") { printf "%-12s %10s %10d\n", l, "-", Now[l]; continue }
+    d = (Now[l] - Base[l]) * 100.0 / Base[l]
+    over = d > tol
+    printf "%-12s %10d %10d %+7.1f%%%s\n", l, Base[l], Now[l], d, over? "  over" : ""
+    Bad += over
+  }
+  for(i = 1; i <= M; i++) printf "%-12s %10s %10d  new\n", New[i], "-", Now[New[i]]
+  if(Bad) { print "Check.awk: " Bad " path(s) missing or over baseline + " tol "%" > "/dev/stderr"; exit 1 }
+}
+
+#-----------------------------------------------------------------------------
@@ -0,0 +1,24 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//bench HAL: IAR EWAVR intrinsic functions for avr-gcc
+
+//----------------------------------------------------------------------------
+
+#ifndef INTRINSICS_H
+#define INTRINSICS_H
+
+#include <avr/interrupt.h>
+
+//----------------------------- Intrinsics: ----------------------------------
+
+#define __delay_cycles(c)       __builtin_avr_delay_cycles(c)
+#define __enable_interrupt()    sei()
+#define __disable_interrupt()   cli()
+#define __watchdog_reset()      __asm__ __volatile__("wdr")
+#define __no_operation()        __asm__ __volatile__("nop")
+#define __swap_nibbles(c)       __builtin_avr_swap(c)
+
+//----------------------------------------------------------------------------
+
+#endif
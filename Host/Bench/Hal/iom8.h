@@ -0,0 +1,32 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//bench HAL: ATmega8 I/O registers and IAR keywords for avr-gcc
+
+//Firmware sources are compiled as C (gnu99) by avr-gcc with this
+//directory first in the include path. __flash objects are const in
+//IAR, avr-gcc needs the qualifier; duplicate const is allowed in C99.
+//EEPROM variables are plain RAM: benchmarks never read them back.
+
+//----------------------------------------------------------------------------
+
+#ifndef IOM8_H
+#define IOM8_H
+
+#include <avr/io.h>
+
+//----------------------------- IAR keywords: --------------------------------
+
+#define __flash     const __flash
+#define __eeprom
+#define __no_init   __attribute__((section(".noinit")))
+#define __monitor
+#define __interrupt
+
+#ifndef ADCSR
+  #define ADCSR ADCSRA
+#endif
+
+//----------------------------------------------------------------------------
+
+#endif
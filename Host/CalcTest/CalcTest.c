@@ -0,0 +1,428 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of result calculation module (Iar_C/Calc.c)
+
+//Calc.c is compiled as is, Calc_Result is checked against
+//128 bit reference on golden vectors and randomized tuples,
+//max error is reported in counts (uHz or ps), then
+//calculation throughput is measured
+
+//Usage: CalcTest [-n tuples] [-s seed] [-b bench tuples]
+
+//----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Calc.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define NCAL      10          //calibration cycles (2 * N_CALIB)
+#define FREF_NOM  128000000   //nominal reference, x0.1 Hz
+#define FREF_MIN  10000000    //PAR_RF limits
+#define FREF_MAX  999999999
+#define PRE_MAX   32767       //PAR_PRE max
+#define FCNT_MAX  100E6       //max counted frequency, Hz
+#define FIN_MAX   2.5E9       //max input frequency, Hz
+#define T_MIN     1E-3        //PAR_GATE limits, s
+#define T_MAX     1000.0
+#define T_SHORT   10.0        //short gate limit, s
+#define CNT_MAX   0xFFFFFFFFFFLL //40 bit counters
+#define LL_MAX    0x7FFFFFFFFFFFFFFFLL
+#define N_TUPLES  2000000     //default randomized tuples
+#define N_BENCH   1000000     //default benchmark tuples
+
+//------------------------------ Types: --------------------------------------
+
+typedef __int128 i128;
+
+typedef struct
+{
+  long long mx;               //reference pulses
+  long long nx;               //input pulses
+  int ix;                     //interpolator count
+  int cal;                    //calibration sum
+  long fref;                  //reference, x0.1 Hz
+  int pre;                    //prescaler ratio
+  bool per;                   //period flag
+} Tuple;
+
+typedef struct
+{
+  long long n;                //checked tuples
+  long long bad;              //tuples with error
+  long long err;              //max error, counts
+  Tuple worst;                //tuple with max error
+  double rel;                 //max relative error vs exact value
+} Stat;
+
+//------------------------------ Variables: ----------------------------------
+
+static uint64_t Seed = 1;     //random generator state
+
+//------------------------------ Golden vectors: -----------------------------
+
+//expected values were calculated with exact rational arithmetic,
+//interpolator term as in firmware (truncated to 1/100 of Fref period)
+
+typedef struct
+{
+  Tuple t;
+  long long res;
+  const char *name;
+} Golden;
+
+static const Golden Gold[] =
+{
+  {{ 10000000, 10000000, 0, 0, 100000000, 1, 0 },
+    10000000000000, "10 MHz, 1 s, F" },
+  {{ 10000000, 10000000, 0, 0, 100000000, 1, 1 },
+    100000, "10 MHz, 1 s, P" },
+  {{ 12800000017, 10000000000, 0, 0, FREF_NOM, 1, 0 },
+    9999999986718, "10 MHz, 1000 s, F" },
+  {{ 12800000017, 10000000000, 0, 0, FREF_NOM, 1, 1 },
+    100000, "10 MHz, 1000 s, P" },
+  {{ 128000003, 1000000, 37, -1000, FREF_NOM, 1, 0 },
+    99999997367, "100 kHz, interpolator, F" },
+  {{ 128000003, 1000000, -52, -1010, FREF_NOM, 1, 1 },
+    10000000, "100 kHz, interpolator, P" },
+  {{ 12799999, 100000, 0, 0, FREF_NOM, 1000, 0 },
+    100000007812500, "100 MHz with prescaler 1000" },
+  {{ 25600000000, 2000000, 91, -1270, FREF_NOM, 1000, 0 },
+    999999999972, "1 GHz, 1000 s, big path" },
+  {{ 25600000000, 3, 0, 0, FREF_NOM, 1, 1 },
+    666666666666666, "3 mHz, P" },
+  {{ 1280000, 1, 0, 0, FREF_NOM, 1, 1 },
+    100000000000, "10 Hz, 1 period, P" },
+  {{ 127999, 1, 5, -990, FREF_MAX, PRE_MAX, 0 },
+    25599408720012, "Fref max, prescaler max" },
+  {{ 100000000000, 100000000000, 0, 0, FREF_MAX, 1, 0 },
+    99999999900000, "100 MHz, 1000 s, Fref max" },
+};
+
+#define GOLDS (sizeof(Gold) / sizeof(Gold[0]))
+
+//------------------------- Function prototypes: -----------------------------
+
+uint64_t Rnd(void);                         //random 64 bit value
+double RndU(void);                          //random 0..1
+double RndLog(double a, double b);          //log-uniform a..b
+long long Ref(const Tuple *t, bool exact);  //reference result
+long long Run(const Tuple *t);              //production result
+void RndTuple(Tuple *t);                    //physical random tuple
+void EdgeTuple(Tuple *t);                   //edge random tuple
+bool Valid(const Tuple *t);                 //result fits 64 bits
+void Check(Stat *s, const Tuple *t);        //check one tuple
+void PrintTuple(const Tuple *t);            //print tuple
+double Bench(Tuple *t, long n);             //calculations per second
+
+//---------------------------- Random values: --------------------------------
+
+//xorshift64*, repeatable for the seed
+
+uint64_t Rnd(void)
+{
+  Seed ^= Seed >> 12;
+  Seed ^= Seed << 25;
+  Seed ^= Seed >> 27;
+  return(Seed * 0x2545F4914F6CDD1DULL);
+}
+
+double RndU(void)
+{
+  return((Rnd() >> 11) * (1.0 / 9007199254740992.0));
+}
+
+double RndLog(double a, double b)
+{
+  return(a * __builtin_exp(RndU() * __builtin_log(b / a)));
+}
+
+//--------------------------- Reference result: ------------------------------
+
+//exact = 0: total reference count Mx as in firmware
+//(interpolator term truncated), result is floor of exact quotient,
+//exact = 1: interpolator term is not truncated
+
+long long Ref(const Tuple *t, bool exact)
+{
+  i128 np = (i128)t->nx * t->pre;
+  i128 c = t->cal? -t->cal : 1;
+  i128 mx = (i128)t->mx * 100;      //Mx * c
+  if(t->cal)
+  {
+    if(exact) mx = mx * c + (i128)t->ix * 100 * NCAL;
+      else mx = (mx + (i128)t->ix * 100 * NCAL / c) * c;
+  }
+  else c = 1;
+  i128 r = 0;
+  if(t->per)
+  {
+    i128 d = np * t->fref * c;
+    if(d) r = mx * 100000000000LL / d;
+  }
+  else
+  {
+    if(mx) r = np * t->fref * 10000000 * c / mx;
+  }
+  if(r > LL_MAX) r = LL_MAX;
+  return((long long)r);
+}
+
+//-------------------------- Production result: ------------------------------
+
+long long Run(const Tuple *t)
+{
+  return(Calc_Result(t->mx, t->nx, t->ix, t->cal, NCAL,
+                     t->fref, t->pre, t->per));
+}
+
+//------------------------ Physical random tuple: ----------------------------
+
+//counts of a real gate: input frequency, prescaler, gate time
+//and reference as set by PAR_* limits, gate ends on input edge
+
+void RndTuple(Tuple *t)
+{
+  t->fref = (Rnd() & 1)? FREF_NOM + (long)(Rnd() % 2001) - 1000 :
+    FREF_MIN + (long)(Rnd() % (FREF_MAX - FREF_MIN + 1));
+  t->pre = (Rnd() & 1)? 1 : 1 + (int)(Rnd() % PRE_MAX);
+  double fin = RndLog(0.1, FIN_MAX);
+  double f = fin / t->pre;                   //counted frequency
+  if(f > FCNT_MAX) f = FCNT_MAX;
+  if(f < 0.01) f = 0.01;
+  double tg = RndLog(T_MIN, T_MAX);
+  long long n = (long long)(f * tg + 0.5);
+  if(n < 1) n = 1;
+  t->nx = n;
+  double m = n / f * (t->fref / 10.0);       //reference pulses
+  t->mx = (long long)m;
+  if(t->mx < 1) t->mx = 1;
+  t->per = Rnd() & 1;
+  if(Rnd() % 4)
+  {
+    int d = 20 + (int)(Rnd() % 108);         //one cycle calibration
+    t->cal = -(d * NCAL + (int)(Rnd() % 21) - 10);
+    t->ix = (int)(Rnd() % (2 * d + 1)) - d;
+  }
+  else
+  {
+    t->cal = 0;                              //interpolator off
+    t->ix = (int)(Rnd() % 255) - 127;
+  }
+}
+
+//-------------------------- Edge random tuple: ------------------------------
+
+//values near guard limits of Calc_Result and counter width
+
+static const long long Edges[] =
+{
+  1, 2, 3, 99, 100, 101,
+  0xFFFFFFFF, 0x100000000, 0x1FFFFFFFF, 0x200000000, 0x200000001,
+  CNT_MAX / 2, CNT_MAX - 1, CNT_MAX,
+  LL_MAX / 1000000000 / 100, LL_MAX / 100000000 / 100,
+  LL_MAX / 10000000 / 100
+};
+
+#define EDGES (sizeof(Edges) / sizeof(Edges[0]))
+
+void EdgeTuple(Tuple *t)
+{
+  for(;;)
+  {
+    long long e = Edges[Rnd() % EDGES] + (long long)(Rnd() % 5) - 2;
+    t->mx = (Rnd() & 1)? e : (long long)(Rnd() % CNT_MAX) + 1;
+    e = Edges[Rnd() % EDGES] + (long long)(Rnd() % 5) - 2;
+    t->nx = (Rnd() & 1)? e : (long long)(Rnd() >> (24 + Rnd() % 40)) + 1;
+    if(t->mx < 1) t->mx = 1;
+    if(t->nx < 1) t->nx = 1;
+    if(t->mx > CNT_MAX) t->mx = CNT_MAX;
+    if(t->nx > CNT_MAX) t->nx = CNT_MAX;
+    switch(Rnd() % 3)
+    {
+    case 0: t->fref = FREF_MIN; break;
+    case 1: t->fref = FREF_MAX; break;
+    default: t->fref = FREF_NOM;
+    }
+    switch(Rnd() % 3)
+    {
+    case 0: t->pre = 1; break;
+    case 1: t->pre = PRE_MAX; break;
+    default: t->pre = 1 + (int)(Rnd() % PRE_MAX);
+    }
+    t->per = Rnd() & 1;
+    t->cal = (Rnd() & 1)? -(int)(200 + Rnd() % 1071) : 0;
+    int d = t->cal? -t->cal / NCAL : 127;
+    t->ix = (int)(Rnd() % (2 * d + 1)) - d;
+    if(Valid(t)) return;
+  }
+}
+
+//------------------------ Result fits 64 bits: ------------------------------
+
+//Calc_Result works for results up to 64 bits,
+//counts must be in range of 40 bit counters
+
+bool Valid(const Tuple *t)
+{
+  if(t->mx < 1 || t->nx < 1 || t->mx > CNT_MAX || t->nx > CNT_MAX)
+    return(0);
+  if(t->cal && t->mx * 100 + t->ix * 100 * NCAL / -t->cal < 50)
+    return(0);                        //gate shorter than Fref period
+  return(Ref(t, 0) < LL_MAX / 2);
+}
+
+//---------------------------- Check one tuple: ------------------------------
+
+void Check(Stat *s, const Tuple *t)
+{
+  long long r = Ref(t, 0);
+  long long v = Run(t);
+  long long e = v > r? v - r : r - v;
+  s->n++;
+  if(e) s->bad++;
+  if(e > s->err || (s->n == 1))
+  {
+    s->err = e;
+    s->worst = *t;
+  }
+  //relative error vs exact value includes the interpolator
+  //term truncation and 1 count resolution of small results:
+  long long x = Ref(t, 1);
+  if(x)
+  {
+    double d = (double)(v - x) / (double)x;
+    if(d < 0) d = -d;
+    if(d > s->rel) s->rel = d;
+  }
+}
+
+//------------------------------ Print tuple: --------------------------------
+
+void PrintTuple(const Tuple *t)
+{
+  printf("mx=%lld nx=%lld ix=%d cal=%d fref=%ld pre=%d %s",
+         t->mx, t->nx, t->ix, t->cal, t->fref, t->pre, t->per? "P" : "F");
+}
+
+//------------------------------- Benchmark: ---------------------------------
+
+//returns Calc_Result calls per second on tuples t[0..n-1]
+
+double Bench(Tuple *t, long n)
+{
+  volatile long long sink = 0;
+  struct timespec a, b;
+  clock_gettime(CLOCK_MONOTONIC, &a);
+  for(long i = 0; i < n; i++)
+    sink += Run(&t[i]);
+  clock_gettime(CLOCK_MONOTONIC, &b);
+  double s = (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) * 1E-9;
+  (void)sink;
+  return(s > 0? n / s : 0);
+}
+
+//--------------------------------- Main: ------------------------------------
+
+int main(int argc, char **argv)
+{
+  long n = N_TUPLES;
+  long nb = N_BENCH;
+  for(int i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-n") && i + 1 < argc) n = atol(argv[++i]);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+      Seed = strtoull(argv[++i], NULL, 0);
+    else if(!strcmp(argv[i], "-b") && i + 1 < argc) nb = atol(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Usage: %s [-n tuples] [-s seed] [-b bench tuples]\n",
+              argv[0]);
+      return(2);
+    }
+  }
+  if(!Seed) Seed = 1;
+  printf("CalcTest: seed %llu\n", (unsigned long long)Seed);
+  int fail = 0;
+
+  //golden vectors:
+  for(unsigned i = 0; i < GOLDS; i++)
+  {
+    long long v = Run(&Gold[i].t);
+    long long r = Ref(&Gold[i].t, 0);
+    if(v != Gold[i].res || r != Gold[i].res)
+    {
+      printf("FAIL golden %s: got %lld, ref %lld, expected %lld\n",
+             Gold[i].name, v, r, Gold[i].res);
+      fail = 1;
+    }
+  }
+  printf("golden: %u vectors%s\n", (unsigned)GOLDS, fail? "" : ", ok");
+
+  //randomized tuples:
+  Stat sp = {0}, ss = {0}, sl = {0}, se = {0};
+  for(long i = 0; i < n; i++)
+  {
+    Tuple t;
+    RndTuple(&t);
+    if(!Valid(&t)) continue;
+    Check(&sp, &t);
+    double tg = t.mx / (t.fref / 10.0);
+    Check(tg > T_SHORT? &sl : &ss, &t);
+    EdgeTuple(&t);
+    Check(&se, &t);
+  }
+  const Stat *st[] = { &ss, &sl, &sp, &se };
+  const char *sn[] = { "gate <= 10 s", "gate > 10 s", "physical", "edge" };
+  for(int i = 0; i < 4; i++)
+  {
+    printf("%-12s: %9lld tuples, %lld with error, max error %lld counts, "
+           "max rel. error vs exact %.3g\n",
+           sn[i], st[i]->n, st[i]->bad, st[i]->err, st[i]->rel);
+    if(st[i]->err)
+    {
+      printf("  worst: ");
+      PrintTuple(&st[i]->worst);
+      printf("\n");
+      fail = 1;
+    }
+  }
+
+  //throughput:
+  if(nb > 0)
+  {
+    Tuple *ts = malloc(nb * sizeof(Tuple));
+    Tuple *tl = malloc(nb * sizeof(Tuple));
+    if(!ts || !tl) return(2);
+    long ns = 0, nl = 0;
+    while(ns < nb || nl < nb)
+    {
+      Tuple t;
+      RndTuple(&t);
+      if(!Valid(&t)) continue;
+      if(t.mx / (t.fref / 10.0) > T_SHORT)
+      {
+        if(nl < nb) tl[nl++] = t;
+      }
+      else if(ns < nb) ts[ns++] = t;
+    }
+    double ps = Bench(ts, nb);
+    double pl = Bench(tl, nb);
+    printf("bench: gate <= 10 s %.3g calc/s (%.1f ns), "
+           "gate > 10 s %.3g calc/s (%.1f ns)\n",
+           ps, ps > 0? 1E9 / ps : 0, pl, pl > 0? 1E9 / pl : 0);
+    free(ts);
+    free(tl);
+  }
+
+  printf("%s\n", fail? "FAILED" : "PASSED");
+  return(fail);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,247 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: capture of many counters
+
+//----------------------------------------------------------------------------
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Capture.h"
+#include "Frame.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define ID_EV    (~0ULL)             //epoll ids of service descriptors
+#define ID_TM    (~1ULL)
+#define ID_SIG   (~2ULL)
+#define EVENTS   256                 //events per epoll_wait
+#define READ_BUF 4096                //read block
+#define OUT_MAX  (1 << 20)           //capture block written at once
+
+//------------------------------ Helpers: ------------------------------------
+
+static speed_t Speed(int baud)
+{
+  switch(baud)
+  {
+  case 9600:   return(B9600);
+  case 19200:  return(B19200);
+  case 38400:  return(B38400);
+  case 57600:  return(B57600);
+  case 115200: return(B115200);
+  }
+  return(B19200);
+}
+
+static int64_t Now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return((int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+//"/dev/ttyUSB0" -> "ttyUSB0", "/dev/pts/5" -> "pts_5"
+
+static std::string FileName(const std::string &path)
+{
+  std::string s = path.compare(0, 5, "/dev/")? path : path.substr(5);
+  for(auto &c : s) if(c == '/') c = '_';
+  return(s);
+}
+
+//------------------------------ Capture: ------------------------------------
+
+Capture::Capture(const std::string &dir, int baud)
+{
+  Dir = dir;
+  Baud = baud;
+  Ep = epoll_create1(EPOLL_CLOEXEC);
+  Ev = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  Tm = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  Sig = -1;
+  struct itimerspec it = {{1, 0}, {1, 0}};
+  timerfd_settime(Tm, 0, &it, nullptr);
+  struct epoll_event e = {};
+  e.events = EPOLLIN;
+  e.data.u64 = ID_EV;
+  epoll_ctl(Ep, EPOLL_CTL_ADD, Ev, &e);
+  e.data.u64 = ID_TM;
+  epoll_ctl(Ep, EPOLL_CTL_ADD, Tm, &e);
+}
+
+Capture::~Capture()
+{
+  for(auto &d : Devs)
+  {
+    Flush(d);
+    if(d.Fd >= 0) close(d.Fd);
+    if(d.File >= 0) close(d.File);
+  }
+  close(Ep); close(Ev); close(Tm);
+  if(Sig >= 0) close(Sig);
+}
+
+bool Capture::Signals(void)
+{
+  sigset_t s;
+  sigemptyset(&s);
+  sigaddset(&s, SIGINT);
+  sigaddset(&s, SIGTERM);
+  if(sigprocmask(SIG_BLOCK, &s, nullptr)) return(0);
+  Sig = signalfd(-1, &s, SFD_NONBLOCK | SFD_CLOEXEC);
+  if(Sig < 0) return(0);
+  struct epoll_event e = {};
+  e.events = EPOLLIN;
+  e.data.u64 = ID_SIG;
+  return(!epoll_ctl(Ep, EPOLL_CTL_ADD, Sig, &e));
+}
+
+bool Capture::Add(const std::string &dev)
+{
+  Dev d;
+  d.Path = dev;
+  d.Name = FileName(dev);
+  d.Fd = -1;
+  d.Long = 0;
+  d.St = {};
+  d.File = open((Dir + "/" + d.Name + ".cap").c_str(),
+                O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if(d.File < 0) { perror(d.Name.c_str()); return(0); }
+  Devs.push_back(d);
+  if(Open(Devs.back())) return(1);
+  close(Devs.back().File);
+  Devs.pop_back();
+  return(0);
+}
+
+//raw mode, device index is the epoll id
+
+bool Capture::Open(Dev &d)
+{
+  d.Fd = open(d.Path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if(d.Fd < 0) return(0);
+  struct termios tio;
+  if(!tcgetattr(d.Fd, &tio))
+  {
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, Speed(Baud));
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(d.Fd, TCSANOW, &tio);
+  }
+  struct epoll_event e = {};
+  e.events = EPOLLIN | EPOLLRDHUP;
+  e.data.u64 = &d - Devs.data();
+  epoll_ctl(Ep, EPOLL_CTL_ADD, d.Fd, &e);
+  d.Line.clear();
+  d.Long = 0;
+  return(1);
+}
+
+void Capture::Lost(Dev &d)
+{
+  epoll_ctl(Ep, EPOLL_CTL_DEL, d.Fd, nullptr);
+  close(d.Fd);
+  d.Fd = -1;
+}
+
+void Capture::Stop(void)
+{
+  uint64_t one = 1;
+  if(write(Ev, &one, sizeof(one)) < 0) {}
+}
+
+//------------------------------- Loop: --------------------------------------
+
+void Capture::Run(void)
+{
+  struct epoll_event ev[EVENTS];
+  while(1)
+  {
+    int n = epoll_wait(Ep, ev, EVENTS, -1);
+    if(n < 0 && errno != EINTR) break;
+    for(int i = 0; i < n; i++)
+    {
+      uint64_t id = ev[i].data.u64;
+      if(id == ID_EV || id == ID_SIG) return;
+      if(id == ID_TM)
+      {
+        uint64_t x;
+        if(read(Tm, &x, sizeof(x)) < 0) {}
+        for(auto &d : Devs)
+        {
+          Flush(d);
+          if(d.Fd < 0 && Open(d)) d.St.Reopens++;
+        }
+        continue;
+      }
+      Dev &d = Devs[id];
+      if(d.Fd < 0) continue;
+      Read(d);
+      if(d.Fd >= 0 && (ev[i].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR))) Lost(d);
+    }
+  }
+}
+
+//all bytes available are taken, lines get the read time
+
+void Capture::Read(Dev &d)
+{
+  char buf[READ_BUF];
+  while(1)
+  {
+    ssize_t n = read(d.Fd, buf, sizeof(buf));
+    if(n < 0 && errno == EAGAIN) return;
+    if(n <= 0) { Lost(d); return; }
+    int64_t t = Now();
+    d.St.Bytes += n;
+    for(ssize_t i = 0; i < n; i++)
+    {
+      char c = buf[i];
+      if(c == '\n') { Take(d, t); continue; }
+      if(c == '\r') continue;
+      if(d.Line.size() < FRAME_MAX) d.Line += c;
+        else d.Long = 1;
+    }
+    if(d.Out.size() > OUT_MAX) Flush(d);
+  }
+}
+
+void Capture::Take(Dev &d, int64_t t)
+{
+  Frame f;
+  if(d.Line.empty() && !d.Long) return;
+  bool ok = !d.Long && f.Parse(d.Line.data(), d.Line.size());
+  d.St.Frames++;
+  if(!ok) d.St.Bad++;
+  char h[32];
+  snprintf(h, sizeof(h), "%lld %c ", (long long)t, ok? f.Type : FRAME_BAD);
+  d.Out += h;
+  for(char c : d.Line) d.Out += (c >= ' ' && c != 0x7F)? c : '.';
+  d.Out += '\n';
+  d.Line.clear();
+  d.Long = 0;
+}
+
+void Capture::Flush(Dev &d)
+{
+  size_t p = 0;
+  while(p < d.Out.size())
+  {
+    ssize_t n = write(d.File, d.Out.data() + p, d.Out.size() - p);
+    if(n <= 0) { perror(d.Name.c_str()); break; }
+    p += n;
+  }
+  d.Out.clear();
+}
+
+//----------------------------------------------------------------------------
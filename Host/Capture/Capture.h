@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: capture of many counters, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef CaptureH
+#define CaptureH
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//----------------------------- Constants: -----------------------------------
+
+#define CAP_BAUD 19200               //UART baud rate, as Port.c
+
+//------------------------------ Capture: ------------------------------------
+
+//Single thread, single epoll loop over all devices. Each line is time
+//stamped on arrival (CLOCK_REALTIME, ns), parsed (Frame.h) and added
+//to the device capture file "<name>.cap" as "<ns> <type> <line>".
+//Files are opened for append and written in blocks once per second,
+//so the loop does no small writes. Lost devices (EOF, HUP) are
+//reopened once per second.
+
+class Capture
+{
+public:
+  struct Stat
+  {
+    uint64_t Frames;                 //lines taken
+    uint64_t Bad;                    //not FC-510 frames
+    uint64_t Bytes;                  //bytes read
+    uint64_t Reopens;                //device reopens
+  };
+
+  Capture(const std::string &dir, int baud = CAP_BAUD);
+  ~Capture();
+  bool Add(const std::string &dev);  //add device, 0 - cannot open
+  void Run(void);                    //capture until Stop() or signal
+  void Stop(void);                   //stop Run(), any thread
+  bool Signals(void);                //stop by SIGINT, SIGTERM
+  size_t Devices(void) const { return(Devs.size()); }
+  const Stat &Stats(size_t i) const { return(Devs[i].St); }
+  const std::string &Name(size_t i) const { return(Devs[i].Name); }
+
+private:
+  struct Dev
+  {
+    std::string Path;                //device path
+    std::string Name;                //capture file name base
+    int Fd;                          //device, -1 - lost
+    int File;                        //capture file
+    std::string Line;                //line being received
+    bool Long;                       //line is over FRAME_MAX
+    std::string Out;                 //capture lines to write
+    Stat St;
+  };
+  std::string Dir;
+  int Baud;
+  int Ep;                            //epoll
+  int Ev;                            //stop eventfd
+  int Tm;                            //flush and reopen timerfd
+  int Sig;                           //signalfd, -1 - not used
+  std::vector<Dev> Devs;
+
+  bool Open(Dev &d);
+  void Lost(Dev &d);
+  void Read(Dev &d);
+  void Take(Dev &d, int64_t t);
+  void Flush(Dev &d);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
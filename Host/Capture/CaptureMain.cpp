@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: capture daemon for many counters
+
+//Usage: Capture [-o dir] [-b baud] [-l list] [device ...]
+//-o dir   capture files directory (default .)
+//-b baud  UART baud rate (default 19200)
+//-l list  file with device paths, one per line
+//Runs until SIGINT or SIGTERM, then writes statistics to stderr.
+
+//----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "Capture.h"
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  std::string dir = ".";
+  int baud = CAP_BAUD;
+  std::vector<std::string> devs;
+  int o;
+  while((o = getopt(argc, argv, "o:b:l:")) != -1)
+  {
+    switch(o)
+    {
+    case 'o': dir = optarg; break;
+    case 'b': baud = atoi(optarg); break;
+    case 'l':
+      {
+        FILE *f = fopen(optarg, "r");
+        if(!f) { perror(optarg); return(2); }
+        char s[256];
+        while(fscanf(f, "%255s", s) == 1) devs.push_back(s);
+        fclose(f);
+        break;
+      }
+    default:
+      fprintf(stderr, "Usage: Capture [-o dir] [-b baud] [-l list] [device ...]\n");
+      return(2);
+    }
+  }
+  for(int i = optind; i < argc; i++) devs.push_back(argv[i]);
+  if(devs.empty()) { fprintf(stderr, "Capture: no devices\n"); return(2); }
+
+  Capture cap(dir, baud);
+  if(!cap.Signals()) { perror("Capture: signals"); return(2); }
+  for(auto &d : devs)
+    if(!cap.Add(d)) fprintf(stderr, "Capture: cannot open %s\n", d.c_str());
+  if(!cap.Devices()) return(1);
+  cap.Run();
+
+  for(size_t i = 0; i < cap.Devices(); i++)
+  {
+    const Capture::Stat &s = cap.Stats(i);
+    fprintf(stderr, "%s: %llu frames, %llu bad, %llu bytes, %llu reopens\n",
+            cap.Name(i).c_str(), (unsigned long long)s.Frames,
+            (unsigned long long)s.Bad, (unsigned long long)s.Bytes,
+            (unsigned long long)s.Reopens);
+  }
+  return(0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,170 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of frame parser and capture daemon
+
+//Frames of each kind are parsed. Then capture runs in its thread on
+//many ptys while display, result, ID and garbage lines are sent to all
+//of them as fast as the ptys take them: every line must be in the
+//capture file of its device, in order, with its type and
+//non-decreasing time stamps.
+
+//Usage: CaptureTest [-n devices] [-r lines per device]
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include "Capture.h"
+#include "Frame.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define N_DEVS  250                  //default devices
+#define N_LINES 200                  //default lines per device
+
+//------------------------------ Variables: ----------------------------------
+
+static int Fails;
+
+//------------------------------- Check: -------------------------------------
+
+static void Check(bool c, const char *what)
+{
+  if(c) return;
+  printf("FAILED: %s\n", what);
+  Fails++;
+}
+
+//---------------------------- Frame parser: ---------------------------------
+
+static void TestFrame(void)
+{
+  Frame f;
+  Check(f.Parse("F 1000.00000 kHz", 16) && f.Type == FRAME_DISP &&
+        f.HasValue && f.Mant == 100000000 && f.Dec == 5 && f.Seq < 0, "display");
+  Check(f.Parse("00042 P   0.000921 ms ", 22) && f.Type == FRAME_DISP &&
+        f.Seq == 42 && f.Mant == 921 && f.Dec == 6, "display with sequence");
+  Check(f.Parse("$07F  ----.---- kHz", 19) && f.Addr == 7 && !f.HasValue, "addressed display");
+  Check(f.Parse("FC-510 V2.1", 11) && f.Type == FRAME_ID, "ID");
+  const char *r = "123,45678,0,10000.000012345";
+  Check(f.Parse(r, strlen(r)) && f.Type == FRAME_RES && f.Seq == 123 &&
+        f.Ms == 45678 && f.Mode == 0 && f.Mant == 10000000012345LL && f.Dec == 9, "result");
+  r = "5,100,10,-0.000123";
+  Check(f.Parse(r, strlen(r)) && f.Mode == 10 && f.Mant == -123, "negative result");
+  Check(f.Parse("$05P03=-1500", 12) && f.Type == FRAME_PAR && f.Addr == 5 &&
+        f.Seq == 3 && f.Mant == -1500 && f.Dec == 0, "parameter");
+  Check(!f.Parse("P01=2.5", 7), "parameter with point");
+  Check(!f.Parse("garbage", 7) && f.Type == FRAME_BAD, "garbage");
+  Check(!f.Parse("1,2,3,4x", 8), "result with tail");
+}
+
+//------------------------------ Capture: ------------------------------------
+
+static std::string Line(int dev, int k)
+{
+  char s[64];
+  switch(k % 4)
+  {
+  case 0: snprintf(s, sizeof(s), "F %4d.%05d kHz", dev % 10000, k % 100000); break;
+  case 1: snprintf(s, sizeof(s), "%d,%d,0,%d.%09d", k, k * 100, dev, k); break;
+  case 2: snprintf(s, sizeof(s), "FC-510 V2.1"); break;
+  default: snprintf(s, sizeof(s), "~%d~%d~", dev, k); //shorter than display
+  }
+  return(s);
+}
+
+static char Type(int k)
+{
+  static const char t[] = {FRAME_DISP, FRAME_RES, FRAME_ID, FRAME_BAD};
+  return(t[k % 4]);
+}
+
+static void TestCapture(int devs, int lines)
+{
+  char dir[] = "/tmp/CaptureTestXXXXXX";
+  if(!mkdtemp(dir)) { Check(0, "temp directory"); return; }
+  std::vector<int> m(devs);
+  std::vector<Capture::Stat> st;
+  std::vector<std::string> names;
+  {
+    Capture cap(dir);
+    for(int i = 0; i < devs; i++)
+    {
+      m[i] = posix_openpt(O_RDWR | O_NOCTTY);
+      if(m[i] < 0 || grantpt(m[i]) || unlockpt(m[i]) || !cap.Add(ptsname(m[i])))
+        { Check(0, "pty"); return; }
+    }
+    std::thread run([&]{ cap.Run(); });
+    auto t0 = std::chrono::steady_clock::now();
+    for(int k = 0; k < lines; k++)
+      for(int i = 0; i < devs; i++)
+      {
+        std::string s = Line(i, k) + "\r\n";
+        if(write(m[i], s.data(), s.size()) != (ssize_t)s.size()) Check(0, "pty write");
+      }
+    double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    usleep(300000);
+    cap.Stop();
+    run.join();
+    printf("%d devices, %d lines: %.0f lines/s\n", devs, devs * lines, devs * lines / dt);
+    for(int i = 0; i < devs; i++)
+    {
+      st.push_back(cap.Stats(i));
+      names.push_back(cap.Name(i));
+    }
+  }                                  //capture files are flushed
+
+  for(int i = 0; i < devs; i++)
+    Check(st[i].Frames == (uint64_t)lines && st[i].Bad == (uint64_t)(lines / 4), "device counts");
+  for(int dev : {0, devs - 1})
+  {
+    FILE *f = fopen((std::string(dir) + "/" + names[dev] + ".cap").c_str(), "r");
+    if(!f) { Check(0, "capture file"); continue; }
+    char s[128];
+    long long tp = 0;
+    int k = 0;
+    while(fgets(s, sizeof(s), f))
+    {
+      long long t;
+      char c;
+      int p;
+      if(sscanf(s, "%lld %c %n", &t, &c, &p) != 2) { Check(0, "capture line"); break; }
+      s[strcspn(s, "\n")] = 0;
+      Check(t >= tp && c == Type(k) && Line(dev, k) == s + p, "capture line");
+      tp = t;
+      k++;
+    }
+    fclose(f);
+    Check(k == lines, "capture file lines");
+  }
+  for(int i = 0; i < devs; i++) close(m[i]);
+  if(system((std::string("rm -rf ") + dir).c_str())) {}
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  int devs = N_DEVS, lines = N_LINES;
+  int o;
+  while((o = getopt(argc, argv, "n:r:")) != -1)
+  {
+    if(o == 'n') devs = atoi(optarg);
+    else if(o == 'r') lines = atoi(optarg);
+    else { fprintf(stderr, "Usage: CaptureTest [-n devices] [-r lines]\n"); return(2); }
+  }
+  TestFrame();
+  TestCapture(devs, lines);
+  printf(Fails? "FAILED\n" : "PASSED\n");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
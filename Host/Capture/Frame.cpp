@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: UART frames of Port.c
+
+//----------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstring>
+#include "Frame.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define MANT_DIGITS 18               //int64_t mantissa digits
+#define SEQ_DIGITS  5                //display frame sequence digits
+
+static const char Str_Id[] = "FC-510 V";
+
+//------------------------------ Helpers: ------------------------------------
+
+static bool Digit(char c)
+{
+  return(c >= '0' && c <= '9');
+}
+
+//unsigned integer field up to the separator, moves s
+
+static bool Field(const char *&s, const char *e, char sep, long &v)
+{
+  if(s >= e || !Digit(*s)) return(0);
+  v = 0;
+  for(int i = 0; s < e && Digit(*s); s++, i++)
+  {
+    if(i >= MANT_DIGITS) return(0);
+    v = v * 10 + (*s - '0');
+  }
+  if(sep)
+  {
+    if(s >= e || *s != sep) return(0);
+    s++;
+  }
+  return(1);
+}
+
+//------------------------------ Number: -------------------------------------
+
+bool Frame_Number(const char *s, size_t n, int64_t &mant, int &dec, size_t *end)
+{
+  size_t i = 0;
+  while(i < n && !Digit(s[i])) i++;
+  if(i == n) return(0);
+  bool neg = i && s[i - 1] == '-';
+  mant = 0; dec = -1;
+  int digits = 0;
+  for(; i < n; i++)
+  {
+    if(s[i] == '.' && dec < 0) { dec = 0; continue; }
+    if(!Digit(s[i])) break;
+    if(++digits > MANT_DIGITS) return(0);
+    mant = mant * 10 + (s[i] - '0');
+    if(dec >= 0) dec++;
+  }
+  if(dec < 0) dec = 0;
+  if(neg) mant = -mant;
+  if(end) *end = i;
+  return(1);
+}
+
+//------------------------------- Frame: -------------------------------------
+
+bool Frame::Parse(const char *s, size_t n)
+{
+  const char *e = s + n;
+  Type = FRAME_BAD;
+  Addr = -1; Seq = -1; Ms = -1; Mode = -1;
+  Text.clear();
+  HasValue = 0; Mant = 0; Dec = 0;
+  if(n > FRAME_MAX) return(0);
+
+  //response header:
+  if(n >= 3 && s[0] == '$' && Digit(s[1]) && Digit(s[2]))
+  {
+    Addr = (s[1] - '0') * 10 + (s[2] - '0');
+    s += 3;
+  }
+  size_t len = e - s;
+
+  //ID:
+  if(len > strlen(Str_Id) && !memcmp(s, Str_Id, strlen(Str_Id)))
+  {
+    Text.assign(s, len);
+    Type = FRAME_ID;
+    return(1);
+  }
+
+  //parameter:
+  const char *p = s;
+  if(len > 4 && s[0] == 'P' && Digit(s[1]) && Digit(s[2]) && s[3] == '=')
+  {
+    size_t end;
+    p = s + 4;
+    if(!Frame_Number(p, e - p, Mant, Dec, &end)) return(0);
+    if(p + end != e || Dec || (*p != '-' && !Digit(*p))) return(0);
+    Seq = (s[1] - '0') * 10 + (s[2] - '0');
+    HasValue = 1;
+    Type = FRAME_PAR;
+    return(1);
+  }
+
+  //result line:
+  p = s;
+  long num, ms, mode;
+  if(Field(p, e, ',', num) && Field(p, e, ',', ms) && Field(p, e, ',', mode))
+  {
+    size_t end;
+    if(!Frame_Number(p, e - p, Mant, Dec, &end)) return(0);
+    if(p + end != e || (*p != '-' && !Digit(*p))) return(0);
+    Seq = num; Ms = ms; Mode = mode;
+    HasValue = 1;
+    Type = FRAME_RES;
+    return(1);
+  }
+
+  //display copy with optional sequence number:
+  if(len == SEQ_DIGITS + 1 + DISP_CHR && s[SEQ_DIGITS] == ' ')
+  {
+    p = s;
+    if(!Field(p, s + SEQ_DIGITS, 0, Seq) || p != s + SEQ_DIGITS) return(0);
+    s += SEQ_DIGITS + 1;
+    len = DISP_CHR;
+  }
+  if(len != DISP_CHR) return(0);
+  Text.assign(s, len);
+  HasValue = Frame_Number(s, len, Mant, Dec);
+  Type = FRAME_DISP;
+  return(1);
+}
+
+double Frame::Value(void) const
+{
+  return((double)Mant / pow(10.0, Dec));
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: UART frames of Port.c, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef FrameH
+#define FrameH
+
+#include <cstdint>
+#include <string>
+
+//----------------------------- Constants: -----------------------------------
+
+#define FRAME_BAD  '?'               //not a frame
+#define FRAME_DISP 'D'               //display copy (Port_Frame)
+#define FRAME_ID   'I'               //identification (Port_IdFrame)
+#define FRAME_RES  'R'               //result line (Port_ResFrame)
+#define FRAME_PAR  'P'               //parameter (Port_ParFrame)
+
+#define FRAME_MAX  64                //longest line taken
+#define DISP_CHR   16                //display chars in frame, as Port.c
+
+//------------------------------- Frame: -------------------------------------
+
+//One line without CR/LF:
+//display copy: [$nn][sssss ]<16 chars>, value is the first number,
+//ID:           [$nn]FC-510 Vx.y,
+//result line:  [$nn]num,ms,mode,value (value in display units),
+//parameter:    [$nn]Pnn=value (Seq is the number, value as Par[]).
+//Value is kept as decimal mantissa and digits after the point,
+//so full precision result lines lose nothing.
+
+struct Frame
+{
+  char Type;                         //FRAME_xxx
+  int Addr;                          //bus address, -1 - not addressed
+  long Seq;                          //display: sync sequence, result, parameter: number, -1 - none
+  long Ms;                           //result time, ms, -1 - none
+  int Mode;                          //result mode (Count.h), -1 - none
+  std::string Text;                  //display chars or ID text
+  bool HasValue;                     //value found
+  int64_t Mant;                      //value mantissa
+  int Dec;                           //value digits after the point
+
+  bool Parse(const char *s, size_t n); //parse line, 0 - bad frame
+  double Value(void) const;          //value as double
+};
+
+//first decimal number in text, 0 - no number
+bool Frame_Number(const char *s, size_t n, int64_t &mant, int &dec, size_t *end = nullptr);
+
+//----------------------------------------------------------------------------
+
+#endif
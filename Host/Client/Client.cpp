@@ -0,0 +1,469 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host client library (libfc510)
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Client.h"
+#include "Menu.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define EVENTS   64                  //events per epoll_wait
+#define READ_BUF 1024                //read block
+#define CMD_MAX  24                  //longest command with address
+
+//FC_xxx are PAR_xxx of Menu.h:
+
+static constexpr bool Same(int fc, int par) { return(fc == par); }
+
+static_assert(Same(FC_MODE, PAR_MODE) && Same(FC_GATE, PAR_GATE) &&
+              Same(FC_AVG, PAR_AVG) && Same(FC_IF, PAR_IF) &&
+              Same(FC_PRE, PAR_PRE) && Same(FC_ADR, PAR_ADR) &&
+              Same(FC_OUT, PAR_OUT) && Same(FC_FAST, PAR_FAST) &&
+              Same(FC_FLT, PAR_FLT) && Same(FC_INT, PAR_INT) &&
+              Same(FC_RF, PAR_RF) && Same(FC_LVL, PAR_LVL) &&
+              Same(FC_SIF, PAR_SIF) && Same(FC_SRF, PAR_SRF) &&
+              Same(FC_WIN, PAR_WIN) && Same(FC_WLEN, PAR_WLEN) &&
+              Same(FC_PARAMS, PARAMS),
+              "FC_xxx differ from PAR_xxx of Menu.h");
+
+//------------------------------ Helpers: ------------------------------------
+
+static int64_t Now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return((int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static speed_t Speed(int baud)
+{
+  switch(baud)
+  {
+  case 9600:   return(B9600);
+  case 19200:  return(B19200);
+  case 38400:  return(B38400);
+  case 57600:  return(B57600);
+  case 115200: return(B115200);
+  }
+  return(B19200);
+}
+
+//top level task runner, frees itself
+
+struct FcDetached
+{
+  struct promise_type
+  {
+    FcDetached get_return_object(void) { return(FcDetached()); }
+    std::suspend_never initial_suspend(void) noexcept { return(std::suspend_never()); }
+    std::suspend_never final_suspend(void) noexcept { return(std::suspend_never()); }
+    void return_void(void) {}
+    void unhandled_exception(void) { std::terminate(); }
+  };
+};
+
+static FcDetached Detach(FcTask<void> t)
+{
+  co_await t;
+}
+
+//-------------------------------- Loop: -------------------------------------
+
+FcLoop::FcLoop()
+{
+  Ep = epoll_create1(EPOLL_CLOEXEC);
+  Ev = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  Quit = 0;
+  Ids = 0;
+  struct epoll_event e = {};
+  e.events = EPOLLIN;
+  e.data.ptr = nullptr;
+  epoll_ctl(Ep, EPOLL_CTL_ADD, Ev, &e);
+}
+
+FcLoop::~FcLoop()
+{
+  Ports.clear();
+  close(Ep);
+  close(Ev);
+}
+
+void FcLoop::Run(void)
+{
+  struct epoll_event ev[EVENTS];
+  Quit = 0;
+  while(1)
+  {
+    while(!Ready.empty())
+    {
+      std::coroutine_handle<> h = Ready.front();
+      Ready.pop_front();
+      h.resume();
+    }
+    if(Quit) break;
+    int w = -1;
+    if(!Timers.empty())
+      w = (int)std::max<int64_t>(0, Timers.begin()->first.first - Now());
+    int n = epoll_wait(Ep, ev, EVENTS, w);
+    if(n < 0 && errno != EINTR) break;
+    for(int i = 0; i < n; i++)
+    {
+      if(!ev[i].data.ptr)
+      {
+        uint64_t x;
+        if(read(Ev, &x, sizeof(x)) < 0) {}
+        Quit = 1;
+      }
+      else ((FcPort *)ev[i].data.ptr)->Event(ev[i].events);
+    }
+    int64_t t = Now();
+    while(!Timers.empty() && Timers.begin()->first.first <= t)
+    {
+      auto i = Timers.begin();
+      std::function<void()> f = std::move(i->second);
+      TimerAt.erase(i->first.second);
+      Timers.erase(i);
+      f();
+    }
+  }
+}
+
+void FcLoop::Stop(void)
+{
+  uint64_t one = 1;
+  if(write(Ev, &one, sizeof(one)) < 0) {}
+}
+
+void FcLoop::Spawn(FcTask<void> t)
+{
+  Detach(std::move(t));
+}
+
+uint64_t FcLoop::After(int ms, std::function<void()> f)
+{
+  int64_t at = Now() + ms;
+  Ids++;
+  Timers.emplace(std::make_pair(at, Ids), std::move(f));
+  TimerAt[Ids] = at;
+  return(Ids);
+}
+
+void FcLoop::Cancel(uint64_t id)
+{
+  auto i = TimerAt.find(id);
+  if(i == TimerAt.end()) return;
+  Timers.erase(std::make_pair(i->second, id));
+  TimerAt.erase(i);
+}
+
+void FcLoop::Post(std::coroutine_handle<> h)
+{
+  Ready.push_back(h);
+}
+
+FcPort *FcLoop::GetPort(const std::string &path, int baud)
+{
+  auto i = Ports.find(path);
+  if(i != Ports.end()) return(i->second.get());
+  FcPort *p = new FcPort(*this, path, baud);
+  Ports[path].reset(p);
+  if(!p->Open()) p->Lost();
+  return(p);
+}
+
+void FcLoop::PutPort(FcPort *p)
+{
+  if(p->Counters.empty()) Ports.erase(p->Path);
+}
+
+//-------------------------------- Port: -------------------------------------
+
+FcPort::FcPort(FcLoop &l, const std::string &path, int baud) : L(l)
+{
+  Path = path;
+  Baud = baud;
+  Fd = -1;
+  Long = 0;
+  Busy = 0;
+  Retry = 0;
+  Reconnects = 0;
+}
+
+FcPort::~FcPort()
+{
+  if(Retry) L.Cancel(Retry);
+  if(Fd >= 0) close(Fd);
+}
+
+//raw mode, port is the epoll data
+
+bool FcPort::Open(void)
+{
+  Fd = open(Path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if(Fd < 0) return(0);
+  struct termios tio;
+  if(!tcgetattr(Fd, &tio))
+  {
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, Speed(Baud));
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(Fd, TCSANOW, &tio);
+  }
+  struct epoll_event e = {};
+  e.events = EPOLLIN | EPOLLRDHUP;
+  e.data.ptr = this;
+  epoll_ctl(L.Ep, EPOLL_CTL_ADD, Fd, &e);
+  Line.clear();
+  Long = 0;
+  return(1);
+}
+
+//waits of all counters fail, device is reopened by timer
+
+void FcPort::Lost(void)
+{
+  if(Fd >= 0)
+  {
+    epoll_ctl(L.Ep, EPOLL_CTL_DEL, Fd, nullptr);
+    close(Fd);
+    Fd = -1;
+  }
+  for(FcCounter *c : Counters) c->Fail();
+  if(Retry) return;
+  Retry = L.After(FC_RECONN, [this]
+  {
+    Retry = 0;
+    if(Open()) Reconnects++;
+      else Lost();
+  });
+}
+
+void FcPort::Event(uint32_t ev)
+{
+  char buf[READ_BUF];
+  while(Fd >= 0)
+  {
+    ssize_t n = read(Fd, buf, sizeof(buf));
+    if(n < 0 && errno == EAGAIN) break;
+    if(n <= 0) { Lost(); return; }
+    for(ssize_t i = 0; i < n; i++)
+    {
+      char c = buf[i];
+      if(c == '\n') { Take(); continue; }
+      if(c == '\r') continue;
+      if(Line.size() < FRAME_MAX) Line += c;
+        else Long = 1;
+    }
+  }
+  if(Fd >= 0 && (ev & (EPOLLHUP | EPOLLRDHUP | EPOLLERR))) Lost();
+}
+
+//frame to counter of its address, not addressed frames to address 0
+
+void FcPort::Take(void)
+{
+  Frame f;
+  if(!Long && f.Parse(Line.data(), Line.size()))
+  {
+    int a = f.Addr < 0? 0 : f.Addr;
+    for(FcCounter *c : Counters)
+      if(c->Addr == a) c->Deliver(f);
+  }
+  Line.clear();
+  Long = 0;
+}
+
+bool FcPort::Send(int addr, const char *cmd)
+{
+  if(Fd < 0) return(0);
+  char s[CMD_MAX];
+  int n = addr? snprintf(s, sizeof(s), "#%02d%s", addr, cmd) :
+                snprintf(s, sizeof(s), "%s", cmd);
+  if(write(Fd, s, n) == n) return(1);
+  if(errno != EAGAIN) Lost();
+  return(0);
+}
+
+bool FcPort::Lock::await_ready(void)
+{
+  if(P->Busy) return(0);
+  P->Busy = 1;
+  return(1);
+}
+
+void FcPort::Unlock(void)
+{
+  if(LockQ.empty()) { Busy = 0; return; }
+  std::coroutine_handle<> h = LockQ.front();
+  LockQ.pop_front();
+  L.Post(h);                         //port passes to next request
+}
+
+//------------------------------- Counter: -----------------------------------
+
+FcCounter::FcCounter(FcLoop &l, const std::string &dev, int addr, int baud) : L(l)
+{
+  P = l.GetPort(dev, baud);
+  P->Counters.push_back(this);
+  Addr = addr;
+  Tmo = FC_TIMEOUT;
+  Drops = 0;
+}
+
+FcCounter::~FcCounter()
+{
+  Fail();
+  P->Counters.erase(std::find(P->Counters.begin(), P->Counters.end(), this));
+  L.PutPort(P);
+}
+
+void FcCounter::Wait::await_suspend(std::coroutine_handle<> h)
+{
+  H = h;
+  C->Waits.push_back(this);
+  Tm = Ms < 0? 0 : C->L.After(Ms, [this]
+  {
+    C->Waits.erase(std::find(C->Waits.begin(), C->Waits.end(), this));
+    C->L.Post(H);                    //R.Ok is 0
+  });
+}
+
+//frame to first wait of its type, result lines are kept
+
+void FcCounter::Deliver(const Frame &f)
+{
+  for(auto i = Waits.begin(); i != Waits.end(); i++)
+  {
+    Wait *w = *i;
+    if(w->Type != f.Type) continue;
+    Waits.erase(i);
+    if(w->Tm) L.Cancel(w->Tm);
+    w->R.Ok = 1;
+    w->R.F = f;
+    L.Post(w->H);
+    return;
+  }
+  if(f.Type != FRAME_RES) return;
+  if(Results.size() >= FC_RESULTS)
+  {
+    Results.pop_front();
+    Drops++;
+  }
+  Results.push_back(f);
+}
+
+void FcCounter::Fail(void)
+{
+  for(Wait *w : Waits)
+  {
+    if(w->Tm) L.Cancel(w->Tm);
+    L.Post(w->H);
+  }
+  Waits.clear();
+}
+
+//Port is taken by caller. Awaiters and results are named locals:
+//g++ 12 frees temporaries of "co_return co_await" too early.
+
+FcTask<FcReply> FcCounter::Request(const char *cmd, char type)
+{
+  if(!P->Send(Addr, cmd)) co_return FcReply{};
+  Wait w = {this, type, Tmo, {}, 0, {}};
+  FcReply r = co_await w;
+  co_return r;
+}
+
+FcTask<FcReply> FcCounter::Read(void)
+{
+  co_await FcPort::Lock{P};
+  FcReply r = co_await Request("R", FRAME_DISP);
+  P->Unlock();
+  co_return r;
+}
+
+FcTask<FcReply> FcCounter::Id(void)
+{
+  co_await FcPort::Lock{P};
+  FcReply r = co_await Request("?", FRAME_ID);
+  P->Unlock();
+  co_return r;
+}
+
+FcTask<bool> FcCounter::Key(char k)
+{
+  char s[2] = {k, 0};
+  co_await FcPort::Lock{P};
+  bool ok = P->Send(Addr, s);
+  P->Unlock();
+  co_return ok;
+}
+
+FcTask<bool> FcCounter::Sync(void)
+{
+  bool ok = co_await Key('S');
+  co_return ok;
+}
+
+FcTask<FcReply> FcCounter::Next(int ms)
+{
+  if(!Results.empty())
+  {
+    FcReply r = {1, Results.front()};
+    Results.pop_front();
+    co_return r;
+  }
+  Wait w = {this, FRAME_RES, ms, {}, 0, {}};
+  FcReply r = co_await w;
+  co_return r;
+}
+
+//---------------------------- Parameters: ----------------------------------
+
+//"Pnn" is answered with Par[nn] by the counter, nothing changes;
+//"Pnn=value" sets it as the setup menu would: value on the ParUpDn()
+//step grid, saved and counter restarted only if new, refused while
+//the setup menu is open. The answer is the value after the command.
+
+FcTask<FcReply> FcCounter::Param(int par, const long *v)
+{
+  char s[CMD_MAX];
+  if(v) snprintf(s, sizeof(s), "P%02d=%ld\r", par, *v);
+    else snprintf(s, sizeof(s), "P%02d\r", par);
+  co_await FcPort::Lock{P};
+  FcReply r = co_await Request(s, FRAME_PAR);
+  P->Unlock();
+  r.Ok = r.Ok && r.F.Seq == par;
+  co_return r;
+}
+
+FcTask<FcPar> FcCounter::Get(int par)
+{
+  FcPar v = {};
+  if(par < 0 || par >= FC_PARAMS) co_return v;
+  FcReply r = co_await Param(par, nullptr);
+  v.Ok = r.Ok;
+  v.Value = r.F.Mant;
+  co_return v;
+}
+
+FcTask<bool> FcCounter::Set(int par, long v)
+{
+  if(par < 0 || par >= FC_PARAMS) co_return 0;
+  FcReply r = co_await Param(par, &v);
+  co_return r.Ok && r.F.Mant == v;
+}
+
+//----------------------------------------------------------------------------
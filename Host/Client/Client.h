@@ -0,0 +1,205 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host client library (libfc510), header file
+
+//----------------------------------------------------------------------------
+
+#ifndef ClientH
+#define ClientH
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Task.h"
+#include "../Capture/Frame.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define FC_BAUD     19200            //UART baud rate, as Port.c
+#define FC_TIMEOUT  1000             //default response timeout, ms
+#define FC_RECONN   1000             //reopen period of lost device, ms
+#define FC_RESULTS  4096             //result lines kept for Next()
+
+//Parameters as PAR_xxx of Menu.h, checked against it at build time:
+
+enum
+{
+  FC_MODE, FC_GATE, FC_AVG, FC_IF, FC_PRE, FC_INT, FC_RF,
+  FC_SIF, FC_SRF, FC_ADR, FC_OUT, FC_FAST, FC_FLT, FC_LVL,
+  FC_WIN, FC_WLEN, FC_PARAMS
+};
+
+//------------------------------- Replies: -----------------------------------
+
+struct FcReply
+{
+  bool Ok;                           //0 - timeout or device lost
+  Frame F;                           //frame received (Frame.h)
+};
+
+struct FcPar
+{
+  bool Ok;                           //0 - timeout or lost
+  long Value;                        //parameter value, as Par[] of Menu.c
+};
+
+class FcLoop;
+class FcCounter;
+
+//-------------------------------- Port: -------------------------------------
+
+//Serial device shared by the counters on it (multi-drop bus):
+//frames go to the counter of their address, requests take the
+//port one at a time. Used by FcCounter only.
+
+class FcPort
+{
+public:
+  ~FcPort();
+
+private:
+  friend class FcLoop;
+  friend class FcCounter;
+
+  FcPort(FcLoop &l, const std::string &path, int baud);
+  bool Open(void);
+  void Lost(void);
+  void Event(uint32_t ev);
+  void Take(void);
+  bool Send(int addr, const char *cmd);
+  void Unlock(void);
+
+  struct Lock                        //co_await - take port
+  {
+    FcPort *P;
+    bool await_ready(void);
+    void await_suspend(std::coroutine_handle<> h) { P->LockQ.push_back(h); }
+    void await_resume(void) {}
+  };
+
+  FcLoop &L;
+  std::string Path;
+  int Baud;
+  int Fd;                            //-1 - lost
+  std::string Line;                  //line being received
+  bool Long;                         //line is over FRAME_MAX
+  bool Busy;                         //taken by request
+  std::deque<std::coroutine_handle<>> LockQ;
+  std::vector<FcCounter *> Counters;
+  uint64_t Retry;                    //reopen timer, 0 - none
+  uint64_t Reconnects;
+};
+
+//-------------------------------- Loop: -------------------------------------
+
+//One thread, one epoll loop for all devices. Coroutines are resumed
+//from the loop only, so frames of one read are all taken before any
+//request continues.
+
+class FcLoop
+{
+public:
+  FcLoop();
+  ~FcLoop();
+  void Run(void);                    //run until Stop()
+  void Stop(void);                   //stop Run(), any thread
+  void Spawn(FcTask<void> t);        //start top level task
+
+  struct Sleep                       //co_await FcLoop::Sleep{loop, ms}
+  {
+    FcLoop &L;
+    int Ms;
+    bool await_ready(void) { return(Ms <= 0); }
+    void await_suspend(std::coroutine_handle<> h)
+      { L.After(Ms, [this, h]{ L.Post(h); }); }
+    void await_resume(void) {}
+  };
+
+  uint64_t After(int ms, std::function<void()> f); //timer, returns id
+  void Cancel(uint64_t id);          //cancel timer
+  void Post(std::coroutine_handle<> h); //resume from loop
+
+private:
+  friend class FcPort;
+  friend class FcCounter;
+  int Ep;                            //epoll
+  int Ev;                            //stop eventfd
+  bool Quit;
+  uint64_t Ids;                      //last timer id
+  std::map<std::pair<int64_t, uint64_t>, std::function<void()>> Timers;
+  std::unordered_map<uint64_t, int64_t> TimerAt;
+  std::deque<std::coroutine_handle<>> Ready;
+  std::map<std::string, std::unique_ptr<FcPort>> Ports;
+
+  FcPort *GetPort(const std::string &path, int baud);
+  void PutPort(FcPort *p);
+};
+
+//------------------------------- Counter: -----------------------------------
+
+//Requests are commands of Rx_Int (Port.c), "#nn" prefixed for
+//addressed counters. All return Ok = 0 on timeout or lost device;
+//lost devices are reopened every FC_RECONN ms.
+//Get() and Set() are parameter commands ("Pnn", "Pnn=value"): Get()
+//changes nothing, Set() saves and restarts the counter if the value
+//is new and fails if the value is off the setup menu steps or the
+//setup menu is open on the counter.
+
+class FcCounter
+{
+public:
+  FcCounter(FcLoop &l, const std::string &dev, int addr = 0, int baud = FC_BAUD);
+  ~FcCounter();
+  bool Connected(void) const { return(P->Fd >= 0); }
+  uint64_t Reconnects(void) const { return(P->Reconnects); }
+  uint64_t Dropped(void) const { return(Drops); } //results not taken in time
+  void SetTimeout(int ms) { Tmo = ms; }
+
+  FcTask<FcReply> Read(void);        //display copy now ('R')
+  FcTask<FcReply> Id(void);          //identification ('?')
+  FcTask<bool> Key(char k);          //key letter: M, U, D, K, A, C
+  FcTask<bool> Sync(void);           //gate sync ('S')
+  FcTask<FcReply> Next(int ms = -1); //next result line (Out = Res), -1 - no timeout
+  FcTask<FcPar> Get(int par);        //read parameter ("Pnn")
+  FcTask<bool> Set(int par, long v); //set parameter ("Pnn=value")
+
+private:
+  friend class FcPort;
+
+  struct Wait                        //co_await - frame of type
+  {
+    FcCounter *C;
+    char Type;
+    int Ms;
+    FcReply R;
+    uint64_t Tm;
+    std::coroutine_handle<> H;
+    bool await_ready(void) { return(C->P->Fd < 0); }
+    void await_suspend(std::coroutine_handle<> h);
+    FcReply await_resume(void) { return(std::move(R)); }
+  };
+
+  FcLoop &L;
+  FcPort *P;
+  int Addr;
+  int Tmo;
+  uint64_t Drops;
+  std::vector<Wait *> Waits;
+  std::deque<Frame> Results;
+
+  void Deliver(const Frame &f);
+  void Fail(void);
+  FcTask<FcReply> Request(const char *cmd, char type);
+  FcTask<FcReply> Param(int par, const long *v);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
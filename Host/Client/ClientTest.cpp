@@ -0,0 +1,232 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of client library
+
+//Emulators (Emu1602 -p) are the counters. On one loop: ID, display
+//and gate are read from each of them at once, the gate is set by
+//parameter commands and result stream mode gives results of the new
+//gate, parameter queries between them do not restart the counter.
+//Then one emulator is killed and a new one is put on its device
+//link: requests fail, the device is reopened and works again.
+
+//Usage: ClientTest [-e emulator] [-n counters]
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Client.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define EMU      "Build/Emu1602"     //default emulator
+#define N_COUNT  3                   //default counters
+#define F_IN     "1e6"               //input frequency, Hz (1000 kHz shown)
+#define GATE     200                 //gate set, ms
+#define RESULTS  5                   //results taken in stream mode
+#define T_BOOT   5000                //splash and first result, ms
+#define T_TEST   60                  //whole test limit, s
+
+//------------------------------ Variables: ----------------------------------
+
+static int Fails;
+
+struct Emu
+{
+  pid_t Pid;
+  std::string Link;                  //device link to emulator pty
+};
+
+//------------------------------- Check: -------------------------------------
+
+static void Check(bool c, const char *what)
+{
+  if(c) return;
+  printf("FAILED: %s\n", what);
+  Fails++;
+}
+
+//------------------------------ Emulator: -----------------------------------
+
+//emulator on pty, its name is taken from stderr and linked
+
+static bool Start(const char *emu, Emu &e)
+{
+  int p[2];
+  if(pipe(p)) return(0);
+  fflush(stdout);                    //not written again by child
+  e.Pid = fork();
+  if(!e.Pid)
+  {
+    prctl(PR_SET_PDEATHSIG, SIGTERM); //not left running by failed test
+    dup2(p[1], 2);
+    close(p[0]);
+    close(p[1]);
+    if(!freopen("/dev/null", "w", stdout)) _exit(1);
+    execl(emu, emu, "-p", "-c", "0 fin " F_IN, (char *)nullptr);
+    _exit(1);
+  }
+  close(p[1]);
+  std::string s;
+  char c;
+  while(read(p[0], &c, 1) == 1 && c != '\n') s += c;
+  close(p[0]);                       //emulator writes nothing more
+  const char *pre = "Emu: UART at ";
+  if(e.Pid < 0 || s.compare(0, strlen(pre), pre)) return(0);
+  unlink(e.Link.c_str());
+  return(!symlink(s.c_str() + strlen(pre), e.Link.c_str()));
+}
+
+static void Kill(Emu &e)
+{
+  if(e.Pid <= 0) return;
+  kill(e.Pid, SIGTERM);
+  waitpid(e.Pid, nullptr, 0);
+  e.Pid = 0;
+}
+
+//-------------------------------- Tests: ------------------------------------
+
+//display after splash
+
+static FcTask<FcReply> Ready(FcLoop &l, FcCounter &c)
+{
+  FcReply r = {};
+  for(int t = 0; t < T_BOOT; t += 100)
+  {
+    r = co_await c.Read();
+    if(r.Ok && r.F.HasValue && r.F.Text.find("FC-510") == std::string::npos) break;
+    co_await FcLoop::Sleep{l, 100};
+  }
+  co_return r;
+}
+
+static FcTask<void> TestCounter(FcLoop &l, FcCounter &c, int &done)
+{
+  FcReply r = co_await c.Id();
+  Check(r.Ok && !r.F.Text.compare(0, 6, "FC-510"), "ID");
+  r = co_await Ready(l, c);
+  Check(r.Ok && r.F.HasValue && fabs(r.F.Value() - 1000) < 1E-3, "display value");
+
+  FcPar g = co_await c.Get(FC_GATE);
+  Check(g.Ok && g.Value == 1000, "get gate");
+  Check(co_await c.Set(FC_GATE, GATE), "set gate");
+  g = co_await c.Get(FC_GATE);
+  Check(g.Ok && g.Value == GATE, "gate set");
+  Check(!co_await c.Set(FC_GATE, GATE + 1), "gate off step grid");
+  g = co_await c.Get(FC_GATE);
+  Check(g.Ok && g.Value == GATE, "gate kept");
+  FcPar m = co_await c.Get(FC_MODE);
+  Check(m.Ok && m.Value == 0, "get mode");
+
+  //result stream: results of gate period
+  Check(co_await c.Set(FC_OUT, 1), "set stream mode");
+  FcReply p = {};
+  int n = 0;
+  for(int i = 0; i < RESULTS + 2; i++)
+  {
+    r = co_await c.Next(T_BOOT);
+    if(!r.Ok) break;
+    g = co_await c.Get(FC_GATE);     //query keeps the gates running
+    if(!g.Ok || g.Value != GATE) break;
+    if(i >= 2)                       //first ones may be of old gate
+    {
+      long dt = r.F.Ms - p.F.Ms;     //gate and result processing
+      n += r.F.Mode == 0 && fabs(r.F.Value() - 1000) < 1E-6 && r.F.Seq == p.F.Seq + 1 &&
+           dt >= GATE && dt < 2 * GATE;
+    }
+    p = r;
+  }
+  Check(n == RESULTS, "stream results");
+  Check(co_await c.Set(FC_OUT, 0), "set display mode");
+  done++;
+}
+
+//device is lost and found again on its link
+
+static FcTask<void> TestReconnect(FcLoop &l, FcCounter &c, Emu &e, const char *emu,
+                                  int &done)
+{
+  Kill(e);
+  FcReply r = co_await c.Read();
+  Check(!r.Ok && !c.Connected(), "request to lost device");
+  Check(Start(emu, e), "emulator restart");
+  for(int t = 0; t < 3 * FC_RECONN && !c.Connected(); t += 100)
+    co_await FcLoop::Sleep{l, 100};
+  Check(c.Connected() && c.Reconnects() == 1, "reconnect");
+  r = co_await Ready(l, c);
+  Check(r.Ok && r.F.HasValue, "display after reconnect");
+  done++;
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  const char *emu = EMU;
+  int count = N_COUNT;
+  int o;
+  while((o = getopt(argc, argv, "e:n:")) != -1)
+  {
+    if(o == 'e') emu = optarg;
+    else if(o == 'n') count = atoi(optarg);
+    else { fprintf(stderr, "Usage: ClientTest [-e emulator] [-n counters]\n"); return(2); }
+  }
+  char dir[] = "/tmp/ClientTestXXXXXX";
+  if(!mkdtemp(dir) || count < 1) { Check(0, "temp directory"); return(1); }
+  signal(SIGPIPE, SIG_IGN);
+  alarm(T_TEST);                     //hung test fails
+
+  std::vector<Emu> e(count);
+  for(int i = 0; i < count; i++)
+  {
+    e[i].Link = std::string(dir) + "/fc" + std::to_string(i);
+    Check(Start(emu, e[i]), "emulator start");
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  {
+    FcLoop l;
+    std::vector<std::unique_ptr<FcCounter>> c;
+    for(int i = 0; i < count; i++)
+      c.emplace_back(new FcCounter(l, e[i].Link));
+    int done = 0;
+    for(int i = 0; i < count; i++)
+      l.Spawn(TestCounter(l, *c[i], done));
+    l.After(T_TEST * 1000, [&]{ l.Stop(); });
+    auto wait = [&](int n) -> FcTask<void>
+    {
+      while(done < n) co_await FcLoop::Sleep{l, 50};
+      l.Stop();
+    };
+    l.Spawn(wait(count));
+    l.Run();
+    Check(done == count, "counters done");
+    l.Spawn(TestReconnect(l, *c[0], e[0], emu, done));
+    l.Spawn(wait(count + 1));
+    l.Run();
+    Check(done == count + 1, "reconnect done");
+    for(auto &p : c) Check(!p->Dropped(), "results dropped");
+  }
+  double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("%d counters on one loop: %.1f s\n", count, dt);
+
+  for(auto &p : e)
+  {
+    Kill(p);
+    unlink(p.Link.c_str());
+  }
+  rmdir(dir);
+  printf(Fails? "FAILED\n" : "PASSED\n");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
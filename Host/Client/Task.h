@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host client library: coroutine task, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef TaskH
+#define TaskH
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+//------------------------------- Task: --------------------------------------
+
+//Lazy coroutine: runs when awaited, result is returned by co_await,
+//the awaiting coroutine is resumed at once when the task returns.
+//Top level tasks are started by FcLoop::Spawn().
+
+template<class T> class FcTask;
+
+template<class T> struct FcPromiseBase
+{
+  std::coroutine_handle<> Next;      //awaiting coroutine
+
+  struct Final
+  {
+    bool await_ready(void) noexcept { return(0); }
+    template<class P> std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+    {
+      std::coroutine_handle<> n = h.promise().Next;
+      return(n? n : std::noop_coroutine());
+    }
+    void await_resume(void) noexcept {}
+  };
+
+  std::suspend_always initial_suspend(void) noexcept { return(std::suspend_always()); }
+  Final final_suspend(void) noexcept { return(Final()); }
+  void unhandled_exception(void) { std::terminate(); }
+};
+
+template<class T> struct FcPromise : FcPromiseBase<T>
+{
+  T Value;
+  FcTask<T> get_return_object(void);
+  void return_value(T v) { Value = std::move(v); }
+  T Result(void) { return(std::move(Value)); }
+};
+
+template<> struct FcPromise<void> : FcPromiseBase<void>
+{
+  FcTask<void> get_return_object(void);
+  void return_void(void) {}
+  void Result(void) {}
+};
+
+template<class T> class FcTask
+{
+public:
+  using promise_type = FcPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit FcTask(Handle h) : H(h) {}
+  FcTask(FcTask &&t) noexcept : H(std::exchange(t.H, nullptr)) {}
+  FcTask(const FcTask &) = delete;
+  FcTask &operator=(const FcTask &) = delete;
+  ~FcTask() { if(H) H.destroy(); }
+
+  bool await_ready(void) const { return(!H || H.done()); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> c)
+  {
+    H.promise().Next = c;
+    return(H);
+  }
+  T await_resume(void) { return(H.promise().Result()); }
+
+private:
+  Handle H;
+};
+
+template<class T> inline FcTask<T> FcPromise<T>::get_return_object(void)
+{
+  return(FcTask<T>(FcTask<T>::Handle::from_promise(*this)));
+}
+
+inline FcTask<void> FcPromise<void>::get_return_object(void)
+{
+  return(FcTask<void>(FcTask<void>::Handle::from_promise(*this)));
+}
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,400 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: columnar result files
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Col.h"
+#include "../Capture/Frame.h"
+#include "Count.h"                   //MODE_xxx of firmware
+#include "Menu.h"
+#include "Meter.h"
+#include "FwTables.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define COL_BLK 0x314B4C42           //block head magic "BLK1"
+
+static const char Str_Head[8] = {'F', 'C', '5', '1', '0', 'C', 'O', 'L'};
+static const char Str_Idx[8]  = {'F', 'C', '5', '1', '0', 'I', 'D', 'X'};
+
+//------------------------------ Helpers: ------------------------------------
+
+static size_t Pad(size_t n)
+{
+  return((n + 7) & ~(size_t)7);
+}
+
+//column offsets in block of rows
+
+struct Layout
+{
+  size_t Time, Mant, Ms, Mode, Dec, Size;
+};
+
+static Layout Cols(size_t rows)
+{
+  Layout l = {};
+  size_t p = sizeof(ColBlockHead);
+  l.Time = p; p += Pad(rows * sizeof(int64_t));
+  l.Mant = p; p += Pad(rows * sizeof(int64_t));
+  l.Ms = p; p += Pad(rows * sizeof(uint32_t));
+  l.Mode = p; p += Pad(rows);
+  l.Dec = p; p += Pad(rows);
+  l.Size = p;
+  return(l);
+}
+
+static bool Put(int fd, const void *d, size_t n, uint64_t off)
+{
+  const uint8_t *p = (const uint8_t *)d;
+  while(n)
+  {
+    ssize_t w = pwrite(fd, p, n, off);
+    if(w <= 0) return(0);
+    p += w; off += w; n -= w;
+  }
+  return(1);
+}
+
+//--------------------------------- Row: -------------------------------------
+
+double ColRow::Value(void) const
+{
+  static const double P10[] = {1E0, 1E1, 1E2, 1E3, 1E4, 1E5, 1E6, 1E7, 1E8, 1E9,
+                               1E10, 1E11, 1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18};
+  return((double)Mant / P10[Dec < 19? Dec : 18]);
+}
+
+//------------------------------- Writer: ------------------------------------
+
+ColWriter::ColWriter()
+{
+  Fd = -1;
+  End = NRows = 0;
+  TLast = LLONG_MIN;
+}
+
+ColWriter::~ColWriter()
+{
+  Close();
+}
+
+bool ColWriter::Open(const std::string &path)
+{
+  Close();
+  Fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if(Fd < 0) return(0);
+  Idx.clear();
+  Buf.clear();
+  NRows = 0;
+  TLast = LLONG_MIN;
+  struct stat st;
+  if(fstat(Fd, &st)) { close(Fd); Fd = -1; return(0); }
+  if(!st.st_size)                    //new file
+  {
+    ColHead h = {};
+    memcpy(h.Magic, Str_Head, sizeof(h.Magic));
+    h.Version = COL_VERSION;
+    End = sizeof(h);
+    if(Put(Fd, &h, sizeof(h), 0)) return(1);
+    close(Fd); Fd = -1;
+    return(0);
+  }
+  ColReader r;                       //continue file: blocks are kept
+  if(!r.Open(path)) { close(Fd); Fd = -1; return(0); }
+  Idx = r.Idx;
+  End = r.End;
+  NRows = r.NRows;
+  if(NRows) TLast = r.Last();
+  r.Close();
+  if(ftruncate(Fd, End)) { close(Fd); Fd = -1; return(0); }
+  return(1);
+}
+
+bool ColWriter::Add(const ColRow &r)
+{
+  if(Fd < 0 || r.Time < TLast) return(0);
+  TLast = r.Time;
+  Buf.push_back(r);
+  if(Buf.size() < COL_BLOCK) return(1);
+  return(Block());
+}
+
+//block is written at once, so block torn by kill is seen by its size
+
+bool ColWriter::Block(void)
+{
+  if(Buf.empty()) return(1);
+  size_t n = Buf.size();
+  Layout l = Cols(n);
+  Out.assign(l.Size, 0);
+  uint8_t *b = Out.data();
+  ColBlockHead h = {COL_BLK, (uint32_t)n, Buf.front().Time, Buf.back().Time, l.Size};
+  memcpy(b, &h, sizeof(h));
+  int64_t *time = (int64_t *)(b + l.Time), *mant = (int64_t *)(b + l.Mant);
+  uint32_t *ms = (uint32_t *)(b + l.Ms);
+  for(size_t i = 0; i < n; i++)
+  {
+    time[i] = Buf[i].Time;
+    mant[i] = Buf[i].Mant;
+    ms[i] = Buf[i].Ms;
+    b[l.Mode + i] = Buf[i].Mode;
+    b[l.Dec + i] = Buf[i].Dec;
+  }
+  if(!Put(Fd, b, l.Size, End)) return(0);
+  Idx.push_back({h.T0, h.T1, End, NRows, n});
+  End += l.Size;
+  NRows += n;
+  Buf.clear();
+  return(1);
+}
+
+bool ColWriter::Close(void)
+{
+  if(Fd < 0) return(1);
+  bool ok = Block();
+  ColTrailer t = {End, Idx.size(), NRows, {}};
+  memcpy(t.Magic, Str_Idx, sizeof(t.Magic));
+  ok = ok && Put(Fd, Idx.data(), Idx.size() * sizeof(ColIndex), End);
+  ok = ok && Put(Fd, &t, sizeof(t), End + Idx.size() * sizeof(ColIndex));
+  if(close(Fd)) ok = 0;
+  Fd = -1;
+  return(ok);
+}
+
+//------------------------------- Reader: ------------------------------------
+
+static ColRow Take(const ColReader::Block &c, size_t k)
+{
+  ColRow r = {};
+  r.Time = c.Time[k];
+  r.Mant = c.Mant[k];
+  r.Ms = c.Ms[k];
+  r.Mode = c.Mode[k];
+  r.Dec = c.Dec[k];
+  return(r);
+}
+
+ColReader::ColReader()
+{
+  Map = nullptr;
+  Size = 0;
+  HasIdx = 0;
+  NRows = End = 0;
+}
+
+ColReader::~ColReader()
+{
+  Close();
+}
+
+void ColReader::Close(void)
+{
+  if(Map) munmap((void *)Map, Size);
+  Map = nullptr;
+  Size = 0;
+  Idx.clear();
+  NRows = End = 0;
+}
+
+bool ColReader::Open(const std::string &path)
+{
+  Close();
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if(fd < 0) return(0);
+  struct stat st;
+  if(fstat(fd, &st) || st.st_size < (off_t)sizeof(ColHead)) { close(fd); return(0); }
+  void *m = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(m == MAP_FAILED) return(0);
+  Map = (const uint8_t *)m;
+  Size = st.st_size;
+  ColHead h;
+  memcpy(&h, Map, sizeof(h));
+  if(memcmp(h.Magic, Str_Head, sizeof(h.Magic)) || h.Version != COL_VERSION || h.Flags)
+    { Close(); return(0); }
+
+  //index:
+  ColTrailer t;
+  HasIdx = 0;
+  if(Size >= sizeof(ColHead) + sizeof(t))
+  {
+    memcpy(&t, Map + Size - sizeof(t), sizeof(t));
+    HasIdx = !memcmp(t.Magic, Str_Idx, sizeof(t.Magic)) &&
+             t.Index >= sizeof(ColHead) &&
+             t.Index + t.Blocks * sizeof(ColIndex) + sizeof(t) == Size;
+  }
+  if(!HasIdx) return(Scan());        //writer was killed
+  Idx.resize(t.Blocks);
+  memcpy(Idx.data(), Map + t.Index, t.Blocks * sizeof(ColIndex));
+  NRows = t.Rows;
+  End = t.Index;
+  return(1);
+}
+
+//index from block heads, torn last block is dropped
+
+bool ColReader::Scan(void)
+{
+  uint64_t p = sizeof(ColHead);
+  while(p + sizeof(ColBlockHead) <= Size)
+  {
+    ColBlockHead h;
+    memcpy(&h, Map + p, sizeof(h));
+    if(h.Magic != COL_BLK || !h.Rows || h.Size != Cols(h.Rows).Size ||
+       p + h.Size > Size) break;
+    Idx.push_back({h.T0, h.T1, p, NRows, h.Rows});
+    NRows += h.Rows;
+    p += h.Size;
+  }
+  End = p;
+  return(1);
+}
+
+ColReader::Block ColReader::Get(size_t b) const
+{
+  const ColIndex &e = Idx[b];
+  Layout l = Cols(e.Rows);
+  const uint8_t *p = Map + e.Offset;
+  Block c;
+  c.Rows = e.Rows;
+  c.Time = (const int64_t *)(p + l.Time);
+  c.Mant = (const int64_t *)(p + l.Mant);
+  c.Ms = (const uint32_t *)(p + l.Ms);
+  c.Mode = p + l.Mode;
+  c.Dec = p + l.Dec;
+  return(c);
+}
+
+int64_t ColReader::First(void) const
+{
+  return(Idx.empty()? 0 : Idx.front().T0);
+}
+
+int64_t ColReader::Last(void) const
+{
+  return(Idx.empty()? 0 : Idx.back().T1);
+}
+
+uint64_t ColReader::Find(int64_t t) const
+{
+  auto e = std::partition_point(Idx.begin(), Idx.end(),
+                                [t](const ColIndex &x) { return(x.T1 < t); });
+  if(e == Idx.end()) return(NRows);
+  Block c = Get(e - Idx.begin());
+  return(e->Row + (std::lower_bound(c.Time, c.Time + c.Rows, t) - c.Time));
+}
+
+size_t ColReader::BlockOf(uint64_t i) const
+{
+  auto e = std::partition_point(Idx.begin(), Idx.end(),
+                                [i](const ColIndex &x) { return(x.Row + x.Rows <= i); });
+  return(e - Idx.begin());
+}
+
+ColRow ColReader::Row(uint64_t i) const
+{
+  size_t b = BlockOf(i);
+  Block c = Get(b);
+  return(Take(c, i - Idx[b].Row));
+}
+
+size_t ColReader::Read(int64_t t0, int64_t t1, uint64_t step, std::vector<ColRow> &out) const
+{
+  out.clear();
+  if(!step) step = 1;
+  uint64_t a = Find(t0), e = Find(t1);
+  if(a >= e) return(0);
+  out.reserve((e - a + step - 1) / step);
+  size_t b = BlockOf(a);
+  Block c = Get(b);
+  for(uint64_t i = a; i < e; i += step)
+  {
+    if(i >= Idx[b].Row + Idx[b].Rows)  //next blocks, skipped ones not touched
+    {
+      b = BlockOf(i);
+      c = Get(b);
+    }
+    size_t k = i - Idx[b].Row;
+    out.push_back(Take(c, k));
+  }
+  return(out.size());
+}
+
+//------------------------------ Convert: ------------------------------------
+
+//display copy starts with name: not followed by a letter,
+//so setup menus ("Pre", "Avg", "Fast") are not taken
+
+static bool IsName(const std::string &t, const char *n, size_t len)
+{
+  return(t.size() > len && !t.compare(0, len, n, len) && !isalpha((unsigned char)t[len]));
+}
+
+//mode of display copy by the longest name it starts with, as Show_Main():
+//"f" for frequency +/- IF, "FA", "PA" for auto mode (mode shown is
+//taken, as Count_GetMode() of result lines); -1 - not a measured value
+
+static int DispMode(const std::string &t)
+{
+  if(IsName(t, "FA", 2)) return(MODE_F);
+  if(IsName(t, "PA", 2)) return(MODE_P);
+  if(IsName(t, "f", 1)) return(MODE_FIF);
+  int m = -1;
+  size_t len = 0;
+  for(int i = 0; i < MODES; i++)
+  {
+    size_t n = strlen(FwStr_V[i]);
+    while(n && FwStr_V[i][n - 1] == ' ') n--;
+    if(n > len && IsName(t, FwStr_V[i], n)) { m = i; len = n; }
+  }
+  return(m);
+}
+
+uint64_t Col_FromCap(FILE *in, ColWriter &w, uint64_t *skip)
+{
+  char s[256];
+  uint64_t n = 0, k = 0;
+  while(fgets(s, sizeof(s), in))
+  {
+    long long t;
+    char c;
+    int p;
+    Frame f;
+    s[strcspn(s, "\r\n")] = 0;
+    if(sscanf(s, "%lld %c%n", &t, &c, &p) != 2 || s[p] != ' ' ||
+       !f.Parse(s + p + 1, strlen(s + p + 1)) || f.Type != c || !f.HasValue || f.Dec > 18)
+      { k++; continue; }
+    ColRow r = {};
+    if(c == FRAME_RES)
+    {
+      r.Ms = f.Ms;
+      r.Mode = f.Mode;
+    }
+    else if(c == FRAME_DISP)
+    {
+      int m = DispMode(f.Text);
+      if(m < 0) { k++; continue; }   //menus, hidden name
+      r.Mode = m;
+    }
+    else { k++; continue; }
+    r.Time = t;
+    r.Dec = f.Dec;
+    r.Mant = f.Mant;
+    if(w.Add(r)) n++; else k++;
+  }
+  if(skip) *skip = k;
+  return(n);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: columnar result files, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef ColH
+#define ColH
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//----------------------------- Constants: -----------------------------------
+
+#define COL_VERSION 1                //file format version
+#define COL_BLOCK   4096             //rows per block
+
+//------------------------------- Format: ------------------------------------
+
+//File:    head, blocks, index, trailer.
+//Block:   block head, then columns of the block rows, each column
+//         padded to 8 bytes: Time, Mant, Ms, Mode, Dec.
+//Index:   one entry per block (sparse time index), written on close.
+//Without index (writer killed) blocks are found by their heads,
+//no column data is read. Rows are in non-decreasing time order.
+//Numbers are little endian, as the host.
+
+struct ColHead
+{
+  char Magic[8];                     //"FC510COL"
+  uint32_t Version;                  //COL_VERSION
+  uint32_t Flags;                    //0, files with flags are not read
+  uint64_t Reserved[2];
+};
+
+struct ColBlockHead
+{
+  uint32_t Magic;                    //COL_BLK
+  uint32_t Rows;                     //rows in block
+  int64_t T0;                        //first row time
+  int64_t T1;                        //last row time
+  uint64_t Size;                     //block size with head
+};
+
+struct ColIndex
+{
+  int64_t T0;                        //first row time
+  int64_t T1;                        //last row time
+  uint64_t Offset;                   //block offset in file
+  uint64_t Row;                      //first row number
+  uint64_t Rows;                     //rows in block
+};
+
+struct ColTrailer
+{
+  uint64_t Index;                    //index offset in file
+  uint64_t Blocks;                   //index entries
+  uint64_t Rows;                     //total rows
+  char Magic[8];                     //"FC510IDX"
+};
+
+//-------------------------------- Row: --------------------------------------
+
+struct ColRow
+{
+  int64_t Time;                      //capture time, ns (Capture.h)
+  uint32_t Ms;                       //counter result time, ms, 0 - display copy
+  uint8_t Mode;                      //result mode (Count.h)
+  uint8_t Dec;                       //scale: value digits after the point
+  int64_t Mant;                      //value mantissa, display units
+
+  double Value(void) const;          //value as double
+};
+
+//------------------------------- Writer: ------------------------------------
+
+//Rows are collected in block and written by full blocks.
+//Existing file is continued: its index is dropped and written
+//again on close.
+
+class ColWriter
+{
+public:
+  ColWriter();
+  ~ColWriter();
+  bool Open(const std::string &path); //0 - cannot open or bad file
+  bool Add(const ColRow &r);         //add row, 0 - row is earlier than last
+  bool Close(void);                  //write last block and index
+  uint64_t Rows(void) const { return(NRows + Buf.size()); }
+
+private:
+  int Fd;
+  uint64_t End;                      //end of blocks
+  uint64_t NRows;                    //rows written
+  int64_t TLast;                     //last row time
+  std::vector<ColIndex> Idx;
+  std::vector<ColRow> Buf;           //block being collected
+  std::vector<uint8_t> Out;          //block image
+
+  bool Block(void);
+};
+
+//------------------------------- Reader: ------------------------------------
+
+//File is mapped, columns are used in place. Time window is found by
+//binary search in index, then in Time column of one block.
+
+class ColReader
+{
+public:
+  struct Block                       //columns of one block
+  {
+    size_t Rows;
+    const int64_t *Time;
+    const int64_t *Mant;
+    const uint32_t *Ms;
+    const uint8_t *Mode;
+    const uint8_t *Dec;
+  };
+
+  ColReader();
+  ~ColReader();
+  bool Open(const std::string &path); //0 - cannot open or bad file
+  void Close(void);
+  bool Indexed(void) const { return(HasIdx); }
+  uint64_t Rows(void) const { return(NRows); }
+  size_t Blocks(void) const { return(Idx.size()); }
+  const ColIndex &Index(size_t b) const { return(Idx[b]); }
+  Block Get(size_t b) const;
+  int64_t First(void) const;         //first row time
+  int64_t Last(void) const;          //last row time
+  uint64_t Find(int64_t t) const;    //first row at or after t
+  ColRow Row(uint64_t i) const;
+  //rows of time window [t0, t1), every step row
+  size_t Read(int64_t t0, int64_t t1, uint64_t step, std::vector<ColRow> &out) const;
+
+private:
+  friend class ColWriter;
+  const uint8_t *Map;
+  size_t Size;
+  bool HasIdx;                       //index read from file
+  uint64_t NRows;
+  uint64_t End;                      //end of blocks
+  std::vector<ColIndex> Idx;
+
+  bool Scan(void);
+  size_t BlockOf(uint64_t i) const;
+};
+
+//------------------------------ Convert: ------------------------------------
+
+//result lines and display copies of measured values of capture
+//file (Capture.h) to writer: display copies give the value shown,
+//the mode by its name (Str_V of Menu.c, auto mode as result lines)
+//and Ms = 0; each redraw is a row, so hold blink and scale changes
+//repeat the value. Returns rows added, skip - lines not taken.
+uint64_t Col_FromCap(FILE *in, ColWriter &w, uint64_t *skip = nullptr);
+
+//----------------------------------------------------------------------------
+
+#endif
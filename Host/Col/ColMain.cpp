@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: columnar result files tool
+
+//Usage: Col -c file.col [capture ...]  convert capture files
+//                                      (stdin without files), file is continued
+//       Col -i file.col                file info
+//       Col [-f s] [-t s] [-n step] file.col
+//                                      print rows "ns ms mode value"
+//-f s, -t s  time window, seconds from first row
+//-n step     every step row (decimation)
+
+//----------------------------------------------------------------------------
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "Col.h"
+
+//------------------------------ Helpers: ------------------------------------
+
+static void Usage(void)
+{
+  fprintf(stderr, "Usage: Col -c file.col [capture ...]\n"
+                  "       Col -i file.col\n"
+                  "       Col [-f s] [-t s] [-n step] file.col\n");
+  exit(2);
+}
+
+//value with all its digits, as result line
+
+static void PrintRow(const ColRow &r)
+{
+  uint64_t m = r.Mant < 0? -(uint64_t)r.Mant : r.Mant;
+  uint64_t p = 1;
+  for(int i = 0; i < r.Dec; i++) p *= 10;
+  printf("%" PRId64 " %" PRIu32 " %u %s%" PRIu64, r.Time, r.Ms, r.Mode,
+         r.Mant < 0? "-" : "", m / p);
+  if(r.Dec) printf(".%0*" PRIu64, r.Dec, m % p);
+  printf("\n");
+}
+
+static int Convert(const char *col, char **caps, int n)
+{
+  ColWriter w;
+  if(!w.Open(col)) { fprintf(stderr, "Col: cannot open %s\n", col); return(1); }
+  uint64_t rows = 0, skip = 0, k;
+  if(!n) rows = Col_FromCap(stdin, w, &skip);
+  for(int i = 0; i < n; i++)
+  {
+    FILE *f = fopen(caps[i], "r");
+    if(!f) { perror(caps[i]); continue; }
+    rows += Col_FromCap(f, w, &k);
+    skip += k;
+    fclose(f);
+  }
+  if(!w.Close()) { fprintf(stderr, "Col: cannot write %s\n", col); return(1); }
+  fprintf(stderr, "%" PRIu64 " rows added, %" PRIu64 " lines skipped\n", rows, skip);
+  return(0);
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  const char *col = nullptr;
+  bool info = 0, win0 = 0, win1 = 0;
+  double f = 0, t = 0;
+  uint64_t step = 1;
+  int o;
+  while((o = getopt(argc, argv, "c:if:t:n:")) != -1)
+  {
+    switch(o)
+    {
+    case 'c': col = optarg; break;
+    case 'i': info = 1; break;
+    case 'f': f = atof(optarg); win0 = 1; break;
+    case 't': t = atof(optarg); win1 = 1; break;
+    case 'n': step = strtoull(optarg, nullptr, 10); break;
+    default: Usage();
+    }
+  }
+  if(col) return(Convert(col, argv + optind, argc - optind));
+  if(optind != argc - 1) Usage();
+
+  ColReader r;
+  if(!r.Open(argv[optind])) { fprintf(stderr, "Col: bad file %s\n", argv[optind]); return(1); }
+  if(info)
+  {
+    printf("rows %" PRIu64 ", blocks %zu, index %s\n", r.Rows(),
+           r.Blocks(), r.Indexed()? "yes" : "rebuilt");
+    if(r.Rows())
+      printf("time %" PRId64 " .. %" PRId64 " ns, %.3f s\n", r.First(), r.Last(),
+             (r.Last() - r.First()) * 1E-9);
+    return(0);
+  }
+  int64_t t0 = win0? r.First() + (int64_t)(f * 1E9) : INT64_MIN;
+  int64_t t1 = win1? r.First() + (int64_t)(t * 1E9) : INT64_MAX;
+  if(!step) step = 1;
+  for(uint64_t i = r.Find(t0), e = r.Find(t1); i < e; i += step)
+    PrintRow(r.Row(i));
+  return(0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of columnar result files
+
+//Rows are written, read back and searched by time windows against
+//the rows kept in memory. Then the file is continued, cut as by
+//killed writer, and result lines and display copies of a capture
+//file are converted.
+
+//Usage: ColTest [-r rows]
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include "Col.h"
+#include "Count.h"                   //MODE_xxx of firmware
+
+//----------------------------- Constants: -----------------------------------
+
+#define N_ROWS  100000               //default rows
+#define N_MORE  5000                 //rows added to continued file
+#define N_WIN   1000                 //time windows checked
+
+//------------------------------ Variables: ----------------------------------
+
+static int Fails;
+
+//------------------------------- Check: -------------------------------------
+
+static void Check(bool c, const char *what)
+{
+  if(c) return;
+  printf("FAILED: %s\n", what);
+  Fails++;
+}
+
+static bool Same(const ColRow &a, const ColRow &b)
+{
+  return(a.Time == b.Time && a.Ms == b.Ms && a.Mode == b.Mode && a.Dec == b.Dec &&
+         a.Mant == b.Mant);
+}
+
+//-------------------------------- Rows: -------------------------------------
+
+//1 s gate results with capture jitter, equal times and gaps
+
+static std::vector<ColRow> Rows(size_t n, int64_t t, std::mt19937_64 &g)
+{
+  std::vector<ColRow> v(n);
+  for(size_t i = 0; i < n; i++)
+  {
+    int k = g() % 100;
+    t += k == 0? 0 : k == 1? 3600000000000LL : 1000000000 + (int64_t)(g() % 2000000) - 1000000;
+    ColRow &r = v[i];
+    r.Time = t;
+    r.Ms = (uint32_t)(t / 1000000);
+    r.Mode = g() % 15;
+    r.Dec = g() % 10;
+    r.Mant = (int64_t)(g() % 100000000000000LL) - 50000000000000LL;
+  }
+  return(v);
+}
+
+static bool Write(const std::string &path, const std::vector<ColRow> &v, size_t a, size_t e)
+{
+  ColWriter w;
+  if(!w.Open(path)) return(0);
+  for(size_t i = a; i < e; i++)
+    if(!w.Add(v[i])) return(0);
+  return(w.Close());
+}
+
+//first row at or after t
+
+static uint64_t Find(const std::vector<ColRow> &v, int64_t t)
+{
+  return(std::partition_point(v.begin(), v.end(),
+                              [t](const ColRow &r) { return(r.Time < t); }) - v.begin());
+}
+
+//------------------------------- Tests: -------------------------------------
+
+static void TestFile(const std::string &dir, size_t n)
+{
+  std::mt19937_64 g(510);
+  std::vector<ColRow> v = Rows(n, 1700000000000000000LL, g);
+  std::string path = dir + "/test.col";
+
+  auto c0 = std::chrono::steady_clock::now();
+  Check(Write(path, v, 0, n), "write");
+  auto c1 = std::chrono::steady_clock::now();
+
+  ColReader r;
+  Check(r.Open(path) && r.Indexed(), "open");
+  Check(r.Rows() == n && r.Blocks() == (n + COL_BLOCK - 1) / COL_BLOCK, "rows");
+  Check(r.First() == v.front().Time && r.Last() == v.back().Time, "first, last");
+  bool same = 1;
+  for(size_t i = 0; i < n; i++) same = same && Same(r.Row(i), v[i]);
+  Check(same, "rows read");
+  Check(r.Find(INT64_MIN) == 0 && r.Find(INT64_MAX) == n, "find ends");
+
+  //time windows:
+  std::vector<ColRow> out;
+  auto c2 = std::chrono::steady_clock::now();
+  for(int k = 0; k < N_WIN; k++)
+  {
+    int64_t t0 = v[g() % n].Time + (g() % 3) - 1;
+    int64_t t1 = t0 + (int64_t)(g() % 100000) * 1000000000;
+    uint64_t step = 1 + g() % 20;
+    uint64_t a = Find(v, t0), e = Find(v, t1);
+    Check(r.Find(t0) == a && r.Find(t1) == e, "window find");
+    r.Read(t0, t1, step, out);
+    bool ok = out.size() == (e > a? (e - a + step - 1) / step : 0);
+    for(size_t i = 0; ok && i < out.size(); i++) ok = Same(out[i], v[a + i * step]);
+    Check(ok, "window read");
+  }
+  auto c3 = std::chrono::steady_clock::now();
+  r.Close();
+
+  //continued file:
+  std::vector<ColRow> m = Rows(N_MORE, v.back().Time, g);
+  v.insert(v.end(), m.begin(), m.end());
+  Check(Write(path, v, n, v.size()), "continue");
+  Check(r.Open(path) && r.Indexed() && r.Rows() == v.size(), "continued rows");
+  Check(Same(r.Row(n - 1), v[n - 1]) && Same(r.Row(n), v[n]) &&
+        Same(r.Row(v.size() - 1), v.back()), "continued rows read");
+  {
+    ColWriter w;
+    ColRow x = v.back();
+    x.Time--;
+    Check(w.Open(path) && !w.Add(x) && w.Close(), "earlier row");
+  }
+
+  //killed writer: no index, last block torn
+  uint64_t last = r.Index(r.Blocks() - 1).Offset;
+  uint64_t keep = r.Index(r.Blocks() - 1).Row;
+  r.Close();
+  Check(!truncate(path.c_str(), last + 100), "truncate");
+  Check(r.Open(path) && !r.Indexed() && r.Rows() == keep, "no index");
+  Check(Same(r.Row(keep - 1), v[keep - 1]), "no index rows read");
+  r.Close();
+  Check(Write(path, v, keep, keep + 1), "continue without index");
+  Check(r.Open(path) && r.Indexed() && r.Rows() == keep + 1 &&
+        Same(r.Row(keep), v[keep]), "index rebuilt");
+
+  double tw = std::chrono::duration<double>(c1 - c0).count();
+  double tr = std::chrono::duration<double>(c3 - c2).count();
+  printf("%zu rows: write %.0f rows/s, %d windows read in %.3f s\n", n, n / tw, N_WIN, tr);
+}
+
+static void TestConvert(const std::string &dir)
+{
+  std::string cap = dir + "/pts_1.cap", path = dir + "/conv.col";
+  FILE *f = fopen(cap.c_str(), "w");
+  if(!f) { Check(0, "capture file"); return; }
+  fprintf(f, "1000 I FC-510 V2.1\n"
+             "2000 D F 1000.00000 kHz\n"
+             "3000 R 1,1000,0,10000.000012345\n"
+             "4000 R 2,2000,10,-0.000123\n"
+             "5000 ? 3,3000,0,1x\n"
+             "3500 R 3,3000,0,1.5\n"
+             "6000 R $074,4000,1,2.25\n"
+             "7000 D 00042 FHw2000.0000 kHz\n"
+             "8000 D PA   0.200000 ms\n"
+             "9000 D Pre      256    \n"
+             "9100 D FA---.------ kHz\n"
+             "9200 D    2000.0000 kHz\n");
+  fclose(f);
+  f = fopen(cap.c_str(), "r");
+  ColWriter w;
+  uint64_t skip;
+  Check(w.Open(path) && Col_FromCap(f, w, &skip) == 6 && skip == 6 && w.Close(), "convert");
+  fclose(f);
+  ColReader r;
+  Check(r.Open(path) && r.Rows() == 6, "converted rows");
+  if(r.Rows() != 6) return;
+  ColRow d = r.Row(0), a = r.Row(1), b = r.Row(2), c = r.Row(3);
+  Check(a.Time == 3000 && a.Ms == 1000 && a.Mode == 0 && a.Mant == 10000000012345LL &&
+        a.Dec == 9 && fabs(a.Value() - 10000.000012345) < 1E-9, "converted row");
+  Check(b.Mode == 10 && b.Mant == -123 && b.Dec == 6 && c.Time == 6000 && c.Mode == 1 &&
+        c.Value() == 2.25, "converted rows read");
+  Check(d.Time == 2000 && d.Ms == 0 && d.Mode == MODE_F && d.Mant == 100000000 &&
+        d.Dec == 5, "display copy");
+  ColRow h = r.Row(4), p = r.Row(5);
+  Check(h.Mode == MODE_FHW && h.Value() == 2000 && p.Mode == MODE_P && p.Mant == 200000 &&
+        p.Dec == 6, "display copies of modes");
+}
+
+//file of other flags (raw counts of earlier builds) is not taken
+
+static void TestFlags(const std::string &dir)
+{
+  std::string path = dir + "/flags.col";
+  ColHead h = {};
+  memcpy(h.Magic, "FC510COL", sizeof(h.Magic));
+  h.Version = COL_VERSION;
+  h.Flags = 1;
+  FILE *f = fopen(path.c_str(), "w");
+  if(!f) { Check(0, "flags file"); return; }
+  fwrite(&h, sizeof(h), 1, f);
+  fclose(f);
+  ColReader r;
+  ColWriter w;
+  Check(!r.Open(path) && !w.Open(path), "flags");
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  size_t n = N_ROWS;
+  int o;
+  while((o = getopt(argc, argv, "r:")) != -1)
+  {
+    if(o == 'r') n = strtoull(optarg, nullptr, 10);
+    else { fprintf(stderr, "Usage: ColTest [-r rows]\n"); return(2); }
+  }
+  char dir[] = "/tmp/ColTestXXXXXX";
+  if(!mkdtemp(dir)) { printf("FAILED: temp directory\n"); return(1); }
+  TestFile(dir, n);
+  TestConvert(dir);
+  TestFlags(dir);
+  if(system((std::string("rm -rf ") + dir).c_str())) {}
+  printf(Fails? "FAILED\n" : "PASSED\n");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
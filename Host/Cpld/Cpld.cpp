@@ -0,0 +1,295 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host model: CPLD FCnt (Altera/FCnt.tdf)
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include "Cpld.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define K_DEF 100.0 //default stretch factor
+
+//-------------------------------- Cpld: -------------------------------------
+
+Cpld::Cpld(const Signal &fref, const Signal &fin) : Fref(fref), Fin(fin)
+{
+  T = 0;
+  nReset = 1; GateIn = 0; CalibIn = 0; FSync = 1; SClock = 0;
+  Mode = CPLD_MODE_F;
+  K = K_DEF;
+  PulseOutQ = 0; PulseIn = 0;
+  TPulse = 0; TPulseEnd = T_INF;
+  FinFalls = 0; FrefFalls = 0;
+  TGateOn = TGateOff = 0;
+  NSteps = 0;
+  Clear();
+  CntShift = 31;
+  Update();
+}
+
+//--------------------------- Signals changed: -------------------------------
+
+//edges after Now() are found again
+
+void Cpld::Update(void)
+{
+  Kr = Fref.NextRise(T - 1); Tr = Fref.Rise(Kr);
+  Kf = Fin.NextRise(T - 1);  Tf = Fin.Rise(Kf);
+  Tl = T_INF;
+  FrefStable = 0; FinStable = 0;
+}
+
+//---------------------------- Registers clear: ------------------------------
+
+void Cpld::Clear(void)
+{
+  if(FinCnt & 0x80) FinFalls++;
+  if(FrefCnt & 0x80) FrefFalls++;
+  FinCnt = FrefCnt = IntCnt = DivCnt = 0;
+  Gate = FinGate = FrefGate = IntCntEn = IntPlsEn = CalibEn = Calib = 0;
+}
+
+//------------------------------- Fin level: ---------------------------------
+
+bool Cpld::FinLevel(void) const
+{
+  return(Fin.Level(T));
+}
+
+//Fin level is used by RefEn in Hi and Lo modes
+
+bool Cpld::LevelUsed(void) const
+{
+  return(nReset && FinGate && (Mode == CPLD_MODE_HI || Mode == CPLD_MODE_LO));
+}
+
+//----------------------------- Fref edge: -----------------------------------
+
+//all registers get d values of the previous state
+
+void Cpld::FrefEdge(void)
+{
+  NSteps++;
+  Kr++; Tr = Fref.Rise(Kr);
+  if(!nReset) { FrefStable = 1; return; }
+  bool RefEn = FinGate;
+  if(FinGate && Mode == CPLD_MODE_HI) RefEn = FinLevel();
+  if(FinGate && Mode == CPLD_MODE_LO) RefEn = !FinLevel();
+  bool gate = GateIn;
+  bool calib = CalibIn;
+  bool calen = Calib;
+  bool plsen = FrefGate;
+  bool refgate = RefEn || CalibEn || Calib;
+  bool cnten = PulseIn && ((Gate || Calib) != !FrefGate);
+  if(IntCntEn) IntCnt = (IntCnt + (FrefGate? 1 : -1)) & 0xFF;
+  if(FrefGate)
+  {
+    FrefCnt = (FrefCnt + 1) & 0xFF;
+    if(!FrefCnt) FrefFalls++;
+  }
+  DivCnt = (DivCnt + 1) & 7;
+  FrefStable = gate == Gate && calib == Calib && calen == CalibEn &&
+    plsen == IntPlsEn && refgate == FrefGate && cnten == IntCntEn;
+  if(gate != Gate) FinStable = 0;
+  Gate = gate; Calib = calib; CalibEn = calen;
+  IntPlsEn = plsen; FrefGate = refgate; IntCntEn = cnten;
+  Pulse(T);
+}
+
+//------------------------------- Fin edge: ----------------------------------
+
+void Cpld::FinRise(void)
+{
+  NSteps++;
+  Kf++; Tf = Fin.Rise(Kf);
+  if(!nReset) { FinStable = 1; return; }
+  if(FinGate)
+  {
+    FinCnt = (FinCnt + 1) & 0xFF;
+    if(!FinCnt) FinFalls++;
+  }
+  FinStable = Gate == FinGate;
+  if(!FinStable)
+  {
+    FinGate = Gate;
+    if(FinGate) TGateOn = T; else TGateOff = T;
+    FrefStable = 0;
+    Pulse(T);
+  }
+  if(LevelUsed()) FrefStable = 0;    //Fin level changed
+}
+
+//------------------------------ Bulk edges: ---------------------------------
+
+//edges before te, control registers stay the same
+
+void Cpld::BulkFref(Time te)
+{
+  int64_t n = Fref.NextRise(te - 1) - Kr;
+  if(n <= 0) return;
+  Kr += n; Tr = Fref.Rise(Kr);
+  if(!nReset) return;
+  int m = n & 0xFF;
+  if(IntCntEn) IntCnt = (IntCnt + (FrefGate? m : -m)) & 0xFF;
+  if(FrefGate)
+  {
+    uint64_t s = FrefCnt + (uint64_t)n;
+    FrefFalls += s >> 8;
+    FrefCnt = s & 0xFF;
+  }
+  DivCnt = (DivCnt + m) & 7;
+}
+
+void Cpld::BulkFin(Time te)
+{
+  int64_t n = Fin.NextRise(te - 1) - Kf;
+  if(n <= 0) return;
+  Kf += n; Tf = Fin.Rise(Kf);
+  if(!nReset || !FinGate) return;
+  uint64_t s = FinCnt + (uint64_t)n;
+  FinFalls += s >> 8;
+  FinCnt = s & 0xFF;
+}
+
+//------------------------------ Stretcher: ----------------------------------
+
+//PulseIn rises with PulseOut, falls after K times PulseOut width
+
+void Cpld::Pulse(Time t)
+{
+  bool po = IntPlsEn != (FinGate || CalibEn);
+  if(po == PulseOutQ) return;
+  PulseOutQ = po;
+  if(po)
+  {
+    if(PulseIn) return;              //stretcher is busy
+    PulseIn = 1;
+    TPulse = t;
+    TPulseEnd = T_INF;
+    FrefStable = 0;
+  }
+  else if(PulseIn && TPulseEnd == T_INF)
+  {
+    TPulseEnd = TPulse + (Time)(K * (t - TPulse));
+    if(TPulseEnd < t) TPulseEnd = t;
+  }
+}
+
+//------------------------------ Run to t: -----------------------------------
+
+//events: single Fref and Fin edges while registers change,
+//PulseIn fall and Fin falls when RefEn uses Fin level;
+//at equal times Fref edge goes first
+
+void Cpld::Advance(Time t)
+{
+  while(1)
+  {
+    bool lv = LevelUsed();
+    if(!lv) Tl = T_INF;
+      else if(Tl == T_INF) { Kl = Fin.NextFall(T); Tl = Fin.Fall(Kl); }
+    bool fin = !FinStable || lv;     //Fin edges are events
+    Time tp = PulseIn? TPulseEnd : T_INF;
+    Time te = std::min(tp, Tl);
+    if(fin) te = std::min(te, Tf);
+    if(!FrefStable) te = std::min(te, Tr);
+    if(te > t)
+    {
+      if(FrefStable) BulkFref(t + 1);
+      if(!fin) BulkFin(t + 1);
+      break;
+    }
+    if(FrefStable) BulkFref(te);
+    if(!fin) BulkFin(te);
+    T = te;
+    if(!FrefStable && Tr == te) FrefEdge();
+    else if(tp == te) { PulseIn = 0; FrefStable = 0; }
+    else if(Tl == te) { Kl++; Tl = Fin.Fall(Kl); NSteps++; FrefStable = 0; }
+    else FinRise();
+  }
+  T = std::max(T, t);
+}
+
+//------------------------------ MCU pins: -----------------------------------
+
+void Cpld::SetReset(bool v)
+{
+  if(!v) Clear();
+  nReset = v;
+  FrefStable = 0; FinStable = 0;
+  Pulse(T);
+}
+
+void Cpld::SetGate(bool v)
+{
+  GateIn = v;
+  FrefStable = 0;
+}
+
+void Cpld::SetCalib(bool v)
+{
+  CalibIn = v;
+  FrefStable = 0;
+}
+
+void Cpld::SetMode(int m)
+{
+  Mode = m;
+  FrefStable = 0;
+}
+
+//CntShift is preset while FSync is high, counts on SClock rise
+
+void Cpld::SetFSync(bool v)
+{
+  FSync = v;
+  if(FSync) CntShift = 31;
+}
+
+void Cpld::SetSClock(bool v)
+{
+  if(v && !SClock && !FSync) CntShift = (CntShift + 1) & 31;
+  SClock = v;
+}
+
+bool Cpld::SData(void) const
+{
+  if(FSync) return(FinGate);
+  if(CntShift < 8)  return((FrefCnt >> CntShift) & 1);
+  if(CntShift < 16) return((FinCnt >> (CntShift - 8)) & 1);
+  if(CntShift < 24) return((IntCnt >> (CntShift - 16)) & 1);
+  return(0);
+}
+
+//------------------------- QFin, QFref falls: -------------------------------
+
+//with FSync high SData is FinGate, it changes on single Fin edge steps
+//only, so keyboard and display polls of the port need no model run
+
+bool Cpld::SDataKept(Time t) const
+{
+  if(!FSync || LevelUsed()) return(0);
+  Time te = PulseIn? TPulseEnd : T_INF;
+  if(!FinStable) te = std::min(te, Tf);
+  if(!FrefStable) te = std::min(te, Tr);
+  return(t < te);
+}
+
+uint64_t Cpld::TakeQFinFalls(void)
+{
+  uint64_t n = FinFalls;
+  FinFalls = 0;
+  return(n);
+}
+
+uint64_t Cpld::TakeQFrefFalls(void)
+{
+  uint64_t n = FrefFalls;
+  FrefFalls = 0;
+  return(n);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host model: CPLD FCnt (Altera/FCnt.tdf), header file
+
+//----------------------------------------------------------------------------
+
+#ifndef CpldH
+#define CpldH
+
+#include "Signal.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define CPLD_MODE_F  0 //F mode, RefEn = FinGate
+#define CPLD_MODE_HI 1 //Hi mode, RefEn = FinGate & Fin
+#define CPLD_MODE_LO 2 //Lo mode, RefEn = FinGate & !Fin
+
+//------------------------------- Cpld: --------------------------------------
+
+//Register level model of FCnt. Registers are updated on Fref and Fin
+//rising edges in edge order, names follow FCnt.tdf. When all control
+//registers stay the same from edge to edge, counters are advanced by
+//edge count at once, so a long gate costs only its start and end.
+//External analog stretcher is modelled too: PulseIn rises with PulseOut
+//and falls K times PulseOut width after the rise.
+//MCU side: set pins at Now() (call Advance() first), read SData,
+//take QFin and QFref falling edges for T1 and T0 counters.
+
+class Cpld
+{
+public:
+  Cpld(const Signal &fref, const Signal &fin);
+  void Advance(Time t);              //run model to t
+  void Update(void);                 //signals changed after Now()
+  Time Now(void) const { return(T); }
+
+  //MCU side pins:
+  void SetReset(bool v);             //nReset, low active
+  void SetGate(bool v);              //GateIn
+  void SetCalib(bool v);             //CalibIn
+  void SetMode(int m);               //Mode[2..0]
+  void SetFSync(bool v);             //FSync
+  void SetSClock(bool v);            //SClock
+  bool SData(void) const;            //SData
+  bool SDataKept(Time t) const;      //SData is the same at t, no Advance() needed
+  bool QFin(void) const  { return(FinCnt & 0x80); }
+  bool QFref(void) const { return(FrefCnt & 0x80); }
+  uint64_t TakeQFinFalls(void);      //QFin falling edges since last call
+  uint64_t TakeQFrefFalls(void);     //QFref falling edges since last call
+
+  //stretcher:
+  void SetStretch(double k) { K = k; }
+
+  //inspection:
+  int GetFinCnt(void) const  { return(FinCnt); }
+  int GetFrefCnt(void) const { return(FrefCnt); }
+  int GetIntCnt(void) const  { return(IntCnt); }
+  bool GetFinGate(void) const { return(FinGate); }
+  Time FinGateRise(void) const { return(TGateOn); }
+  Time FinGateFall(void) const { return(TGateOff); }
+  uint64_t Steps(void) const { return(NSteps); }
+
+private:
+  const Signal &Fref;                //reference frequency
+  const Signal &Fin;                 //input frequency
+  Time T;                            //model time
+  int64_t Kr;                        //next Fref rising edge
+  int64_t Kf;                        //next Fin rising edge
+  int64_t Kl;                        //next Fin falling edge
+  Time Tr, Tf, Tl;                   //next edges times
+
+  //pins:
+  bool nReset, GateIn, CalibIn, FSync, SClock;
+  int Mode;
+
+  //registers:
+  int FinCnt, FrefCnt, IntCnt, DivCnt, CntShift;
+  bool Gate, FinGate, FrefGate, IntCntEn, IntPlsEn, CalibEn, Calib;
+
+  //stretcher:
+  double K;                          //stretch factor
+  bool PulseOutQ;                    //PulseOut last value
+  bool PulseIn;                      //stretched pulse
+  Time TPulse;                       //PulseOut rise time
+  Time TPulseEnd;                    //PulseIn fall time
+
+  bool FrefStable;                   //Fref edge keeps control registers
+  bool FinStable;                    //Fin edge keeps FinGate
+  uint64_t FinFalls, FrefFalls;      //QFin, QFref falling edges
+  Time TGateOn, TGateOff;            //FinGate edges times
+  uint64_t NSteps;                   //single edge steps done
+
+  bool FinLevel(void) const;
+  bool LevelUsed(void) const;
+  void FrefEdge(void);
+  void FinRise(void);
+  void BulkFref(Time te);
+  void BulkFin(Time te);
+  void Pulse(Time t);
+  void Clear(void);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
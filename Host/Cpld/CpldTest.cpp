@@ -0,0 +1,388 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of CPLD model (Host/Cpld) against firmware arithmetic
+
+//Model is driven the way Count.c drives the CPLD: counters clear,
+//interpolator calibration, gate, SPI read-out, T0 and T1 counters on
+//QFref and QFin falls. Results are calculated by Calc.c and checked
+//against the signal that was fed to the model:
+//- SPI frame bits are the counters,
+//- calibration sum is -K per sample,
+//- Nx is exact Fin edges count inside the gate,
+//- frequency, period and pulse duration errors are in bounds,
+//- long gates cost a few model steps.
+
+//Usage: CpldTest [-n cases] [-s seed]
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Cpld.h"
+
+extern "C"
+{
+#include "Calc.h"
+}
+
+//----------------------------- Constants: -----------------------------------
+
+#define N_CALIB   5           //calibration cycles, as Count.c
+#define F_REF     12.8E6      //reference, Hz
+#define FREF_PAR  128000000   //reference, x0.1 Hz
+#define F_CPU     8.0E6       //MCU clock, Hz
+#define T_SYS     500E-6      //system tick, s
+#define N_CASES   400         //default random cases
+#define FOUT      1E6         //frequency result units per Hz (uHz)
+#define POUT      1E12        //period result units per s (ps)
+
+//------------------------------ Types: --------------------------------------
+
+struct Meas
+{
+  long long mx;               //reference pulses
+  long long nx;               //input pulses
+  int ix;                     //interpolator count
+  int cal;                    //calibration sum
+  Time t0, t1;                //FinGate edges
+  bool ok;                    //gate was opened and closed
+};
+
+//------------------------------- Rig: ---------------------------------------
+
+//CPLD model with signals and MCU counters T0, T1
+
+class Rig
+{
+public:
+  Signal Fref, Fin;
+  Cpld C;
+  uint64_t M, N;              //T0, T1 counts with overflows
+
+  Rig(double fin, uint64_t seed) : Fref(F_REF), Fin(fin, seed), C(Fref, Fin)
+  {
+    M = N = 0;
+  }
+
+  void Wait(double s)
+  {
+    C.Advance(C.Now() + Sec2Time(s));
+    M += C.TakeQFrefFalls();
+    N += C.TakeQFinFalls();
+  }
+
+  void Cycles(int n) { Wait(n / F_CPU); }
+
+  //Count_Clear:
+  void Clear(void)
+  {
+    C.SetReset(0);
+    Cycles(2);
+    M = N = 0;
+    C.TakeQFrefFalls();
+    C.TakeQFinFalls();
+    C.SetReset(1);
+    Cycles(2);
+  }
+
+  //Get_CPLD:
+  int Byte(void)
+  {
+    int d = 0;
+    for(int i = 0; i < 8; i++)
+    {
+      d = d >> 1;
+      C.SetSClock(1);
+      Cycles(2);
+      C.SetSClock(0);
+      Cycles(1);
+      if(C.SData()) d |= 0x80;
+    }
+    return(d);
+  }
+
+  //Count_Calib:
+  int Calib(void)
+  {
+    int cal = 0;
+    for(int i = 0; i < N_CALIB; i++)
+    {
+      Clear();
+      C.SetCalib(1);
+      Wait(50E-6);
+      C.SetCalib(0);
+      Wait(50E-6);
+      C.SetFSync(0);
+      Byte(); Byte();
+      cal += (signed char)Byte();
+      C.SetFSync(1);
+    }
+    return(cal);
+  }
+
+  //wait for SData (FinGate) level, polled each tick:
+  bool Poll(bool v, double timeout)
+  {
+    for(double t = 0; t < timeout; t += T_SYS)
+    {
+      if(C.SData() == v) return(1);
+      Wait(T_SYS);
+    }
+    return(C.SData() == v);
+  }
+
+  //Count_Read, SPI bytes are checked against counters
+  //(interpolator is left running by pulse modes, it is not used):
+  bool Read(Meas &r, bool icheck)
+  {
+    int fref = C.GetFrefCnt(), fin = C.GetFinCnt(), icnt = C.GetIntCnt();
+    C.SetFSync(0);
+    int m0 = Byte();
+    int n0 = Byte();
+    int i0 = Byte();
+    C.SetFSync(1);
+    r.mx = M * 256 + m0;
+    r.nx = N * 256 + n0;
+    r.ix = (signed char)i0;
+    return(m0 == fref && n0 == fin && (i0 == icnt || !icheck));
+  }
+
+  //gate of t seconds in mode, calibrations before and after:
+  Meas Gate(double t, int mode, bool &spi)
+  {
+    Meas r = {};
+    r.cal = Calib();
+    C.SetMode(mode);
+    Clear();
+    C.SetGate(1);
+    r.ok = Poll(1, t + 1);
+    Wait(t);
+    C.SetGate(0);
+    r.ok = Poll(0, 1) && r.ok;
+    Wait(T_SYS);
+    spi = Read(r, mode == CPLD_MODE_F);
+    r.t0 = C.FinGateRise();
+    r.t1 = C.FinGateFall();
+    C.SetMode(CPLD_MODE_F);
+    r.cal += Calib();
+    return(r);
+  }
+};
+
+//------------------------------ Variables: ----------------------------------
+
+static uint64_t Seed = 1;
+static int Fails = 0;
+
+//---------------------------- Random values: --------------------------------
+
+//xorshift64*, repeatable for the seed
+
+static uint64_t Rnd(void)
+{
+  Seed ^= Seed >> 12;
+  Seed ^= Seed << 25;
+  Seed ^= Seed >> 27;
+  return(Seed * 0x2545F4914F6CDD1DULL);
+}
+
+static double RndU(void)
+{
+  return((Rnd() >> 11) * (1.0 / 9007199254740992.0));
+}
+
+static double RndLog(double a, double b)
+{
+  return(a * std::exp(RndU() * std::log(b / a)));
+}
+
+//------------------------------- Checks: ------------------------------------
+
+static void Check(bool ok, const char *what, double f, double g)
+{
+  if(ok) return;
+  if(Fails < 20) printf("FAIL: %s, F = %.9g Hz, gate = %g s\n", what, f, g);
+  Fails++;
+}
+
+//--------------------------- Calibration test: ------------------------------
+
+static void TestCalib(void)
+{
+  printf("Calibration sum per sample:\n");
+  for(double k : {40.0, 80.0, 100.0, 120.0})
+  {
+    Rig r(1E6, 1);
+    r.C.SetStretch(k);
+    r.Wait(RndU() * 1E-3);
+    int cal = r.Calib();
+    printf("  K = %5.1f: %6.1f\n", k, (double)cal / N_CALIB);
+    Check(std::fabs(cal / (double)N_CALIB + k) <= 2, "calibration", 0, 0);
+  }
+}
+
+//------------------------- Frequency mode test: -----------------------------
+
+//interval between FinGate edges is measured by Fref count and
+//interpolator with T / K resolution at each end
+
+struct Err
+{
+  double max;                 //max relative error
+  double lim;                 //max error to bound ratio
+  int n;                      //cases
+};
+
+static void TestFreq(int n)
+{
+  static const double Gates[] = {1E-3, 10E-3, 0.1, 1, 10};
+  Err ei = {}, en = {}, ep = {};
+  long spi = 0, cnt = 0;
+  for(int i = 0; i < n; i++)
+  {
+    double f = RndLog(1, 100E6);
+    double g = Gates[Rnd() % 5];
+    if(g < 2 / f) g = 2 / f;
+    Rig r(f, Rnd());
+    if(Rnd() & 1) r.Fin.SetJitter(RndU() * 0.1 / f);
+    r.C.Update();
+    r.Wait(RndU() * 1E-3);
+    bool ok;
+    Meas m = r.Gate(g, CPLD_MODE_F, ok);
+    Check(m.ok, "gate", f, g);
+    Check(ok, "SPI frame", f, g);
+    if(!m.ok) continue;
+    spi += ok;
+    //Nx: Fin rises after FinGate rise up to its fall
+    int64_t ne = r.Fin.NextRise(m.t1) - r.Fin.NextRise(m.t0);
+    Check(m.nx == ne, "Nx count", f, g);
+    cnt += m.nx == ne;
+    double span = Time2Sec(m.t1 - m.t0);
+    double fa = m.nx / span;      //actual average frequency
+    double q = 1 / (F_REF * span); //1 count resolution
+    //with interpolator:
+    double v = Calc_Result(m.mx, m.nx, m.ix, m.cal, 2 * N_CALIB,
+      FREF_PAR, 1, 0) / FOUT;
+    double e = std::fabs(v - fa) / fa;
+    double b = 3 * q / 100 + 2E-12 + 1 / (fa * FOUT); //3 T / K steps + result LSB
+    Check(e <= b, "frequency error", f, g);
+    ei.max = std::max(ei.max, e); ei.lim = std::max(ei.lim, e / b); ei.n++;
+    //without interpolator:
+    v = Calc_Result(m.mx, m.nx, 0, 0, 2 * N_CALIB, FREF_PAR, 1, 0) / FOUT;
+    e = std::fabs(v - fa) / fa;
+    b = 2 * q + 1 / (fa * FOUT);
+    Check(e <= b, "frequency error, no interpolator", f, g);
+    en.max = std::max(en.max, e); en.lim = std::max(en.lim, e / b); en.n++;
+    //period:
+    v = Calc_Result(m.mx, m.nx, m.ix, m.cal, 2 * N_CALIB,
+      FREF_PAR, 1, 1) / POUT;
+    e = std::fabs(v * fa - 1);
+    b = 3 * q / 100 + 2E-12 + fa / POUT;
+    Check(e <= b, "period error", f, g);
+    ep.max = std::max(ep.max, e); ep.lim = std::max(ep.lim, e / b); ep.n++;
+  }
+  printf("F mode, %d cases (1 Hz..100 MHz, gate 1 ms..10 s):\n", n);
+  printf("  SPI frames match counters: %ld\n", spi);
+  printf("  Nx equals Fin edges:       %ld\n", cnt);
+  printf("  frequency, interpolator:   max error %.3g, %.2f of bound\n",
+    ei.max, ei.lim);
+  printf("  frequency, counts only:    max error %.3g, %.2f of bound\n",
+    en.max, en.lim);
+  printf("  period, interpolator:      max error %.3g, %.2f of bound\n",
+    ep.max, ep.lim);
+}
+
+//------------------------- Pulse duration test: -----------------------------
+
+//Hi and Lo modes: Mx counts Fref during the pulses, result is
+//average pulse duration in 1 count resolution
+
+static void TestPulse(int n)
+{
+  double emax = 0;
+  for(int i = 0; i < n; i++)
+  {
+    double f = RndLog(10, 1E6);
+    double d = 0.1 + 0.8 * RndU();
+    int mode = (Rnd() & 1)? CPLD_MODE_HI : CPLD_MODE_LO;
+    double g = std::max(0.1, 20 / f);
+    Rig r(f, Rnd());
+    r.Fin.SetDuty(d);
+    r.C.Update();
+    r.Wait(RndU() * 1E-3);
+    bool ok;
+    Meas m = r.Gate(g, mode, ok);
+    Check(m.ok && ok, "pulse gate", f, g);
+    if(!m.ok) continue;
+    double w = (mode == CPLD_MODE_HI? d : 1 - d) / f;
+    double v = Calc_Result(m.mx, m.nx, 0, 0, 2 * N_CALIB, FREF_PAR, 1, 1) / POUT;
+    double e = std::fabs(v - w) * F_REF; //in Fref periods
+    Check(e <= 1, "pulse duration", f, g);
+    emax = std::max(emax, e);
+  }
+  printf("Hi/Lo modes, %d cases (10 Hz..1 MHz, duty 0.1..0.9):\n", n);
+  printf("  pulse duration max error: %.3f Fref periods\n", emax);
+}
+
+//------------------------ Signal changes test: ------------------------------
+
+//frequency step and dropout inside the gate: Nx is still exact,
+//gate does not open without signal
+
+static void TestSteps(void)
+{
+  Rig r(1E6, 7);
+  r.Fin.Set(Sec2Time(0.3), 2.5E6);
+  r.Fin.Set(Sec2Time(0.4), 0);
+  r.Fin.Set(Sec2Time(0.5), 1E6);
+  r.C.Update();
+  bool ok;
+  Meas m = r.Gate(1, CPLD_MODE_F, ok);
+  int64_t ne = r.Fin.NextRise(m.t1) - r.Fin.NextRise(m.t0);
+  Check(m.ok && ok && m.nx == ne, "frequency steps", 1E6, 1);
+  Rig z(0, 1);
+  Meas mz = z.Gate(0.01, CPLD_MODE_F, ok);
+  Check(!mz.ok && mz.nx == 0, "no signal", 0, 0.01);
+  printf("Signal steps and dropout: Nx = %lld (%lld edges), "
+    "no signal gate %s\n", m.nx, (long long)ne, mz.ok? "opened" : "not opened");
+}
+
+//--------------------------- Speed test: ------------------------------------
+
+static void TestSpeed(void)
+{
+  Rig r(100E6, 3);
+  auto t0 = std::chrono::steady_clock::now();
+  bool ok;
+  Meas m = r.Gate(10, CPLD_MODE_F, ok);
+  double w = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("10 s gate at 100 MHz: %llu steps, %.3f ms\n",
+    (unsigned long long)r.C.Steps(), w * 1000);
+  Check(m.ok && r.C.Steps() < 100000, "bulk counting", 100E6, 10);
+}
+
+//------------------------------- Main: --------------------------------------
+
+int main(int argc, char *argv[])
+{
+  int n = N_CASES;
+  for(int i = 1; i < argc - 1; i++)
+  {
+    if(!strcmp(argv[i], "-n")) n = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-s")) Seed = strtoull(argv[++i], 0, 0);
+  }
+  if(!Seed) Seed = 1;
+  TestCalib();
+  TestFreq(n);
+  TestPulse(n / 4);
+  TestSteps();
+  TestSpeed();
+  printf("%s\n", Fails? "FAILED" : "PASSED");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host model: synthetic signal edge stream
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include "Signal.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define JIT_MAX 0.2 //jitter limit, periods (keeps edges in order)
+
+//------------------------------ Signal: -------------------------------------
+
+Signal::Signal(double hz, uint64_t seed)
+{
+  Segs.push_back({0, 0, hz});
+  Duty = 0.5;
+  Jitter = 0;
+  Seed = seed;
+}
+
+//------------------------- Set frequency from t: ----------------------------
+
+//t must not be less than previous segment start
+
+void Signal::Set(Time t, double hz)
+{
+  if(t <= Segs.back().t)
+  {
+    Segs.back().hz = hz;             //same start, replace
+    return;
+  }
+  Segs.push_back({t, Phase(t), hz});
+}
+
+void Signal::SetDuty(double d)
+{
+  Duty = std::min(std::max(d, 0.01), 0.99);
+}
+
+void Signal::SetJitter(double rms)
+{
+  Jitter = rms;
+}
+
+double Signal::Freq(Time t) const
+{
+  auto s = std::upper_bound(Segs.begin(), Segs.end(), t,
+    [](Time v, const Seg &g) { return(v < g.t); });
+  if(s != Segs.begin()) s--;
+  return(s->hz);
+}
+
+//------------------------------ Phase at t: ---------------------------------
+
+long double Signal::Phase(Time t) const
+{
+  auto s = std::upper_bound(Segs.begin(), Segs.end(), t,
+    [](Time v, const Seg &g) { return(v < g.t); });
+  if(s != Segs.begin()) s--;         //first segment goes back in time
+  return(s->p + (long double)s->hz * (t - s->t) / FS_S);
+}
+
+//-------------------------- Time of phase p: --------------------------------
+
+//segment with range [p, next p) containing p is found,
+//segments of a dropout have empty range
+
+Time Signal::At(long double p, double j) const
+{
+  auto s = std::upper_bound(Segs.begin(), Segs.end(), p,
+    [](long double v, const Seg &g) { return(v < g.p); });
+  if(s != Segs.begin()) s--;
+  if(s->hz <= 0) return(T_INF);       //signal stops at this phase
+  long double t = s->t + (p - s->p) * FS_S / s->hz;
+  j = std::min(std::max(j, -JIT_MAX), JIT_MAX) / s->hz;
+  t += (long double)j * FS_S;
+  if(t >= (long double)T_INF / 2) return(T_INF);
+  return((Time)llroundl(t));
+}
+
+//----------------------------- Edge jitter: ---------------------------------
+
+//gaussian value from edge number hash (splitmix64, Box-Muller),
+//e selects rising (0) or falling (1) edge, result in seconds
+
+double Signal::Jit(int64_t k, int e) const
+{
+  if(Jitter <= 0) return(0);
+  uint64_t x = Seed ^ ((uint64_t)k * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)e << 62;
+  auto mix = [](uint64_t &z)
+  {
+    z += 0x9E3779B97F4A7C15ULL;
+    uint64_t r = z;
+    r = (r ^ (r >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    r = (r ^ (r >> 27)) * 0x94D049BB133111EBULL;
+    return(r ^ (r >> 31));
+  };
+  double u1 = ((mix(x) >> 11) + 1) * (1.0 / 9007199254740993.0);
+  double u2 = (mix(x) >> 11) * (1.0 / 9007199254740992.0);
+  return(Jitter * std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2));
+}
+
+//------------------------------ Edge times: ---------------------------------
+
+//jitter is given in seconds, At() limits it to JIT_MAX periods
+
+Time Signal::Rise(int64_t k) const
+{
+  double j = Jitter > 0? Jit(k, 0) * Freq(At(k, 0)) : 0;
+  return(At(k, j));
+}
+
+Time Signal::Fall(int64_t k) const
+{
+  double j = Jitter > 0? Jit(k, 1) * Freq(At(k + Duty, 0)) : 0;
+  return(At(k + Duty, j));
+}
+
+//----------------------------- Next edges: ----------------------------------
+
+int64_t Signal::NextRise(Time t) const
+{
+  int64_t k = (int64_t)floorl(Phase(t)) - 1;
+  while(Rise(k) <= t) k++;
+  return(k);
+}
+
+int64_t Signal::NextFall(Time t) const
+{
+  int64_t k = (int64_t)floorl(Phase(t) - Duty) - 1;
+  while(Fall(k) <= t) k++;
+  return(k);
+}
+
+//------------------------------ Level at t: ---------------------------------
+
+bool Signal::Level(Time t) const
+{
+  int64_t k = NextRise(t) - 1;       //last rising edge
+  return(Fall(k) > t);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host model: synthetic signal edge stream, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef SignalH
+#define SignalH
+
+#include <cstdint>
+#include <vector>
+
+//------------------------------- Time: --------------------------------------
+
+//model time is kept in femtoseconds: 1000 s gate is 1E18 fs,
+//so int64_t covers any gate and still resolves interpolator steps
+
+typedef int64_t Time;
+
+constexpr Time FS_US = 1000000000LL;         //fs per microsecond
+constexpr Time FS_S  = 1000000000000000LL;   //fs per second
+constexpr Time T_INF = INT64_MAX;            //no event
+
+inline Time Sec2Time(double s) { return((Time)(s * FS_S + (s < 0? -0.5 : 0.5))); }
+inline double Time2Sec(Time t) { return((double)t / FS_S); }
+
+//----------------------------- Signal: --------------------------------------
+
+//Square wave with scripted frequency: rising edge k is at phase k,
+//falling edge k at phase k + duty. Frequency changes are phase
+//continuous, frequency 0 is a dropout (no edges). Edge jitter is
+//a function of edge number, so any edge can be found at once and
+//the stream is repeatable for the seed.
+
+class Signal
+{
+public:
+  Signal(double hz = 0, uint64_t seed = 1);
+  void Set(Time t, double hz);       //frequency from t on, 0 - no signal
+  void SetDuty(double d);            //high phase part of period, 0..1
+  void SetJitter(double rms);        //edge jitter, s rms
+  double Freq(Time t) const;         //frequency at t, Hz
+  Time Rise(int64_t k) const;        //rising edge k time
+  Time Fall(int64_t k) const;        //falling edge k time
+  int64_t NextRise(Time t) const;    //first rising edge after t
+  int64_t NextFall(Time t) const;    //first falling edge after t
+  bool Level(Time t) const;          //signal level at t
+
+private:
+  struct Seg
+  {
+    Time t;                          //segment start time
+    long double p;                   //phase at start, periods
+    double hz;                       //frequency, Hz
+  };
+  std::vector<Seg> Segs;             //segments in time order
+  double Duty;                       //high phase part
+  double Jitter;                     //jitter, s rms
+  uint64_t Seed;                     //jitter seed
+
+  long double Phase(Time t) const;   //phase at t
+  Time At(long double p, double j) const; //time of phase p with jitter j
+  double Jit(int64_t k, int e) const; //edge jitter, s
+};
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,357 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: ATmega8 peripherals
+
+//Ports, timers 0, 1 (external clock) and 2 (CTC), UART, free running
+//ADC and watchdog, as far as the firmware uses them.
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include "Hal/iom8.h"
+#include "Hal/intrinsics.h"
+#include "Avr.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define T_WDT   1.0                  //watchdog timeout (WDP = 110), s
+#define RX_FIFO 2                    //UART receive buffer depth
+
+static const int T2Div[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+
+//------------------------------ Variables: ----------------------------------
+
+Avr Mcu;
+
+//-------------------------- Firmware side hooks: ----------------------------
+
+unsigned Io_Read(int r)            { return(Mcu.Read(r)); }
+void Io_Write(int r, unsigned v)   { Mcu.Write(r, v); }
+void Cpu_Delay(unsigned long c)    { Mcu.Delay(c); }
+void Cpu_Sei(bool i)               { Mcu.Sei(i); }
+void Cpu_Wdr(void)                 { Mcu.Wdr(); }
+
+//--------------------------------- Avr: -------------------------------------
+
+Avr::Avr(void)
+{
+  Now = 0; Changes = 0; WdtResets = 0;
+  std::fill(Isr, Isr + VECTORS, nullptr);
+  B = nullptr;
+  I = 0; InIsr = 0;
+  std::fill(Reg, Reg + 32, 0);
+  std::fill(Port, Port + PORTS, 0);
+  std::fill(Ddr, Ddr + PORTS, 0);
+  Tcnt0 = 0; Tcnt1 = 0; Tifr = 0; Timsk = 0;
+  T2Zero = 0; T2Next = T_INF;
+  RxNext = T_INF;
+  TxBusy = 0; TxBuf = -1; TxByte = 0; TxEnd = T_INF; Txc = 0;
+  AdcVal = 0; AdcNext = T_INF;
+  WdtLast = 0;
+}
+
+//------------------------------ Periods: ------------------------------------
+
+Time Avr::ByteTime(void) const
+{
+  int ubrr = ((Reg[IO_UBRRH] & 0x0F) << 8) | Reg[IO_UBRRL];
+  int div = (Reg[IO_UCSRA] & (1 << U2X))? 8 : 16;
+  return((Time)10 * div * (ubrr + 1) * T_CYCLE);
+}
+
+double Avr::Baud(void) const
+{
+  return(10.0 * FS_S / ByteTime());
+}
+
+Time Avr::T2Period(void) const
+{
+  return((Time)(Reg[IO_OCR2] + 1) * T2Div[Reg[IO_TCCR2] & 7] * T_CYCLE);
+}
+
+Time Avr::AdcPeriod(void) const
+{
+  int ps = Reg[IO_ADCSR] & 7;
+  return((Time)13 * (ps? 1 << ps : 2) * T_CYCLE);
+}
+
+//timer 2 compare time after TCCR2 or OCR2 write, CTC mode only
+
+void Avr::Timer2Set(void)
+{
+  if((Reg[IO_TCCR2] & 7) && (Reg[IO_TCCR2] & (1 << WGM21)))
+  {
+    T2Next = T2Zero + T2Period();
+    if(T2Next <= Now) T2Next = Now + T2Period();
+  }
+  else T2Next = T_INF;
+}
+
+//------------------------------ Next event: ---------------------------------
+
+Time Avr::NextEvent(void)
+{
+  Time t = std::min({T2Next, TxEnd, RxNext, AdcNext});
+  if(B) t = std::min(t, B->Next());
+  return(t);
+}
+
+//---------------------- External counters T0, T1: ---------------------------
+
+//CS = 110 or 111: external clock (falling or rising edge)
+//Edges are taken at events and timer register accesses only, so an
+//overflow flag is late by the time to the next event at most.
+
+void Avr::Sync(void)
+{
+  uint64_t f0 = 0, f1 = 0;
+  if(B) B->Sync(f0, f1);
+  if((Reg[IO_TCCR0] & 6) == 6 && f0)
+  {
+    if(Tcnt0 + f0 > 0xFF) Tifr |= 1 << TOV0;
+    Tcnt0 = (uint8_t)(Tcnt0 + f0);
+  }
+  if((Reg[IO_TCCR1B] & 6) == 6 && f1)
+  {
+    if(Tcnt1 + f1 > 0xFFFF) Tifr |= 1 << TOV1;
+    Tcnt1 = (uint16_t)(Tcnt1 + f1);
+  }
+}
+
+//--------------------------- Run peripherals: -------------------------------
+
+void Avr::Advance(Time t)
+{
+  while(1)
+  {
+    Time e = NextEvent();
+    if(e > t) break;
+    Now = std::max(Now, e);
+    Sync();
+    if(T2Next <= Now)                //timer 2 compare match
+    {
+      Tifr |= 1 << OCF2;
+      T2Zero = T2Next;
+      T2Next += T2Period();
+    }
+    if(TxEnd <= Now)                 //byte sent
+    {
+      if(B) B->Tx(TxByte);
+      if(TxBuf >= 0)
+      {
+        TxByte = TxBuf;
+        TxBuf = -1;
+        TxEnd = Now + ByteTime();
+      }
+      else
+      {
+        TxBusy = 0;
+        TxEnd = T_INF;
+        Txc = 1;
+      }
+    }
+    if(RxNext <= Now)                //byte received
+    {
+      if(Reg[IO_UCSRB] & (1 << RXEN))
+      {
+        if(RxFifo.size() < RX_FIFO) RxFifo.push_back(RxIn.front());
+          else Reg[IO_UCSRA] |= 1 << DOR;
+      }
+      RxIn.pop_front();
+      RxNext = RxIn.empty()? T_INF : RxNext + ByteTime();
+    }
+    if(AdcNext <= Now)               //conversion complete
+    {
+      AdcVal = B? B->Adc(Reg[IO_ADMUX] & 0x0F) & 0x3FF : 0;
+      Reg[IO_ADCSR] |= 1 << ADIF;
+      if(Reg[IO_ADCSR] & (1 << ADFR)) AdcNext += AdcPeriod();
+      else
+      {
+        AdcNext = T_INF;
+        Reg[IO_ADCSR] &= ~(1 << ADSC);
+      }
+    }
+    if(B && B->Next() <= Now) B->Event();
+  }
+  Now = std::max(Now, t);
+  if((Reg[IO_WDTCR] & (1 << WDE)) && Now - WdtLast > Sec2Time(T_WDT))
+  {
+    WdtResets++;                     //reported, firmware goes on
+    WdtLast = Now;
+  }
+}
+
+//------------------------- Interrupts dispatch: -----------------------------
+
+void Avr::Dispatch(void)
+{
+  for(int n = 0; I && !InIsr && n < 64; n++)
+  {
+    int v = VECTORS;
+    if((Tifr & (1 << OCF2)) && (Timsk & (1 << OCIE2))) v = VEC_T2COMP;
+    else if((Tifr & (1 << TOV1)) && (Timsk & (1 << TOIE1))) v = VEC_T1OVF;
+    else if((Tifr & (1 << TOV0)) && (Timsk & (1 << TOIE0))) v = VEC_T0OVF;
+    else if(!RxFifo.empty() && (Reg[IO_UCSRB] & (1 << RXCIE))) v = VEC_RXC;
+    else if((Reg[IO_ADCSR] & (1 << ADIF)) && (Reg[IO_ADCSR] & (1 << ADIE))) v = VEC_ADC;
+    if(v == VECTORS) return;
+    if(v == VEC_T2COMP) Tifr &= ~(1 << OCF2); //flags cleared by vector
+    if(v == VEC_T1OVF) Tifr &= ~(1 << TOV1);
+    if(v == VEC_T0OVF) Tifr &= ~(1 << TOV0);
+    if(v == VEC_ADC) Reg[IO_ADCSR] &= ~(1 << ADIF);
+    InIsr = 1;
+    Advance(Now + ISR_CYCLES * T_CYCLE);
+    if(Isr[v]) Isr[v]();
+      else if(v == VEC_RXC) RxFifo.pop_front();
+    InIsr = 0;
+  }
+}
+
+//------------------------------ CPU time: -----------------------------------
+
+//interrupts are taken at event times, delay end is not moved
+
+void Avr::Step(uint64_t c)
+{
+  Time end = Now + (Time)c * T_CYCLE;
+  while(Now < end)
+  {
+    Advance(std::min(end, NextEvent()));
+    Dispatch();
+  }
+}
+
+void Avr::Delay(uint64_t c)
+{
+  Step(c);
+}
+
+//idle main loop: next event is the earliest time it can change
+
+void Avr::Sleep(Time limit)
+{
+  Time t = std::min(NextEvent(), limit);
+  if(t > Now) Advance(t);
+  Dispatch();
+}
+
+void Avr::Receive(uint8_t c)
+{
+  RxIn.push_back(c);
+  if(RxNext == T_INF) RxNext = Now + ByteTime();
+}
+
+//------------------------------ Registers: ----------------------------------
+
+unsigned Avr::Read(int r)
+{
+  Step(IO_CYCLES);
+  if(r == IO_TCNT0 || r == IO_TCNT1 || r == IO_TIFR) Sync();
+  unsigned v = Reg[r];
+  switch(r)
+  {
+  case IO_PINB: case IO_PINC: case IO_PIND:
+    {
+      int p = (r - IO_PINB) / 3;
+      uint8_t in = B? B->In(p) : 0;
+      v = (Ddr[p] & Port[p]) | (~Ddr[p] & in);
+      break;
+    }
+  case IO_DDRB: case IO_DDRC: case IO_DDRD:
+    v = Ddr[(r - IO_PINB) / 3]; break;
+  case IO_PORTB: case IO_PORTC: case IO_PORTD:
+    v = Port[(r - IO_PINB) / 3]; break;
+  case IO_TCNT0: v = Tcnt0; break;
+  case IO_TCNT1: v = Tcnt1; break;
+  case IO_TCNT2:
+    {
+      int d = T2Div[Reg[IO_TCCR2] & 7];
+      v = d? (uint8_t)((Now - T2Zero) / (d * T_CYCLE)) : 0;
+      break;
+    }
+  case IO_TIFR: v = Tifr; break;
+  case IO_TIMSK: v = Timsk; break;
+  case IO_UDR:
+    Changes++;
+    v = 0;
+    if(!RxFifo.empty()) { v = RxFifo.front(); RxFifo.pop_front(); }
+    break;
+  case IO_UCSRA:
+    v = Reg[r] & ~((1 << RXC) | (1 << TXC) | (1 << UDRE));
+    if(!RxFifo.empty()) v |= 1 << RXC;
+    if(Txc) v |= 1 << TXC;
+    if(TxBuf < 0) v |= 1 << UDRE;
+    break;
+  case IO_ADC: v = AdcVal; break;
+  }
+  Dispatch();
+  return(v);
+}
+
+void Avr::Write(int r, unsigned v)
+{
+  Changes++;
+  Step(IO_CYCLES);
+  if(r == IO_TCNT0 || r == IO_TCNT1 || r == IO_TIFR ||
+     r == IO_TCCR0 || r == IO_TCCR1B) Sync();
+  v &= r == IO_TCNT1? 0xFFFF : 0xFF;
+  switch(r)
+  {
+  case IO_PINB: case IO_PINC: case IO_PIND:
+    break;
+  case IO_DDRB: case IO_DDRC: case IO_DDRD:
+  case IO_PORTB: case IO_PORTC: case IO_PORTD:
+    {
+      int p = (r - IO_PINB) / 3;
+      uint8_t &d = ((r - IO_PINB) % 3 == 1)? Ddr[p] : Port[p];
+      if(d == v) break;
+      d = v;
+      if(B) B->Out(p, Port[p], Ddr[p]);
+      break;
+    }
+  case IO_TCNT0: Tcnt0 = v; break;
+  case IO_TCNT1: Tcnt1 = v; break;
+  case IO_TCCR2: Reg[r] = v; T2Zero = Now; Timer2Set(); break;
+  case IO_OCR2: Reg[r] = v; Timer2Set(); break;
+  case IO_TCNT2: break;
+  case IO_TIFR: Tifr &= ~v; break;   //flags cleared by 1
+  case IO_TIMSK: Timsk = v; break;
+  case IO_UDR:
+    if(!(Reg[IO_UCSRB] & (1 << TXEN))) break;
+    if(!TxBusy)
+    {
+      TxBusy = 1;
+      TxByte = v;
+      TxEnd = Now + ByteTime();
+    }
+    else TxBuf = v;
+    break;
+  case IO_UCSRA:
+    if(v & (1 << TXC)) Txc = 0;
+    Reg[r] = (Reg[r] & ~((1 << U2X) | (1 << MPCM))) | (v & ((1 << U2X) | (1 << MPCM)));
+    break;
+  case IO_UCSRB:
+    Reg[r] = v;
+    if(!(v & (1 << RXEN))) RxFifo.clear();
+    break;
+  case IO_ADCSR:
+    {
+      uint8_t f = Reg[r] & (1 << ADIF);
+      if(v & (1 << ADIF)) f = 0;     //flag cleared by 1
+      bool start = (v & (1 << ADSC)) && (v & (1 << ADEN)) && AdcNext == T_INF;
+      Reg[r] = (v & ~(1 << ADIF)) | f;
+      if(!(v & (1 << ADEN))) AdcNext = T_INF;
+      if(start)
+      {
+        AdcNext = Now + AdcPeriod() * 25 / 13; //first conversion
+        Reg[r] |= 1 << ADSC;
+      }
+      break;
+    }
+  default:
+    Reg[r] = v;
+  }
+  Dispatch();
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: ATmega8 peripherals, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef AvrH
+#define AvrH
+
+#include <deque>
+#include "../Cpld/Signal.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define F_CPU     8000000            //MCU clock, Hz
+#define T_CYCLE  (FS_S / F_CPU)      //MCU clock period, fs
+#define IO_CYCLES 2                  //cycles per register access
+#define ISR_CYCLES 20                //interrupt entry and exit cycles
+
+#define PORT_B 0
+#define PORT_C 1
+#define PORT_D 2
+#define PORTS  3
+
+//Interrupt vectors in priority order:
+
+enum
+{
+  VEC_T2COMP,                        //TIMER2_COMP_vect
+  VEC_T1OVF,                         //TIMER1_OVF_vect
+  VEC_T0OVF,                         //TIMER0_OVF_vect
+  VEC_RXC,                           //USART_RXC_vect
+  VEC_ADC,                           //ADC_vect
+  VECTORS
+};
+
+//------------------------------ Board: --------------------------------------
+
+//MCU pins side: board model behind the ports
+
+class Board
+{
+public:
+  virtual ~Board() {}
+  virtual void Out(int port, uint8_t port_reg, uint8_t ddr) = 0; //outputs changed
+  virtual uint8_t In(int port) = 0;  //pin levels
+  virtual void Sync(uint64_t &t0, uint64_t &t1) = 0; //run to Now, T0 and T1 falls
+  virtual unsigned Adc(int ch) = 0;  //ADC code of channel
+  virtual void Tx(uint8_t c) = 0;    //UART byte sent
+  virtual Time Next(void) = 0;       //next board event time
+  virtual void Event(void) = 0;      //board event at Now
+};
+
+//------------------------------- Avr: ---------------------------------------
+
+//Time advances by register accesses, delays and idle loop sleeps;
+//CPU time of plain code is not counted. Interrupts are taken at
+//register accesses and inside delays when I flag is set.
+
+class Avr
+{
+public:
+  Time Now;                          //model time
+  uint64_t Changes;                  //register writes and UDR reads
+  uint64_t WdtResets;                //watchdog timeouts
+  void (*Isr[VECTORS])(void);        //interrupt handlers
+
+  Avr(void);
+  void SetBoard(Board *b) { B = b; }
+  unsigned Read(int r);              //register read
+  void Write(int r, unsigned v);     //register write
+  void Delay(uint64_t c);            //spend c cycles
+  void Sei(bool i) { I = i; Dispatch(); }
+  void Wdr(void) { WdtLast = Now; }
+  void Sleep(Time limit);            //idle to next event
+  void Receive(uint8_t c);           //host byte to UART RX line
+  bool RxIdle(void) const { return(RxIn.empty()); }
+  double Baud(void) const;           //UART baud rate
+
+private:
+  Board *B;
+  bool I;                            //global interrupt flag
+  bool InIsr;                        //interrupt handler runs
+  uint8_t Reg[32];                   //plain registers
+  uint8_t Port[PORTS], Ddr[PORTS];
+
+  //timers:
+  uint8_t Tcnt0;
+  uint16_t Tcnt1;
+  uint8_t Tifr, Timsk;
+  Time T2Zero, T2Next;               //timer 2 zero and compare times
+
+  //UART:
+  std::deque<uint8_t> RxIn;          //bytes on the RX line
+  std::deque<uint8_t> RxFifo;        //received bytes
+  Time RxNext;                       //next byte received
+  bool TxBusy;                       //shift register is busy
+  int TxBuf;                         //UDR buffer, -1 - empty
+  uint8_t TxByte;                    //byte in shift register
+  Time TxEnd;                        //shift end time
+  bool Txc;                          //TXC flag
+
+  //ADC:
+  uint16_t AdcVal;
+  Time AdcNext;
+
+  //watchdog:
+  Time WdtLast;
+
+  void Advance(Time t);              //run peripherals to t
+  void Step(uint64_t c);             //spend c cycles with interrupts
+  Time NextEvent(void);
+  void Sync(void);                   //external counters
+  void Dispatch(void);               //take pending interrupts
+  Time ByteTime(void) const;
+  Time T2Period(void) const;
+  Time AdcPeriod(void) const;
+  void Timer2Set(void);
+};
+
+extern Avr Mcu;                      //emulated MCU
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,289 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: FC-510 board
+
+//Pins as Main.h. Serial shift register takes DATA on SCLK rise,
+//stage 0 is the newest bit. Display gets stages 0..3 as D4..D7 and
+//stage 4 as RS (HD44780, E = LOAD) or stages 0..4 on LOAD rise
+//(MT10-T7). Keys pull RETL low when their stage is low:
+//OK - stage 1, UP - stage 2, DN - stage 3, MN - stage 4.
+
+//----------------------------------------------------------------------------
+
+#include "Board.h"
+
+//----------------------------- Constants: -----------------------------------
+
+//Port B:
+#define B_SCLOCK 0x01
+#define B_SDATA  0x02
+#define B_RETL   0x04
+#define B_LOAD   0x08
+#define B_DATA   0x10
+#define B_SCLK   0x20
+#define B_PLINK  0x80
+
+//Port C:
+#define C_FDIV   0x01
+#define C_FSYNC  0x08
+#define C_RESET  0x10
+#define C_CALIB  0x20
+
+//Port D:
+#define D_GATE   0x04
+#define D_MODE2  0x08
+#define D_QFREF  0x10
+#define D_QFIN   0x20
+#define D_MODE0  0x40
+#define D_MODE1  0x80
+
+//CPLD pins, the model is run to Now before they change or are read:
+static const uint8_t CpldOut[PORTS] = {B_SCLOCK, C_FSYNC | C_RESET | C_CALIB,
+                                       D_GATE | D_MODE0 | D_MODE1 | D_MODE2};
+static const uint8_t CpldIn[PORTS] = {B_SDATA, 0, D_QFREF | D_QFIN};
+
+#define F_REF     12.8E6             //reference frequency, Hz
+#define V_REF     2.56               //ADC reference, V
+#define LINK_T    Sec2Time(104E-6)   //prescaler MCU link time unit
+#define LINK_ANS  Sec2Time(500E-6)   //prescaler MCU answer delay
+#define LINK_GAP  Sec2Time(1E-3)     //high phase that starts a new frame
+#define LINK_BITS 16                 //frame length, as Pre.h
+
+//--------------------------------- Fc510: -----------------------------------
+
+Fc510::Fc510(int lcd) : Fref(F_REF, 2), Fc(0, 3), C(Fref, Fc)
+{
+  LcdType = lcd;
+  Hd = nullptr; Mt = nullptr;
+  if(lcd == LCD_TYPE_10) Lcd = Mt = new Mt10();
+    else Lcd = Hd = new Hd44780(lcd == LCD_TYPE_1602? 2 : 1, lcd == LCD_TYPE_1601);
+  for(int p = 0; p < PORTS; p++) Port[p] = Ddr[p] = 0;
+  Port[PORT_C] = C_FSYNC | C_RESET;  //as CPLD model after power on
+  Sr = 0; Keys = 0;
+  Fin = 0; Level = 0;
+  PreOn = 0; Ratio = 0; Fixed = 0;
+  LinkLow = 0; SlaveLow = 0;
+  LinkEdge = 0; LinkLo = 0;
+  LinkBits = -1; LinkData = 0;
+}
+
+Fc510::~Fc510()
+{
+  delete Lcd;
+}
+
+void Fc510::At(Time t, std::function<void()> f)
+{
+  Events.emplace(t, f);
+}
+
+//------------------------------- Actions: -----------------------------------
+
+//CPLD input: with the divider on it is Fin / ratio,
+//no ratio loaded - no signal
+
+void Fc510::Input(void)
+{
+  double hz = Fin;
+  if(PreOn) hz = Ratio? Fin / Ratio : 0;
+  C.Advance(Mcu.Now);
+  Fc.Set(Mcu.Now, hz);
+  C.Update();
+}
+
+void Fc510::SetFin(double hz)
+{
+  Fin = hz;
+  Input();
+}
+
+void Fc510::SetFref(double hz)
+{
+  C.Advance(Mcu.Now);
+  Fref.Set(Mcu.Now, hz);
+  C.Update();
+}
+
+void Fc510::SetDuty(double d)
+{
+  C.Advance(Mcu.Now);
+  Fc.SetDuty(d);
+  C.Update();
+}
+
+void Fc510::SetJitter(double s)
+{
+  C.Advance(Mcu.Now);
+  Fc.SetJitter(s);
+  C.Update();
+}
+
+void Fc510::SetPre(bool on, int n, bool fixed)
+{
+  PreOn = on;
+  Fixed = fixed;
+  if(n) Ratio = n;
+  Input();
+}
+
+void Fc510::SetLevel(double v)
+{
+  Level = v;
+}
+
+void Fc510::Key(int k, bool down)
+{
+  if(down) Keys |= k;
+    else Keys &= ~k;
+}
+
+//--------------------------- Prescaler MCU: ---------------------------------
+
+//bit is low phase longer than high phase, frame ends by the stop pulse,
+//valid ratio is loaded, loaded ratio is answered (query included)
+
+void Fc510::Link(bool low)
+{
+  Time t = Mcu.Now;
+  if(low)
+  {
+    if(LinkBits < 0 || t - LinkEdge > LINK_GAP)
+    {
+      LinkBits = 0;                  //new frame
+      LinkData = 0;
+    }
+    else if(LinkBits < LINK_BITS)
+    {
+      LinkData = (LinkData << 1) | (LinkLo > t - LinkEdge);
+      LinkBits++;
+    }
+  }
+  else if(LinkBits >= 0)
+  {
+    LinkLo = t - LinkEdge;
+    if(LinkBits == LINK_BITS)        //stop pulse
+    {
+      LinkBits = -1;
+      if(!PreOn || Fixed) return;
+      int nb = LinkData / 32, na = LinkData % 32;
+      if(LinkData > 0 && nb >= 3 && nb <= 1023 && na <= nb)
+      {
+        Ratio = LinkData;
+        Input();
+      }
+      if(Ratio) Answer(Ratio);
+    }
+  }
+  LinkEdge = t;
+}
+
+void Fc510::Answer(int n)
+{
+  Time t = Mcu.Now + LINK_ANS;
+  for(int i = LINK_BITS - 1; i >= 0; i--)
+  {
+    bool b = (n >> i) & 1;
+    At(t, [this]{ SlaveLow = 1; });
+    t += (b? 3 : 1) * LINK_T;
+    At(t, [this]{ SlaveLow = 0; });
+    t += (b? 1 : 3) * LINK_T;
+  }
+  At(t, [this]{ SlaveLow = 1; });    //stop pulse
+  At(t + LINK_T, [this]{ SlaveLow = 0; });
+}
+
+//------------------------------ MCU pins: -----------------------------------
+
+void Fc510::Out(int port, uint8_t port_reg, uint8_t ddr)
+{
+  uint8_t ch = port_reg ^ Port[port];
+  uint8_t v = port_reg;
+  Port[port] = port_reg;
+  Ddr[port] = ddr;
+  if(ch & CpldOut[port]) C.Advance(Mcu.Now);
+  switch(port)
+  {
+  case PORT_B:
+    if(ch & B_SCLOCK) C.SetSClock(v & B_SCLOCK);
+    if((ch & B_SCLK) && (v & B_SCLK)) Sr = (Sr << 1) | ((v & B_DATA)? 1 : 0);
+    if(ch & B_LOAD)
+    {
+      if(Hd && !(v & B_LOAD)) Hd->Strobe(Sr & 0x0F, Sr & 0x10, Mcu.Now);
+      if(Mt && (v & B_LOAD)) Mt->Write(Sr & 0x1F);
+    }
+    {
+      bool low = (ddr & B_PLINK) && !(v & B_PLINK);
+      if(low != LinkLow) { LinkLow = low; Link(low); }
+    }
+    break;
+  case PORT_C:
+    if(ch & C_RESET) C.SetReset(v & C_RESET);
+    if(ch & C_CALIB) C.SetCalib(v & C_CALIB);
+    if(ch & C_FSYNC) C.SetFSync(v & C_FSYNC);
+    break;
+  case PORT_D:
+    if(ch & D_GATE) C.SetGate(v & D_GATE);
+    if(ch & (D_MODE0 | D_MODE1 | D_MODE2))
+      C.SetMode(((v & D_MODE2)? 4 : 0) | ((v & D_MODE1)? 2 : 0) | ((v & D_MODE0)? 1 : 0));
+    break;
+  }
+}
+
+uint8_t Fc510::In(int port)
+{
+  uint8_t v = 0xFF;                  //pull-ups
+  if(CpldIn[port] && !(port == PORT_B && C.SDataKept(Mcu.Now))) C.Advance(Mcu.Now);
+  switch(port)
+  {
+  case PORT_B:
+    if(!C.SData()) v &= ~B_SDATA;
+    for(int k = 0; k < 4; k++)       //key MN, DN, UP, OK at stage 4..1
+      if((Keys & (1 << k)) && !(Sr & (1 << (4 - k)))) v &= ~B_RETL;
+    if(LinkLow || SlaveLow) v &= ~B_PLINK;
+    break;
+  case PORT_C:
+    if(!PreOn) v &= ~C_FDIV;
+    break;
+  case PORT_D:
+    if(!C.QFref()) v &= ~D_QFREF;
+    if(!C.QFin()) v &= ~D_QFIN;
+    break;
+  }
+  return(v);
+}
+
+void Fc510::Sync(uint64_t &t0, uint64_t &t1)
+{
+  C.Advance(Mcu.Now);
+  t0 = C.TakeQFrefFalls();
+  t1 = C.TakeQFinFalls();
+}
+
+//level is the same at input (6) and prescaler (7) channels
+
+unsigned Fc510::Adc(int ch)
+{
+  (void)ch;
+  double c = Level / V_REF * 1024;
+  return(c < 0? 0 : c > 1023? 1023 : (unsigned)c);
+}
+
+//------------------------------ Board events: -------------------------------
+
+Time Fc510::Next(void)
+{
+  return(Events.empty()? T_INF : Events.begin()->first);
+}
+
+void Fc510::Event(void)
+{
+  while(!Events.empty() && Events.begin()->first <= Mcu.Now)
+  {
+    auto f = Events.begin()->second;
+    Events.erase(Events.begin());
+    f();
+  }
+}
+
+//----------------------------------------------------------------------------
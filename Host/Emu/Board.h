@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: FC-510 board, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef BoardH
+#define BoardH
+
+#include <functional>
+#include <map>
+#include "../Cpld/Cpld.h"
+#include "Avr.h"
+#include "Lcd.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define LCD_TYPE_10   0              //MT10-T7
+#define LCD_TYPE_1601 1              //HD44780 1x16
+#define LCD_TYPE_1602 2              //HD44780 2x16
+
+//Keys as Keyboard.h codes:
+#define BRD_KEY_MN 0x01
+#define BRD_KEY_DN 0x02
+#define BRD_KEY_UP 0x04
+#define BRD_KEY_OK 0x08
+
+//------------------------------- Fc510: -------------------------------------
+
+//MCU neighbours: CPLD with Fref and Fin, serial shift register with
+//display and keyboard, prescaler MCU on the PLINK wire, FDIV sense,
+//level detector on ADC, UART. Script actions are board events.
+
+class Fc510 : public Board
+{
+public:
+  Signal Fref;                       //reference at CPLD
+  Signal Fc;                         //input at CPLD (after prescaler)
+  Cpld C;
+  Display *Lcd;
+  std::function<void(uint8_t)> OnTx; //UART byte sent by MCU
+
+  Fc510(int lcd);
+  ~Fc510();
+  void At(Time t, std::function<void()> f); //schedule board action
+
+  //actions at Mcu.Now:
+  void SetFin(double hz);            //input frequency
+  void SetFref(double hz);           //reference frequency
+  void SetDuty(double d);
+  void SetJitter(double s);
+  void SetPre(bool on, int n, bool fixed = 0); //prescaler on/off, n - loaded ratio,
+                                     //fixed - no link (original MCU firmware)
+  void SetLevel(double v);           //detector output, V
+  void Key(int k, bool down);        //press or release keys
+
+  //Board:
+  void Out(int port, uint8_t port_reg, uint8_t ddr) override;
+  uint8_t In(int port) override;
+  void Sync(uint64_t &t0, uint64_t &t1) override;
+  unsigned Adc(int ch) override;
+  void Tx(uint8_t c) override { if(OnTx) OnTx(c); }
+  Time Next(void) override;
+  void Event(void) override;
+
+private:
+  int LcdType;
+  Hd44780 *Hd;
+  Mt10 *Mt;
+  std::multimap<Time, std::function<void()>> Events;
+  uint8_t Port[PORTS], Ddr[PORTS];   //MCU outputs
+  uint8_t Sr;                        //serial shift register
+  int Keys;                          //pressed keys
+  double Fin;                        //input frequency, Hz
+  double Level;                      //detector output, V
+
+  //prescaler MCU:
+  bool PreOn;                        //divider is on
+  int Ratio;                         //LMX2324 ratio loaded
+  bool Fixed;                        //MCU does not answer the link
+  bool LinkLow;                      //MCU drives PLINK low
+  bool SlaveLow;                     //prescaler MCU drives PLINK low
+  Time LinkEdge;                     //last MCU edge time
+  Time LinkLo;                       //last low phase length
+  int LinkBits;                      //bits received
+  int LinkData;                      //frame data
+
+  void Input(void);                  //CPLD input after prescaler
+  void Link(bool low);               //MCU PLINK edge
+  void Answer(int n);                //prescaler MCU answer frame
+};
+
+//----------------------------------------------------------------------------
+
+#endif
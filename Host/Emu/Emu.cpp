@@ -0,0 +1,517 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: firmware on native HAL with board model
+
+//Firmware sources (../Iar_C) are built as is for the host, register
+//accesses go to the ATmega8 model (Avr.cpp), pins to the board model
+//(Board.cpp) with the CPLD model (../Cpld). One binary per display
+//configuration: Emu10, Emu1601, Emu1602.
+
+//Usage: Emu [options] [script]
+//-t s      run time, s (default 10, with -p - forever)
+//-p        UART on a pseudo terminal, run in real time
+//-x k      time scale for -p (model seconds per second)
+//-e file   EEPROM image, loaded at start and saved at exit (EepLoad)
+//-s p=v    set EEPROM parameter (PAR_xxx of Menu.h in lower case:
+//          mode, gate, avg, if, ..., scale0..scale<MODES-1>) before boot,
+//          checked against ParLim
+//-c line   script line (after the script file)
+//-d        log display contents on change
+//-u        log UART output as time stamped lines
+
+//Script line: <time|+dt> <command> [args], # - comment
+//fin Hz, fref Hz, duty 0..1, jitter s, pre on [ratio [fixed]]|off, level V,
+//key OK|UP|DN|MN [hold s], send text, show, expect text,
+//settle value, end. Exit code is 1 if an expect failed or the
+//watchdog timed out.
+//settle: time from the line time until the display and the UART copy
+//show value (in display units) rounded to the digits shown, reported
+//at exit.
+
+//Host differences from IAR EWAVR:
+//- firmware CPU time is not modelled: register accesses, delays and
+//  interrupt entries take time, plain code takes none,
+//- main cycles that write no registers only poll pins, after a few of
+//  them time goes to the next timer, UART, ADC or script event, so a
+//  polled pin change (SDATA, FDIV) is seen up to 0.2 ms late and T0,
+//  T1 overflows are flagged at the next event or timer access,
+//- int is 32-bit and long is 64-bit: counters that carry on overflow
+//  are char or unsigned short (Count_M), as wide as in the MCU, free
+//  running ones (Ticks, ResNum, sequence numbers) wrap later.
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Board.h"
+#include "Fw.h"
+#include "Meter.h"
+#ifdef LCD16XX
+  #define HI_RES                     //ParLim of LCD16xx builds, as Main.h
+#endif
+#include "FwTables.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#if defined(LCD10)
+  #define LCD_TYPE LCD_TYPE_10
+#elif defined(LCD1601)
+  #define LCD_TYPE LCD_TYPE_1601
+#else
+  #define LCD_TYPE LCD_TYPE_1602
+#endif
+
+#define T_RUN       10.0             //default run time, s
+#define LOOP_CYCLES 200              //main cycle CPU time, cycles
+#define IDLE_LOOPS  2                //idle cycles before sleep
+#define KEY_HOLD    0.2              //default key hold time, s
+#define PACE_MIN    Sec2Time(1E-3)   //real time lead before wait
+#define PAR_SIZE    (PARAMS * (int)sizeof(long)) //EPar bytes used
+
+//------------------------------- Types: -------------------------------------
+
+struct Settle
+{
+  Time t;                            //start time
+  double v;                          //value expected
+  Time lcd, uart;                    //value shown times
+};
+
+//------------------------------ Variables: ----------------------------------
+
+static Fc510 Brd(LCD_TYPE);
+static Time EndTime = T_INF;         //script end
+static int Fails;                    //failed expects
+static std::vector<Settle> Settles;  //settle probes
+static bool LogDisp, LogUart;
+static int Pty = -1;                 //pseudo terminal master
+static std::string UartLine;
+
+//------------------------- Function prototypes: -----------------------------
+
+static void Usage(void);
+static bool Script(const char *line, Time &prev);
+static bool ParSet(const char *s);
+static bool EepLoad(const char *name);
+static bool EepSave(const char *name);
+static bool EepDefaults(void);
+static void Boot(void);
+static void Run(Time end, double scale);
+static void Uart(uint8_t c);
+static void Check(const std::string &s, bool uart);
+
+//----------------------------------------------------------------------------
+//------------------------------ Main program: -------------------------------
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  double run = -1, scale = 1;
+  bool pty = 0;
+  const char *eep = nullptr;
+  std::string sets, lines;
+  int o;
+  while((o = getopt(argc, argv, "t:px:e:s:c:duh")) != -1)
+  {
+    switch(o)
+    {
+    case 't': run = atof(optarg); break;
+    case 'p': pty = 1; break;
+    case 'x': scale = atof(optarg); break;
+    case 'e': eep = optarg; break;
+    case 's': sets += std::string(optarg) + '\n'; break;
+    case 'c': lines += std::string(optarg) + '\n'; break;
+    case 'd': LogDisp = 1; break;
+    case 'u': LogUart = 1; break;
+    default: Usage(); return(2);
+    }
+  }
+  if(scale <= 0) { Usage(); return(2); }
+
+  //script:
+  Time prev = 0;
+  if(optind < argc)
+  {
+    FILE *f = fopen(argv[optind], "r");
+    if(!f) { fprintf(stderr, "Emu: cannot open %s\n", argv[optind]); return(2); }
+    char s[256];
+    while(fgets(s, sizeof(s), f))
+      if(!Script(s, prev)) { fclose(f); return(2); }
+    fclose(f);
+  }
+  for(size_t p = 0, e; p < lines.size(); p = e + 1)
+  {
+    e = lines.find('\n', p);
+    if(!Script(lines.substr(p, e - p).c_str(), prev)) return(2);
+  }
+
+  //EEPROM: image file or firmware defaults, then parameters
+  Mcu.SetBoard(&Brd);
+  bool loaded = eep && EepLoad(eep);
+  if(!loaded && !sets.empty() && !EepDefaults()) return(2);
+  for(size_t p = 0, e; p < sets.size(); p = e + 1)
+  {
+    e = sets.find('\n', p);
+    if(!ParSet(sets.substr(p, e - p).c_str())) return(2);
+  }
+  if(!loaded && sets.empty()) ESignature = 0; //firmware loads defaults
+
+  //pseudo terminal:
+  if(pty)
+  {
+    Pty = posix_openpt(O_RDWR | O_NOCTTY);
+    if(Pty < 0 || grantpt(Pty) || unlockpt(Pty))
+      { perror("Emu: pty"); return(2); }
+    struct termios tio;
+    tcgetattr(Pty, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(Pty, TCSANOW, &tio);
+    fcntl(Pty, F_SETFL, O_NONBLOCK);
+    open(ptsname(Pty), O_RDWR | O_NOCTTY); //keep slave open
+    fprintf(stderr, "Emu: UART at %s\n", ptsname(Pty));
+  }
+  Brd.OnTx = Uart;
+
+  Boot();
+  Time end = (run >= 0)? Sec2Time(run) : pty? T_INF : Sec2Time(T_RUN);
+  Run(end, scale);
+
+  if(eep && !EepSave(eep)) return(2);
+  for(auto &p : Settles)
+  {
+    printf("settle %g at %.6f: lcd ", p.v, Time2Sec(p.t));
+    if(p.lcd == T_INF) printf("-"); else printf("%.6f", Time2Sec(p.lcd - p.t));
+    printf(" uart ");
+    if(p.uart == T_INF) printf("-\n"); else printf("%.6f\n", Time2Sec(p.uart - p.t));
+  }
+  fprintf(stderr, "Emu: %.6f s, |%s|", Time2Sec(Mcu.Now), Brd.Lcd->Text().c_str());
+  if(Mcu.WdtResets) fprintf(stderr, ", watchdog timeouts: %llu",
+                            (unsigned long long)Mcu.WdtResets);
+  if(Fails) fprintf(stderr, ", failed expects: %d", Fails);
+  fprintf(stderr, "\n");
+  return((Fails || Mcu.WdtResets)? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+static void Usage(void)
+{
+  fprintf(stderr,
+    "Usage: Emu [-t s] [-p] [-x k] [-e file] [-s par=value] [-c line]\n"
+    "           [-d] [-u] [script]\n");
+}
+
+//------------------------------- Script: ------------------------------------
+
+static bool Key(const char *s, int &k)
+{
+  static const struct { const char *n; int k; } Keys[] =
+  {
+    {"OK", BRD_KEY_OK}, {"UP", BRD_KEY_UP}, {"DN", BRD_KEY_DN}, {"MN", BRD_KEY_MN}
+  };
+  for(auto &n : Keys) if(!strcmp(s, n.n)) { k = n.k; return(1); }
+  return(0);
+}
+
+//"\r" and "\n" in send text
+
+static std::string Unescape(const char *s)
+{
+  std::string r;
+  for(; *s; s++)
+  {
+    if(*s == '\\' && s[1] == 'r') { r += '\r'; s++; }
+    else if(*s == '\\' && s[1] == 'n') { r += '\n'; s++; }
+    else r += *s;
+  }
+  return(r);
+}
+
+static bool Script(const char *line, Time &prev)
+{
+  char tm[32] = "", cmd[32] = "", a1[32] = "";
+  int n = 0;
+  while(*line == ' ' || *line == '\t') line++;
+  if(!*line || *line == '#' || *line == '\n' || *line == '\r') return(1);
+  if(sscanf(line, "%31s %31s %n", tm, cmd, &n) < 2)
+    { fprintf(stderr, "Emu: bad script line: %s\n", line); return(0); }
+  std::string arg = line + n;
+  while(!arg.empty() && (arg.back() == '\n' || arg.back() == '\r')) arg.pop_back();
+  sscanf(arg.c_str(), "%31s", a1);
+  double v = atof(a1);
+  Time t = Sec2Time(atof(tm + (tm[0] == '+')));
+  if(tm[0] == '+') t += prev;
+  prev = t;
+
+  std::string c = cmd;
+  if(c == "fin") Brd.At(t, [v]{ Brd.SetFin(v); });
+  else if(c == "fref") Brd.At(t, [v]{ Brd.SetFref(v); });
+  else if(c == "duty") Brd.At(t, [v]{ Brd.SetDuty(v); });
+  else if(c == "jitter") Brd.At(t, [v]{ Brd.SetJitter(v); });
+  else if(c == "level") Brd.At(t, [v]{ Brd.SetLevel(v); });
+  else if(c == "pre")
+  {
+    bool on = !strcmp(a1, "on");
+    int r = 0;
+    char fx[16] = "";
+    sscanf(arg.c_str(), "%*s %d %15s", &r, fx);
+    if(!on && strcmp(a1, "off")) goto bad;
+    if(*fx && strcmp(fx, "fixed")) goto bad;
+    bool f = *fx;
+    Brd.At(t, [on, r, f]{ Brd.SetPre(on, r, f); });
+  }
+  else if(c == "key")
+  {
+    int k;
+    double h = KEY_HOLD;
+    if(!Key(a1, k)) goto bad;
+    sscanf(arg.c_str(), "%*s %lf", &h);
+    Brd.At(t, [k]{ Brd.Key(k, 1); });
+    Brd.At(t + Sec2Time(h), [k]{ Brd.Key(k, 0); });
+  }
+  else if(c == "send")
+  {
+    std::string s = Unescape(arg.c_str());
+    Brd.At(t, [s]{ for(char ch : s) Mcu.Receive(ch); });
+  }
+  else if(c == "show")
+    Brd.At(t, []{ printf("%.6f |%s|\n", Time2Sec(Mcu.Now), Brd.Lcd->Text().c_str()); });
+  else if(c == "expect")
+  {
+    Brd.At(t, [arg]
+    {
+      std::string d = Brd.Lcd->Text();
+      if(d.find(arg) != std::string::npos) return;
+      printf("%.6f expect \"%s\" failed: |%s|\n", Time2Sec(Mcu.Now), arg.c_str(), d.c_str());
+      Fails++;
+    });
+  }
+  else if(c == "settle")
+  {
+    Settles.push_back({t, v, T_INF, T_INF});
+    Brd.At(t, []{ Check(Brd.Lcd->Text(), 0); }); //value may be shown yet
+  }
+  else if(c == "end") EndTime = std::min(EndTime, t);
+  else goto bad;
+  return(1);
+
+bad:
+  fprintf(stderr, "Emu: bad script line: %s\n", line);
+  return(0);
+}
+
+//------------------------------- EEPROM: ------------------------------------
+
+static bool ParSet(const char *s)
+{
+  char n[16];
+  long v;
+  int m;
+  if(sscanf(s, "%15[^=]=%ld", n, &v) == 2)
+  {
+    if(sscanf(n, "scale%d", &m) == 1 && m >= 0 && m < MODES)
+      { EScale[m] = v; return(1); }
+    for(int i = 0; i < PARAMS; i++)
+      if(!strcmp(n, FwParName[i]) && v >= FwParLim[i][P_MIN] && v <= FwParLim[i][P_MAX])
+        { EPar[i] = v; return(1); }
+  }
+  fprintf(stderr, "Emu: bad parameter: %s\n", s);
+  return(0);
+}
+
+//text image: "sig", "params", "modes", parameter names,
+//"scale<n>", "premeas", "prefor" with values; "old." prefixed ones are the original
+//layout (Menu.c), which the firmware migrates at boot
+
+static bool EepLoad(const char *name)
+{
+  FILE *f = fopen(name, "r");
+  if(!f) return(0);
+  char n[24];
+  long v;
+  while(fscanf(f, "%23s %ld", n, &v) == 2)
+  {
+    bool old = !strncmp(n, "old.", 4);
+    const char *k = n + (old? 4 : 0);
+    int np = old? FW_OLD_PARAMS : PARAMS;
+    int m;
+    if(!strcmp(k, "sig")) (old? EOldSign : ESignature) = v;
+    else if(!old && !strcmp(k, "params")) EParams = v;
+    else if(!old && !strcmp(k, "modes")) EModes = v;
+    else if(!old && !strcmp(k, "premeas")) EPreMeas = v;
+    else if(!old && !strcmp(k, "prefor")) EPreFor = v;
+    else if(sscanf(k, "scale%d", &m) == 1 && m >= 0 && m < (old? FW_OLD_MODES : MODES))
+      (old? EOldScale : EScale)[m] = v;
+    else for(int i = 0; i < np; i++)
+      if(!strcmp(k, FwParName[i])) (old? EOldPar : EPar)[i] = v;
+  }
+  fclose(f);
+  return(1);
+}
+
+static bool EepSave(const char *name)
+{
+  FILE *f = fopen(name, "w");
+  if(!f) { fprintf(stderr, "Emu: cannot write %s\n", name); return(0); }
+  fprintf(f, "sig %d\nparams %d\nmodes %d\n", ESignature, EParams, EModes);
+  fprintf(f, "premeas %d\nprefor %d\n", EPreMeas, EPreFor);
+  for(int i = 0; i < PARAMS; i++) fprintf(f, "%s %ld\n", FwParName[i], EPar[i]);
+  for(int i = 0; i < MODES; i++) fprintf(f, "scale%d %d\n", i, (uint8_t)EScale[i]);
+  if(EOldSign == FW_OLD_SIGN)
+  {
+    fprintf(f, "old.sig %d\n", EOldSign);
+    for(int i = 0; i < FW_OLD_PARAMS; i++) fprintf(f, "old.%s %ld\n", FwParName[i], EOldPar[i]);
+    for(int i = 0; i < FW_OLD_MODES; i++) fprintf(f, "old.scale%d %d\n", i, (uint8_t)EOldScale[i]);
+  }
+  fclose(f);
+  return(1);
+}
+
+//defaults are taken from the firmware itself: a child boots with blank
+//EEPROM (ParLim defaults are written) and passes the EEPROM back
+
+static bool EepDefaults(void)
+{
+  int p[2];
+  if(pipe(p)) return(0);
+  fflush(stdout);
+  pid_t pid = fork();
+  if(pid < 0) return(0);
+  if(!pid)
+  {
+    close(p[0]);
+    ESignature = 0;
+    Boot();
+    bool ok = write(p[1], EPar, PAR_SIZE) == PAR_SIZE &&
+              write(p[1], EScale, MODES) == MODES;
+    _exit(ok? 0 : 1);
+  }
+  close(p[1]);
+  bool ok = read(p[0], EPar, PAR_SIZE) == PAR_SIZE &&
+            read(p[0], EScale, MODES) == MODES;
+  close(p[0]);
+  int st;
+  waitpid(pid, &st, 0);
+  if(!ok) { fprintf(stderr, "Emu: no EEPROM defaults\n"); return(0); }
+  ESignature = FW_SIGNATURE;
+  EParams = PARAMS;
+  EModes = MODES;
+  return(1);
+}
+
+//---------------------------- Firmware run: ---------------------------------
+
+//init as main() in Main.c
+
+static void Boot(void)
+{
+  Mcu.Isr[VEC_T2COMP] = Timer;
+  Mcu.Isr[VEC_T1OVF]  = Timer1;
+  Mcu.Isr[VEC_T0OVF]  = Timer0;
+  Mcu.Isr[VEC_RXC]    = Rx_Int;
+  Mcu.Isr[VEC_ADC]    = Adc_Int;
+  Main_Wdt_Init();
+  Main_Ports_Init();
+  Main_Timer_Init();
+  Count_Init();
+  Menu_Init();
+  Mcu.Sei(1);
+}
+
+//main cycle as main() in Main.c: cycle without tick and register
+//writes is idle (pins polled only), after a few of them time goes
+//to the next event
+
+static void Run(Time end, double scale)
+{
+  auto wall = std::chrono::steady_clock::now();
+  std::string shown;
+  int idle = 0;
+  while(Mcu.Now < end && Mcu.Now < EndTime)
+  {
+    uint64_t ch = Mcu.Changes;
+    bool t = Main_GetTick();
+    Count_Exe(t);
+    Menu_Exe(t);
+    Main_Rst_Wdt(t);
+    Mcu.Delay(LOOP_CYCLES);
+
+    if(Brd.Lcd->Changed)
+    {
+      Brd.Lcd->Changed = 0;
+      std::string s = Brd.Lcd->Text();
+      if(s != shown)
+      {
+        if(LogDisp) printf("%.6f |%s|\n", Time2Sec(Mcu.Now), s.c_str());
+        Check(s, 0);
+      }
+      shown = s;
+    }
+
+    if(!t && Mcu.Changes == ch) idle++;
+      else idle = 0;
+    if(idle >= IDLE_LOOPS) Mcu.Sleep(std::min(end, EndTime));
+
+    if(Pty >= 0)                     //real time pacing and UART input
+    {
+      double w = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall).count();
+      Time lead = Mcu.Now - Sec2Time(w * scale);
+      if(lead < PACE_MIN) continue;
+      struct pollfd pf = {Pty, POLLIN, 0};
+      poll(&pf, 1, (int)(Time2Sec(lead) / scale * 1E3));
+      uint8_t b[64];
+      ssize_t n = read(Pty, b, sizeof(b));
+      for(ssize_t i = 0; i < n; i++) Mcu.Receive(b[i]);
+    }
+  }
+}
+
+//---------------------------- UART output: ----------------------------------
+
+static void Uart(uint8_t c)
+{
+  if(Pty >= 0) { if(write(Pty, &c, 1) < 0) {} return; }
+  if(!LogUart) putchar(c);
+  if(c == '\r') return;
+  if(c != '\n') { UartLine += (char)c; return; }
+  if(LogUart) printf("%.6f > %s\n", Time2Sec(Mcu.Now), UartLine.c_str());
+  Check(UartLine, 1);
+  UartLine.clear();
+}
+
+//---------------------------- Settle probes: --------------------------------
+
+//first number in the text is compared with the value,
+//it is right when it is the value rounded to the digits shown
+
+static void Check(const std::string &s, bool uart)
+{
+  size_t p = s.find_first_of("0123456789");
+  if(p == std::string::npos) return;
+  size_t e = s.find_first_not_of("0123456789.", p);
+  std::string n = s.substr(p, e == std::string::npos? e : e - p);
+  size_t d = n.find('.');
+  double lsb = pow(10, -(double)(d == std::string::npos? 0 : n.size() - d - 1));
+  double v = atof(n.c_str());
+  if(p && s[p - 1] == '-') v = -v;
+  for(auto &r : Settles)
+  {
+    Time &t = uart? r.uart : r.lcd;
+    if(t == T_INF && Mcu.Now >= r.t && fabs(v - r.v) <= lsb / 2 * (1 + 1E-9)) t = Mcu.Now;
+  }
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: firmware entry points, header file
+
+//Firmware is built as C++ with Hal/ headers, main() is renamed to
+//Fw_Main() and is not called: the emulator runs the same init and
+//main cycle itself to find idle cycles.
+
+//----------------------------------------------------------------------------
+
+#ifndef FwH
+#define FwH
+
+#include "Count.h"
+#include "Menu.h"
+
+//------------------------------ Main.c: -------------------------------------
+
+void Main_Wdt_Init(void);
+void Main_Ports_Init(void);
+void Main_Timer_Init(void);
+bool Main_GetTick(void);
+void Main_Rst_Wdt(bool t);
+void Timer(void);                    //TIMER2_COMP_vect
+
+//----------------------------- Modules: -------------------------------------
+
+void Timer0(void);                   //TIMER0_OVF_vect
+void Timer1(void);                   //TIMER1_OVF_vect
+void Rx_Int(void);                   //USART_RXC_vect
+void Adc_Int(void);                  //ADC_vect
+
+//------------------------------- EEPROM: ------------------------------------
+
+extern int  EOldSign;                //original layout, Menu.c
+extern long EOldPar[];
+extern char EOldScale[];
+extern int  ESignature;
+extern char EParams;
+extern char EModes;
+extern long EPar[];                  //PARAMS used
+extern char EScale[];                //MODES used
+extern int  EPreMeas;                //two-path prescaler ratio
+extern int  EPreFor;
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,32 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host HAL: IAR EWAVR intrinsic functions
+
+//----------------------------------------------------------------------------
+
+#ifndef INTRINSICS_H
+#define INTRINSICS_H
+
+//------------------------------ Emulator: -----------------------------------
+
+void Cpu_Delay(unsigned long c);     //spend c CPU cycles
+void Cpu_Sei(bool i);                //global interrupt flag
+void Cpu_Wdr(void);                  //watchdog reset
+
+//----------------------------- Intrinsics: ----------------------------------
+
+inline void __delay_cycles(unsigned long c) { Cpu_Delay(c); }
+inline void __enable_interrupt(void)  { Cpu_Sei(1); }
+inline void __disable_interrupt(void) { Cpu_Sei(0); }
+inline void __watchdog_reset(void)    { Cpu_Wdr(); }
+inline void __no_operation(void)      { Cpu_Delay(1); }
+
+inline unsigned char __swap_nibbles(unsigned char c)
+{
+  return((unsigned char)((c << 4) | (c >> 4)));
+}
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host HAL: ATmega8 I/O registers and IAR keywords for firmware on host
+
+//Firmware sources are compiled as C++ with this directory first in
+//the include path. Registers are objects, each access is passed to
+//the emulator (Avr.cpp), which keeps time and peripheral state.
+
+//----------------------------------------------------------------------------
+
+#ifndef IOM8_H
+#define IOM8_H
+
+#include <cstdint>
+
+//----------------------------- IAR keywords: --------------------------------
+
+#define __flash
+#define __eeprom
+#define __no_init
+#define __monitor
+#define __interrupt
+
+//----------------------------- Register ids: --------------------------------
+
+enum
+{
+  IO_PINB, IO_DDRB, IO_PORTB,
+  IO_PINC, IO_DDRC, IO_PORTC,
+  IO_PIND, IO_DDRD, IO_PORTD,
+  IO_TCCR0, IO_TCNT0,
+  IO_TCCR1A, IO_TCCR1B, IO_TCNT1,
+  IO_TCCR2, IO_TCNT2, IO_OCR2,
+  IO_TIMSK, IO_TIFR,
+  IO_UDR, IO_UCSRA, IO_UCSRB, IO_UCSRC, IO_UBRRL, IO_UBRRH,
+  IO_ADMUX, IO_ADCSR, IO_ADC,
+  IO_ACSR, IO_WDTCR, IO_MCUCR, IO_GICR, IO_SFIOR,
+  IO_REGS
+};
+
+//------------------------------ Emulator: -----------------------------------
+
+unsigned Io_Read(int r);             //read register
+void Io_Write(int r, unsigned v);    //write register
+
+//------------------------------ Registers: ----------------------------------
+
+//compound assignments are read-modify-write as IN/OUT or SBI/CBI
+
+template<typename T> struct Io_Reg
+{
+  int r;
+  operator T() const { return((T)Io_Read(r)); }
+  Io_Reg &operator=(unsigned v) { Io_Write(r, (T)v); return(*this); }
+  Io_Reg &operator|=(unsigned v) { Io_Write(r, (T)(Io_Read(r) | v)); return(*this); }
+  Io_Reg &operator&=(unsigned v) { Io_Write(r, (T)(Io_Read(r) & v)); return(*this); }
+  Io_Reg &operator^=(unsigned v) { Io_Write(r, (T)(Io_Read(r) ^ v)); return(*this); }
+};
+
+typedef Io_Reg<uint8_t>  Io_Reg8;
+typedef Io_Reg<uint16_t> Io_Reg16;
+
+inline Io_Reg8  PINB{IO_PINB},   DDRB{IO_DDRB},   PORTB{IO_PORTB};
+inline Io_Reg8  PINC{IO_PINC},   DDRC{IO_DDRC},   PORTC{IO_PORTC};
+inline Io_Reg8  PIND{IO_PIND},   DDRD{IO_DDRD},   PORTD{IO_PORTD};
+inline Io_Reg8  TCCR0{IO_TCCR0}, TCNT0{IO_TCNT0};
+inline Io_Reg8  TCCR1A{IO_TCCR1A}, TCCR1B{IO_TCCR1B};
+inline Io_Reg16 TCNT1{IO_TCNT1};
+inline Io_Reg8  TCCR2{IO_TCCR2}, TCNT2{IO_TCNT2}, OCR2{IO_OCR2};
+inline Io_Reg8  TIMSK{IO_TIMSK}, TIFR{IO_TIFR};
+inline Io_Reg8  UDR{IO_UDR},     UCSRA{IO_UCSRA}, UCSRB{IO_UCSRB};
+inline Io_Reg8  UCSRC{IO_UCSRC}, UBRRL{IO_UBRRL}, UBRRH{IO_UBRRH};
+inline Io_Reg8  ADMUX{IO_ADMUX}, ADCSR{IO_ADCSR}, ADCSRA{IO_ADCSR};
+inline Io_Reg16 ADC{IO_ADC},     ADCW{IO_ADC};
+inline Io_Reg8  ACSR{IO_ACSR},   WDTCR{IO_WDTCR}, MCUCR{IO_MCUCR};
+inline Io_Reg8  GICR{IO_GICR},   SFIOR{IO_SFIOR};
+
+//-------------------------------- Bits: -------------------------------------
+
+//Port bits:
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+//TCCR0, TCCR1B, TCCR2:
+#define CS00  0
+#define CS01  1
+#define CS02  2
+#define CS10  0
+#define CS11  1
+#define CS12  2
+#define WGM12 3
+#define CS20  0
+#define CS21  1
+#define CS22  2
+#define WGM21 3
+#define COM20 4
+#define COM21 5
+#define WGM20 6
+
+//TIMSK, TIFR:
+#define TOIE0  0
+#define TOIE1  2
+#define OCIE1B 3
+#define OCIE1A 4
+#define TICIE1 5
+#define TOIE2  6
+#define OCIE2  7
+#define TOV0   0
+#define TOV1   2
+#define OCF1B  3
+#define OCF1A  4
+#define ICF1   5
+#define TOV2   6
+#define OCF2   7
+
+//UCSRA, UCSRB:
+#define MPCM  0
+#define U2X   1
+#define PE    2
+#define DOR   3
+#define FE    4
+#define UDRE  5
+#define TXC   6
+#define RXC   7
+#define TXB8  0
+#define RXB8  1
+#define UCSZ2 2
+#define TXEN  3
+#define RXEN  4
+#define UDRIE 5
+#define TXCIE 6
+#define RXCIE 7
+
+//ADMUX, ADCSR:
+#define MUX0  0
+#define MUX1  1
+#define MUX2  2
+#define MUX3  3
+#define ADLAR 5
+#define REFS0 6
+#define REFS1 7
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE  3
+#define ADIF  4
+#define ADFR  5
+#define ADSC  6
+#define ADEN  7
+
+//ACSR, WDTCR:
+#define ACD  7
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDE  3
+#define WDCE 4
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,41 @@
+#!/bin/sh
+
+#-----------------------------------------------------------------------------
+
+#Frequency Counter FC-510
+#end-to-end latency benchmark on the emulator
+
+#Input steps from 1 MHz to 1.1 MHz after the result has settled.
+#Latency is the model time from the step until the display (lcd) and
+#the UART display copy (uart) show the new value rounded to the digits,
+#"-" - not shown in the wait time. Table per mode (F, P, A), gate time,
+#averaging and auto scale.
+
+#Usage: Emu/Latency.sh [emulator] (default Build/Emu1602)
+
+#-----------------------------------------------------------------------------
+
+EMU=${1:-Build/Emu1602}
+
+printf "%-4s %6s %4s %4s %10s %10s\n" mode gate avg auto lcd,s uart,s
+for m in 0:F:1100 2:P:0.000909091 10:A:1100; do  #MODE_xxx of Count.h
+  n=${m%%:*}; v=${m##*:}; name=${m#*:}; name=${name%%:*}
+  for g in 10 100 1000; do
+    for a in 1 4 16; do
+      for s in 1 0; do
+        #settle before the step, wait after it:
+        t=$(awk "BEGIN { print 4 + 2 * $g * $a / 1000 }")
+        w=$(awk "BEGIN { print 4 + 3 * $g * $a / 1000 }")
+        sc=""
+        [ $s = 0 ] && sc="-s scale$n=5"
+        r=$($EMU -s mode=$n -s gate=$g -s avg=$a $sc -t $(awk "BEGIN { print $t + $w }") \
+            -c "0 fin 1e6" -c "$t fin 1.1e6" -c "$t settle $v" 2>/dev/null | grep "^settle")
+        lcd=$(echo "$r" | sed 's/.* lcd \([^ ]*\) .*/\1/')
+        uart=$(echo "$r" | sed 's/.* uart \([^ ]*\)$/\1/')
+        printf "%-4s %6s %4s %4s %10s %10s\n" $name $g $a $s $lcd $uart
+      done
+    done
+  done
+done
+
+#-----------------------------------------------------------------------------
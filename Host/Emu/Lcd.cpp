@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: LCD controllers
+
+//----------------------------------------------------------------------------
+
+#include "Lcd.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define T_EXEC  Sec2Time(37E-6)      //command execution time
+#define T_CLEAR Sec2Time(1.52E-3)    //clear and home execution time
+#define T_POWER Sec2Time(10E-3)      //power on internal reset
+
+//------------------------------ Hd44780: ------------------------------------
+
+Hd44780::Hd44780(int lines, bool split)
+{
+  Lines = lines;
+  Split = split;
+  Busy = T_POWER;
+  for(auto &c : Ddram) c = ' ';
+}
+
+void Hd44780::Strobe(uint8_t d, bool rs, Time t)
+{
+  if(t < Busy) { Ignored++; return; }
+  d &= 0x0F;
+  if(Bit8) { Exec(d << 4, rs, t); return; } //D3..D0 are low
+  if(!Half) { Hi = d; Half = 1; return; }
+  Half = 0;
+  Exec((Hi << 4) | d, rs, t);
+}
+
+void Hd44780::Exec(uint8_t d, bool rs, Time t)
+{
+  Busy = t + T_EXEC;
+  if(rs)                             //data write
+  {
+    if(Cg) Cgram[Ac & 0x3F] = d;
+      else { Ddram[Ac & 0x7F] = d; Changed = 1; }
+    Ac = (Ac + (Inc? 1 : -1)) & (Cg? 0x3F : 0x7F);
+    return;
+  }
+  if(d & 0x80) { Ac = d & 0x7F; Cg = 0; return; }   //DDRAM address
+  if(d & 0x40) { Ac = d & 0x3F; Cg = 1; return; }   //CGRAM address
+  if(d & 0x20) { Bit8 = d & 0x10; Half = 0; return; } //function set
+  if(d & 0x10) return;                              //cursor shift
+  if(d & 0x08) { On = d & 0x04; Changed = 1; return; } //display on/off
+  if(d & 0x04) { Inc = d & 0x02; return; }          //entry mode
+  if(d & 0x02) { Ac = 0; Cg = 0; Busy = t + T_CLEAR; return; } //home
+  if(d & 0x01)                                      //clear
+  {
+    for(auto &c : Ddram) c = ' ';
+    Ac = 0; Cg = 0; Inc = 1;
+    Busy = t + T_CLEAR;
+    Changed = 1;
+  }
+}
+
+//user symbols (level bar) are shown as '#'
+
+std::string Hd44780::Text(void) const
+{
+  std::string s;
+  for(int l = 0; l < Lines; l++)
+  {
+    if(l) s += '|';
+    for(int i = 0; i < 16; i++)
+    {
+      int a = l * 0x40 + i;
+      if(Split && i > 7) a = 0x40 + (i & 7);
+      uint8_t c = On? Ddram[a] : ' ';
+      s += (c < 8)? '#' : (c < 0x20 || c > 0x7E)? '?' : (char)c;
+    }
+  }
+  return(s);
+}
+
+//-------------------------------- Mt10: -------------------------------------
+
+void Mt10::Write(uint8_t d)
+{
+  if(!(d & 0x10))                    //address
+  {
+    Addr = d & 0x0F;
+    High = 0;
+    return;
+  }
+  d &= 0x0F;
+  if(Addr == 0x0F) { On = d; Changed = 1; return; } //BLK register
+  if(!High) Seg[Addr] = (Seg[Addr] & 0xF0) | d;
+    else Seg[Addr] = (Seg[Addr] & 0x0F) | (d << 4);
+  High = !High;
+  if(!High) Addr = (Addr + 1) & 0x0F;
+  Changed = 1;
+}
+
+//segments to symbols, as Encode() in Lcd10.c,
+//point is shown as '.' after the symbol
+
+std::string Mt10::Text(void) const
+{
+  static const struct { uint8_t s; char c; } Font[] =
+  {
+    {0xEE, '0'}, {0x60, '1'}, {0x2F, '2'}, {0x6D, '3'}, {0xE1, '4'},
+    {0xCD, '5'}, {0xCF, '6'}, {0x68, '7'}, {0xEF, '8'}, {0xED, '9'},
+    {0xEB, 'A'}, {0xC7, 'b'}, {0x8E, 'C'}, {0x67, 'd'}, {0x8F, 'E'},
+    {0x8B, 'F'}, {0xCE, 'G'}, {0xE3, 'H'}, {0x86, 'L'}, {0x43, 'n'},
+    {0x47, 'o'}, {0xAB, 'P'}, {0x03, 'r'}, {0x87, 't'}, {0x46, 'u'},
+    {0x01, '-'}, {0x00, ' '}
+  };
+  std::string s;
+  for(int i = 0; i < 10; i++)
+  {
+    uint8_t g = On? Seg[i] : 0;
+    char c = '?';
+    for(auto &f : Font) if(f.s == (g & ~0x10)) { c = f.c; break; }
+    s += c;
+    if(g & 0x10) s += '.';
+  }
+  return(s);
+}
+
+//----------------------------------------------------------------------------
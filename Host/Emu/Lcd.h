@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host emulator: LCD controllers, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef LcdH
+#define LcdH
+
+#include <string>
+#include "../Cpld/Signal.h"
+
+//------------------------------ Display: ------------------------------------
+
+class Display
+{
+public:
+  bool Changed = 0;                  //contents changed since last take
+  virtual ~Display() {}
+  virtual std::string Text(void) const = 0; //lines, separated by '|'
+};
+
+//------------------------------ Hd44780: ------------------------------------
+
+//HD44780 in 4-bit wiring (D7..D4 only), data is taken on E fall.
+//Strobes are ignored while the controller is busy, as the real one
+//does, so 8-bit init commands with two nibbles keep sync.
+
+class Hd44780 : public Display
+{
+public:
+  Hd44780(int lines, bool split);    //split: 1x16 as 2x8 (LCD1601)
+  void Strobe(uint8_t d, bool rs, Time t); //E fall, D7..D4 = d
+  std::string Text(void) const override;
+  uint64_t Ignored = 0;              //strobes while busy
+
+private:
+  int Lines;                         //display lines
+  bool Split;                        //1601: chars 8..15 at 0x40
+  bool Bit8 = 1;                     //8-bit interface
+  bool Half = 0;                     //high nibble taken
+  uint8_t Hi = 0;                    //high nibble
+  Time Busy = 0;                     //busy until
+  uint8_t Ddram[128] = {};
+  uint8_t Cgram[64] = {};
+  int Ac = 0;                        //address counter
+  bool Cg = 0;                       //AC points to CGRAM
+  bool Inc = 1;                      //entry mode increment
+  bool On = 0;                       //display on
+  void Exec(uint8_t d, bool rs, Time t);
+};
+
+//-------------------------------- Mt10: -------------------------------------
+
+//MT10-T7: 10 digits of 7 segments and point, 5-bit writes:
+//bit 4 = 0 - address, bit 4 = 1 - data nibble, low nibble first,
+//address goes to next digit after two nibbles
+
+class Mt10 : public Display
+{
+public:
+  void Write(uint8_t d);
+  std::string Text(void) const override;
+
+private:
+  uint8_t Seg[16] = {};
+  int Addr = 0;
+  bool High = 0;                     //next nibble is high
+  bool On = 0;                       //bus enabled (BLK register)
+};
+
+//----------------------------------------------------------------------------
+
+#endif
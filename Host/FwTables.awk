@@ -0,0 +1,69 @@
+#-----------------------------------------------------------------------------
+
+#Frequency Counter FC-510
+#host: firmware tables for the host tools
+
+#Usage: awk -f FwTables.awk Menu.h Menu.c > FwTables.h
+#EEPROM signatures and sizes of the original layout become FW_xxx,
+#tables of Menu.c are copied as they are, #ifdef lines too, with
+#__flash dropped. Parameter names are PAR_xxx of Menu.h in lower case.
+#The enums themselves are taken from the firmware headers (Menu.h,
+#Count.h), so the host tools are built against the firmware layout.
+
+#-----------------------------------------------------------------------------
+
+BEGIN {
+  print "//Generated by FwTables.awk from Menu.h and Menu.c, do not edit"
+  print ""
+  print "#ifndef FwTablesH"
+  print "#define FwTablesH"
+  print ""
+}
+
+#table body up to "};":
+
+Copy {
+  print
+  if($0 ~ /^};/) { Copy = 0; print "" }
+  next
+}
+
+FILENAME ~ /Menu\.h$/ && $1 ~ /^PAR_[A-Z0-9]+,$/ {
+  n = substr($1, 5, length($1) - 5)
+  Names = Names "  \"" tolower(n) "\",\n"
+}
+
+#EEPROM layouts:
+
+FILENAME ~ /Menu\.c$/ && $1 == "#define" && $2 ~ /^(SIGNATURE|OLD_SIGN|OLD_PARAMS|OLD_MODES)$/ {
+  printf "#define FW_%-10s %s\n", $2, $3
+  Found[$2] = 1
+}
+
+FILENAME ~ /Menu\.c$/ && /__flash/ && match($0, /(ParLim|ParNext|Str_P|Str_V)\[[^=]*=/) {
+  d = substr($0, RSTART, RLENGTH)
+  t = substr(d, 1, index(d, "[") - 1)
+  Found[t] = 1
+  if(!Tables++) print ""
+  print "static const " (t == "ParLim"? "long" : "char") " Fw" d
+  Copy = 1
+}
+
+END {
+  if(Names == "") Missing = Missing " PAR_xxx"
+  split("SIGNATURE OLD_SIGN OLD_PARAMS OLD_MODES ParLim ParNext Str_P Str_V", Need, " ")
+  for(i in Need) if(!(Need[i] in Found)) Missing = Missing " " Need[i]
+  if(Missing != "")
+  {
+    print "FwTables.awk: not found:" Missing > "/dev/stderr"
+    exit 1
+  }
+  print "static const char *const FwParName[PARAMS] ="
+  print "{"
+  printf "%s", Names
+  print "};"
+  print ""
+  print "#endif"
+}
+
+#-----------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: three-cornered hat of simultaneous counters
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "Hat.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define SLIP 0.55                    //slot error to slip: half slot and jitter margin
+
+//------------------------------- Align: -------------------------------------
+
+//median interval, then mean interval over the whole span counted by
+//median steps: slots of long runs must not drift by median error
+
+static double Interval(const std::vector<int64_t> &t)
+{
+  std::vector<int64_t> d(t.size() - 1);
+  for(size_t i = 0; i < d.size(); i++) d[i] = t[i + 1] - t[i];
+  std::vector<int64_t> m = d;
+  std::nth_element(m.begin(), m.begin() + m.size() / 2, m.end());
+  double med = std::max(m[m.size() / 2], (int64_t)1);
+  uint64_t n = 0;
+  for(int64_t x : d) n += std::max(1LL, llround(x / med));
+  return((double)(t.back() - t.front()) / n / 1E9);
+}
+
+HatGrid Hat_Align(const std::vector<HatStream> &s, double tau0)
+{
+  HatGrid g = {};
+  g.St.resize(s.size());
+  g.Y.resize(s.size());
+  for(auto &x : s) if(x.Time.size() < 2) return(g);
+  g.Tau0 = tau0 > 0? tau0 : Interval(s[0].Time);
+  g.T0 = s[0].Time[0];
+  for(auto &x : s) g.T0 = std::min(g.T0, x.Time[0]);
+  double ns = g.Tau0 * 1E9;
+
+  //slots of samples:
+  std::vector<std::vector<int64_t>> slot(s.size());
+  std::vector<int64_t> last(s.size());
+  for(size_t i = 0; i < s.size(); i++)
+  {
+    const HatStream &x = s[i];
+    HatGrid::Stat &st = g.St[i];
+    int64_t k = llround((x.Time[0] - g.T0) / ns);
+    slot[i].assign(x.Time.size(), -1);
+    slot[i][0] = k;
+    for(size_t j = 1; j < x.Time.size(); j++)
+    {
+      int64_t n = k + std::max(1LL, llround((x.Time[j] - x.Time[j - 1]) / ns));
+      double d = (x.Time[j] - g.T0) / ns - n;
+      if(d > SLIP) { n++; st.Slips++; }
+      if(d < -SLIP) { n--; st.Slips++; }
+      if(n <= k) { st.Dups++; continue; }
+      slot[i][j] = k = n;
+    }
+    last[i] = k;
+    g.N = std::max(g.N, (size_t)k + 1);
+  }
+
+  //values by slot, mean removed:
+  std::vector<std::vector<uint8_t>> has(s.size(), std::vector<uint8_t>(g.N));
+  for(size_t i = 0; i < s.size(); i++)
+  {
+    g.Y[i].assign(g.N, 0);
+    double mean = 0;
+    for(size_t j = 0; j < s[i].Y.size(); j++)
+      if(slot[i][j] >= 0)
+      {
+        g.Y[i][slot[i][j]] = s[i].Y[j];
+        has[i][slot[i][j]] = 1;
+        mean += s[i].Y[j];
+        g.St[i].Taken++;
+      }
+    mean /= g.St[i].Taken;
+    for(size_t k = 0; k < g.N; k++)
+      if(has[i][k]) g.Y[i][k] -= mean;
+    g.St[i].Missing = last[i] - slot[i][0] + 1 - g.St[i].Taken;
+  }
+  g.Ok.assign(g.N, 1);
+  for(auto &h : has)
+    for(size_t k = 0; k < g.N; k++) g.Ok[k] &= h[k];
+  return(g);
+}
+
+//------------------------------ Variance: -----------------------------------
+
+//Prefix sums of values (p) and of common slots (c): averages of m
+//slots and their completeness are differences, no loop over m.
+
+static void Prefix(const HatGrid &g, size_t stream, std::vector<double> &p,
+                   std::vector<uint64_t> &c)
+{
+  p.assign(g.N + 1, 0);
+  c.assign(g.N + 1, 0);
+  for(size_t k = 0; k < g.N; k++)
+  {
+    p[k + 1] = p[k] + (g.Ok[k]? g.Y[stream][k] : 0);
+    c[k + 1] = c[k] + g.Ok[k];
+  }
+}
+
+static double Avar(const double *p, const uint64_t *c, size_t n, uint64_t m, uint64_t *terms)
+{
+  double s = 0;
+  uint64_t t = 0;
+  size_t e = n >= 2 * m? n - 2 * m + 1 : 0;
+  #pragma omp simd reduction(+:s, t)
+  for(size_t k = 0; k < e; k++)
+  {
+    bool ok = c[k + 2 * m] - c[k] == 2 * m;
+    double d = (p[k + 2 * m] - 2 * p[k + m] + p[k]) / m;
+    s += ok? d * d : 0;
+    t += ok;
+  }
+  if(terms) *terms = t;
+  return(t? s / (2 * t) : NAN);
+}
+
+double Hat_Avar(const HatGrid &g, size_t stream, uint64_t m, uint64_t *terms)
+{
+  std::vector<double> p;
+  std::vector<uint64_t> c;
+  Prefix(g, stream, p, c);
+  return(Avar(p.data(), c.data(), g.N, m, terms));
+}
+
+//------------------------------- Hat: ---------------------------------------
+
+std::vector<HatPoint> Hat_Calc(const HatGrid &g, int threads)
+{
+  std::vector<HatPoint> r;
+  if(g.Y.size() != HAT_PAIRS) return(r);
+  for(uint64_t m = 1; 2 * m < g.N; m *= 2)
+    r.push_back({m, m * g.Tau0, 0, {}, {}});
+
+  std::vector<double> p[HAT_PAIRS];
+  std::vector<uint64_t> c;
+  for(size_t i = 0; i < HAT_PAIRS; i++) Prefix(g, i, p[i], c);
+
+  //tau and stream jobs to threads:
+  size_t jobs = r.size() * HAT_PAIRS;
+  if(threads <= 0) threads = std::thread::hardware_concurrency();
+  if(threads > (int)jobs) threads = jobs;
+  if(threads < 1) threads = 1;
+  std::atomic<size_t> next(0);
+  auto work = [&]
+  {
+    for(size_t j; (j = next++) < jobs;)
+    {
+      HatPoint &x = r[j / HAT_PAIRS];
+      uint64_t t;
+      x.Pair[j % HAT_PAIRS] = Avar(p[j % HAT_PAIRS].data(), c.data(), g.N, x.M, &t);
+      if(!(j % HAT_PAIRS)) x.Terms = t;
+    }
+  };
+  std::vector<std::thread> t;
+  for(int i = 1; i < threads; i++) t.emplace_back(work);
+  work();
+  for(auto &i : t) i.join();
+
+  for(auto &x : r)
+  {
+    double ab = x.Pair[0], bc = x.Pair[1], ca = x.Pair[2];
+    x.Var[0] = (ab + ca - bc) / 2;
+    x.Var[1] = (ab + bc - ca) / 2;
+    x.Var[2] = (bc + ca - ab) / 2;
+  }
+  return(r);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: three-cornered hat of simultaneous counters, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef HatH
+#define HatH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//----------------------------- Constants: -----------------------------------
+
+#define HAT_PAIRS 3                  //streams: A-B, B-C, C-A
+
+//------------------------------ Streams: ------------------------------------
+
+//One counter result stream: capture times (ns) and fractional frequency
+//of the measured oscillator to the counter reference.
+
+struct HatStream
+{
+  std::vector<int64_t> Time;
+  std::vector<double> Y;
+};
+
+//Streams on common time grid of tau0 slots from the earliest sample.
+//A stream is stepped by its own intervals, so capture jitter does not
+//move samples to next slots, and is kept to the host clock: a slower
+//or faster counter slips one slot when it is over half slot off.
+//Missing slots are dropped samples, second sample of slot is dropped.
+
+struct HatGrid
+{
+  struct Stat
+  {
+    uint64_t Taken;                  //samples on grid
+    uint64_t Missing;                //empty slots in stream span
+    uint64_t Dups;                   //samples dropped as second in slot
+    uint64_t Slips;                  //slot corrections to host clock
+  };
+  int64_t T0;                        //first slot time, ns
+  double Tau0;                       //slot, s
+  size_t N;                          //slots
+  std::vector<std::vector<double>> Y; //stream values by slot, mean removed
+  std::vector<uint8_t> Ok;           //all streams have slot
+  std::vector<Stat> St;
+};
+
+//------------------------------- Point: -------------------------------------
+
+//Allan variances of the streams over slots common to all of them,
+//oscillator variances by three-cornered hat:
+//A = (AB + CA - BC) / 2, B = (AB + BC - CA) / 2, C = (BC + CA - AB) / 2.
+//Oscillator variance below noise of the others may come out negative.
+
+struct HatPoint
+{
+  uint64_t M;                        //averaging factor
+  double Tau;                        //tau, s
+  uint64_t Terms;                    //ADEV terms with no missing slot
+  double Pair[HAT_PAIRS];            //stream Allan variances
+  double Var[HAT_PAIRS];             //oscillator A, B, C Allan variances
+};
+
+//------------------------------ Functions: ----------------------------------
+
+//tau0 - slot, s, 0 - mean interval of first stream
+HatGrid Hat_Align(const std::vector<HatStream> &s, double tau0 = 0);
+//overlapping Allan variance of stream over slots of Ok, O(N),
+//terms - differences taken
+double Hat_Avar(const HatGrid &g, size_t stream, uint64_t m, uint64_t *terms = nullptr);
+//all tau octaves, taus and streams to threads (0 - all cores)
+std::vector<HatPoint> Hat_Calc(const HatGrid &g, int threads = 0);
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: three-cornered hat of three counters
+
+//Usage: Hat [-m mode] [-g tau0] [-j threads] ab.col bc.col ca.col
+//ab.col - columnar result file (Host/Col) of counter measuring
+//oscillator A with reference B, and so on around the hat.
+//-m mode     result mode (Count.h), default - mode of first row
+//-g tau0     result interval, s, default - median of first file
+//-j threads  threads, default - all cores
+//Negative oscillator variance (below noise of the others) is shown
+//as negative deviation.
+
+//----------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "Hat.h"
+#include "../Col/Col.h"
+
+//------------------------------ Helpers: ------------------------------------
+
+//results of mode as fractional frequency to their mean
+
+static bool Load(const char *path, int mode, HatStream &s)
+{
+  ColReader r;
+  if(!r.Open(path)) { fprintf(stderr, "Hat: bad file %s\n", path); return(0); }
+  for(size_t b = 0; b < r.Blocks(); b++)
+  {
+    ColReader::Block c = r.Get(b);
+    for(size_t k = 0; k < c.Rows; k++)
+    {
+      if(mode < 0) mode = c.Mode[k];
+      if(c.Mode[k] != mode) continue;
+      ColRow v = {};
+      v.Mant = c.Mant[k];
+      v.Dec = c.Dec[k];
+      s.Time.push_back(c.Time[k]);
+      s.Y.push_back(v.Value());
+    }
+  }
+  double mean = 0;
+  for(double v : s.Y) mean += v;
+  if(s.Y.size() < 2 || mean == 0) { fprintf(stderr, "Hat: too few results in %s\n", path); return(0); }
+  mean /= s.Y.size();
+  for(double &v : s.Y) v = v / mean - 1;
+  return(1);
+}
+
+static double Dev(double v)
+{
+  return(v < 0? -sqrt(-v) : sqrt(v));
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  int mode = -1, threads = 0;
+  double tau0 = 0;
+  int o;
+  while((o = getopt(argc, argv, "m:g:j:")) != -1)
+  {
+    switch(o)
+    {
+    case 'm': mode = atoi(optarg); break;
+    case 'g': tau0 = atof(optarg); break;
+    case 'j': threads = atoi(optarg); break;
+    default: optind = argc; break;
+    }
+  }
+  if(argc - optind != HAT_PAIRS)
+  {
+    fprintf(stderr, "Usage: Hat [-m mode] [-g tau0] [-j threads] ab.col bc.col ca.col\n");
+    return(2);
+  }
+  std::vector<HatStream> s(HAT_PAIRS);
+  for(int i = 0; i < HAT_PAIRS; i++)
+    if(!Load(argv[optind + i], mode, s[i])) return(1);
+
+  HatGrid g = Hat_Align(s, tau0);
+  for(int i = 0; i < HAT_PAIRS; i++)
+    fprintf(stderr, "%s: %llu results, %llu missing, %llu dropped, %llu slips\n",
+            argv[optind + i], (unsigned long long)g.St[i].Taken,
+            (unsigned long long)g.St[i].Missing, (unsigned long long)g.St[i].Dups,
+            (unsigned long long)g.St[i].Slips);
+  printf("#tau m terms adev_ab adev_bc adev_ca adev_a adev_b adev_c\n");
+  for(auto &p : Hat_Calc(g, threads))
+    printf("%g %llu %llu %.6e %.6e %.6e %.6e %.6e %.6e\n", p.Tau, (unsigned long long)p.M,
+           (unsigned long long)p.Terms, Dev(p.Pair[0]), Dev(p.Pair[1]), Dev(p.Pair[2]),
+           Dev(p.Var[0]), Dev(p.Var[1]), Dev(p.Var[2]));
+  return(0);
+}
+
+//----------------------------------------------------------------------------
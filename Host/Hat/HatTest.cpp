@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of three-cornered hat
+
+//Three oscillators of known white FM noise are measured pairwise by
+//three counters with their own phase, capture jitter, dropped
+//samples, a long gap and, for one counter, a slower result rate.
+//Aligned values must be the true ones of their slots and the hat
+//must find every oscillator noise.
+
+//Usage: HatTest [-n slots] [-j threads]
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unistd.h>
+#include "Hat.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define N_SLOTS 200000               //default slots
+#define TAU0    1E9                  //result interval, ns
+#define JITTER  2000000              //capture jitter, ns
+#define DROP    100                  //one sample of DROP is dropped
+#define T_START 1700000000000000000LL //first slot time, ns
+
+static const double Sigma[HAT_PAIRS] = {1E-9, 2E-9, 0.5E-9}; //oscillators A, B, C
+
+//------------------------------ Variables: ----------------------------------
+
+static int Fails;
+
+//------------------------------- Check: -------------------------------------
+
+static void Check(bool c, const char *what)
+{
+  if(c) return;
+  printf("FAILED: %s\n", what);
+  Fails++;
+}
+
+//-------------------------------- Test: -------------------------------------
+
+//truth: oscillator y by slot, stream i measures i against i + 1
+
+static void TestHat(size_t n, int threads)
+{
+  std::mt19937_64 g(510);
+  std::vector<double> y[HAT_PAIRS];
+  for(int i = 0; i < HAT_PAIRS; i++)
+  {
+    std::normal_distribution<double> w(0, Sigma[i]);
+    y[i].resize(n);
+    for(auto &v : y[i]) v = w(g);
+  }
+  std::vector<HatStream> s(HAT_PAIRS);
+  std::vector<std::vector<int64_t>> truth(HAT_PAIRS);
+  std::uniform_int_distribution<int64_t> jit(-JITTER, JITTER);
+  const double rate[HAT_PAIRS] = {1.0, 1.0, 1.00002}; //C-A counter is slower
+  const int64_t phase[HAT_PAIRS] = {0, 300000000, 150000000};
+  for(int i = 0; i < HAT_PAIRS; i++)
+  {
+    for(size_t k = 0; ; k++)
+    {
+      double t = phase[i] + k * TAU0 * rate[i];
+      int64_t slot = llround(t / TAU0);
+      if(slot >= (int64_t)n) break;
+      if(g() % DROP == 0 || (slot > (int64_t)n / 3 && slot < (int64_t)n / 3 + 500)) continue;
+      int j = (i + 1) % HAT_PAIRS;
+      s[i].Time.push_back(T_START + (int64_t)t + jit(g));
+      s[i].Y.push_back(y[i][slot] - y[j][slot]);
+      truth[i].push_back(slot);
+    }
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  HatGrid a = Hat_Align(s);
+  std::vector<HatPoint> r = Hat_Calc(a, threads);
+  double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  Check(fabs(a.Tau0 * 1E9 - TAU0) < JITTER, "tau0");
+  Check(!a.St[0].Slips && !a.St[1].Slips && a.St[2].Slips, "slips");
+  size_t common = 0;
+  for(size_t k = 0; k < a.N; k++) common += a.Ok[k];
+  Check(common > n * 9 / 10, "common slots");
+
+  //values on true slots, but for the stream mean removed; slower
+  //counter may take next slot near slot edge:
+  for(int i = 0; i < HAT_PAIRS; i++)
+  {
+    int j = (i + 1) % HAT_PAIRS;
+    std::vector<double> d;
+    for(int64_t k : truth[i])
+      if(k < (int64_t)a.N && a.Ok[k]) d.push_back(a.Y[i][k] - (y[i][k] - y[j][k]));
+    std::vector<double> m = d;
+    std::nth_element(m.begin(), m.begin() + m.size() / 2, m.end());
+    size_t wrong = 0;
+    for(double v : d) wrong += fabs(v - m[m.size() / 2]) > 1E-15;
+    Check(i < 2? !wrong : wrong < d.size() / 10, "aligned values");
+  }
+
+  //hat:
+  Check(r.size() > 10, "taus");
+  for(size_t q : {0, 4})
+    for(int i = 0; i < HAT_PAIRS; i++)
+    {
+      double e = Sigma[i] / sqrt((double)r[q].M), v = sqrt(r[q].Var[i]);
+      char m[64];
+      snprintf(m, sizeof(m), "oscillator %c, m = %llu", 'A' + i, (unsigned long long)r[q].M);
+      Check(fabs(v / e - 1) < (q? 0.15 : 0.05), m);
+    }
+  printf("%zu slots, %zu common, %llu missing, %llu slips: %.3f s\n", a.N, common,
+         (unsigned long long)(a.St[0].Missing + a.St[1].Missing + a.St[2].Missing),
+         (unsigned long long)a.St[2].Slips, dt);
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  size_t n = N_SLOTS;
+  int threads = 0;
+  int o;
+  while((o = getopt(argc, argv, "n:j:")) != -1)
+  {
+    if(o == 'n') n = strtoull(optarg, nullptr, 10);
+    else if(o == 'j') threads = atoi(optarg);
+    else { fprintf(stderr, "Usage: HatTest [-n slots] [-j threads]\n"); return(2); }
+  }
+  TestHat(n, threads);
+  printf(Fails? "FAILED\n" : "PASSED\n");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
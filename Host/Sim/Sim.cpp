@@ -0,0 +1,554 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: simulator of many counters on ptys
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Sim.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define EVENTS   256                 //events per epoll_wait
+#define READ_BUF 256                 //read block
+#define ID_EV    UINT64_MAX          //epoll id of stop eventfd
+#define ID_SIG   (UINT64_MAX - 1)    //epoll id of signalfd
+
+#define T_SPLASH 2500                //splash screen time, ms, as Menu.c
+#define T_AUTO   2000                //auto scale indication time, ms
+#define T_BLINK  250                 //hold blink time, ms
+#define T_FOREVER INT64_MAX
+
+#define SCALE_NOM 4                  //decimals shown at start, kHz
+#define SCALE_MAX 8
+#define VAL_CHR  9                   //value field, as Disp_Val (HI_RES)
+
+#define CMD_HDR  '#'                 //as Port.c
+#define RSP_HDR  '$'
+#define ADR_BRD  0
+#define PAR_CMD  'P'                 //parameter command ("Pnn", "Pnn=value")
+#define PAR_DIG  9                   //max value digits
+
+#define ID_TEXT  "FC-510 V2.1"
+#define GARBAGE  24                  //longest garbage line
+
+enum { MNU_SPLASH, MNU_MAIN, MNU_AUTO, MNU_SETUP };
+
+//Firmware tables (ParLim, ParNext, Str_P, Str_V, names as Emu -s) of the
+//LCD16xx build:
+
+#define HI_RES
+#include "Count.h"
+#include "Meter.h"
+#include "FwTables.h"
+
+//------------------------------ Options: ------------------------------------
+
+SimOpt::SimOpt()
+{
+  Freq = 1E6;
+  Step = 1E-6;
+  Noise = 1E-9;
+  Jitter = 0;
+  Drop = 0;
+  Outage = 0;
+  Garbage = 0;
+  Splash = 1;
+  Seed = 510;
+  for(int i = 0; i < PARAMS; i++) Par[i] = FwParLim[i][P_NOM];
+}
+
+bool SimOpt::Set(const char *s)
+{
+  char n[16];
+  long v;
+  if(sscanf(s, "%15[^=]=%ld", n, &v) == 2)
+    for(int i = 0; i < PARAMS; i++)
+      if(!strcmp(n, FwParName[i]) && v >= FwParLim[i][P_MIN] && v <= FwParLim[i][P_MAX])
+        { Par[i] = v; return(1); }
+  return(0);
+}
+
+//------------------------------ Simulator: ----------------------------------
+
+Sim::Sim(const SimOpt &o) : Opt(o), Rnd(o.Seed)
+{
+  Ep = epoll_create1(EPOLL_CLOEXEC);
+  Ev = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  Sig = -1;
+  T0 = 0;
+  T0 = Now();
+  struct epoll_event e = {};
+  e.events = EPOLLIN;
+  e.data.u64 = ID_EV;
+  epoll_ctl(Ep, EPOLL_CTL_ADD, Ev, &e);
+}
+
+Sim::~Sim()
+{
+  for(auto &d : Devs)
+  {
+    if(!d.Link.empty()) unlink(d.Link.c_str());
+    close(d.Fd);
+    close(d.Slave);
+  }
+  close(Ep); close(Ev);
+  if(Sig >= 0) close(Sig);
+}
+
+bool Sim::Signals(void)
+{
+  sigset_t s;
+  sigemptyset(&s);
+  sigaddset(&s, SIGINT);
+  sigaddset(&s, SIGTERM);
+  if(sigprocmask(SIG_BLOCK, &s, nullptr)) return(0);
+  Sig = signalfd(-1, &s, SFD_NONBLOCK | SFD_CLOEXEC);
+  if(Sig < 0) return(0);
+  struct epoll_event e = {};
+  e.events = EPOLLIN;
+  e.data.u64 = ID_SIG;
+  return(!epoll_ctl(Ep, EPOLL_CTL_ADD, Sig, &e));
+}
+
+int64_t Sim::Now(void) const
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return((int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000 - T0);
+}
+
+//Slave is kept open, so the master has no hangup while no host has
+//the device open, as Emu -p. Device index is the epoll id.
+
+bool Sim::Add(const std::string &link)
+{
+  Dev d = {};
+  d.Fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if(d.Fd < 0) return(0);
+  if(grantpt(d.Fd) || unlockpt(d.Fd)) { close(d.Fd); return(0); }
+  d.Name = ptsname(d.Fd);
+  d.Slave = open(d.Name.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if(d.Slave < 0) { close(d.Fd); return(0); }
+  struct termios tio;
+  tcgetattr(d.Fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(d.Fd, TCSANOW, &tio);
+  if(!link.empty())
+  {
+    unlink(link.c_str());
+    if(symlink(d.Name.c_str(), link.c_str()))
+      { close(d.Fd); close(d.Slave); return(0); }
+    d.Link = link;
+  }
+  d.F = Opt.Freq * (1 + Opt.Step * Devs.size());
+  memcpy(d.Par, Opt.Par, sizeof(d.Par));
+  d.Scale = SCALE_NOM;
+  d.Quiet = -1;
+  Devs.push_back(d);
+  Dev &n = Devs.back();
+  struct epoll_event e = {};
+  e.events = EPOLLIN;
+  e.data.u64 = Devs.size() - 1;
+  epoll_ctl(Ep, EPOLL_CTL_ADD, n.Fd, &e);
+
+  //results of all devices are spread over the gate:
+  int64_t t = Now();
+  n.Due = t + Opt.Par[PAR_GATE] * (int64_t)(Rnd() % 1000) / 1000;
+  if(Opt.Splash) Enter(n, MNU_SPLASH, t);
+    else Enter(n, MNU_MAIN, t);
+  return(1);
+}
+
+void Sim::Stop(void)
+{
+  uint64_t one = 1;
+  if(write(Ev, &one, sizeof(one)) < 0) {}
+}
+
+//------------------------------- Loop: --------------------------------------
+
+void Sim::Run(int64_t ms)
+{
+  struct epoll_event ev[EVENTS];
+  int64_t end = ms < 0? T_FOREVER : Now() + ms;
+  while(1)
+  {
+    int64_t t = Now();
+    if(t >= end) return;
+    while(!Queue.empty() && Queue.top().first <= t)
+    {
+      Event e = Queue.top();
+      Queue.pop();
+      Dev &d = Devs[e.second];
+      if(d.Timer == e.first) Tick(d, t); //others are moved timers
+    }
+    int64_t next = std::min(end, Queue.empty()? T_FOREVER : Queue.top().first);
+    int w = next == T_FOREVER? -1 : (int)(next - t);
+    int n = epoll_wait(Ep, ev, EVENTS, w);
+    if(n < 0 && errno != EINTR) break;
+    t = Now();
+    for(int i = 0; i < n; i++)
+    {
+      uint64_t id = ev[i].data.u64;
+      if(id == ID_EV || id == ID_SIG) return;
+      Read(Devs[id], t);
+    }
+  }
+}
+
+void Sim::Schedule(Dev &d, int64_t t)
+{
+  d.Timer = t;
+  if(t != T_FOREVER) Queue.push(Event(t, &d - Devs.data()));
+}
+
+void Sim::Read(Dev &d, int64_t t)
+{
+  char buf[READ_BUF];
+  ssize_t n;
+  while((n = read(d.Fd, buf, sizeof(buf))) > 0)
+    for(ssize_t i = 0; i < n; i++) Command(d, buf[i], t);
+}
+
+//--------------------------------- Menus: -----------------------------------
+
+void Sim::Enter(Dev &d, int menu, int64_t t)
+{
+  d.Menu = menu;
+  switch(menu)
+  {
+  case MNU_SPLASH: Schedule(d, t + T_SPLASH); break;
+  case MNU_AUTO:   Schedule(d, t + T_AUTO); break;
+  case MNU_SETUP:  Schedule(d, T_FOREVER); break; //counter stopped
+  case MNU_MAIN:
+    if(d.Due < t) d.Due = t + d.Par[PAR_GATE];
+    Schedule(d, d.Hold? t + T_BLINK : d.Due);
+  }
+  Draw(d);
+}
+
+//timer: menu timeout, hold blink or result
+
+void Sim::Tick(Dev &d, int64_t t)
+{
+  if(d.Menu == MNU_SPLASH || d.Menu == MNU_AUTO) { Enter(d, MNU_MAIN, t); return; }
+  if(d.Menu != MNU_MAIN) return;
+  if(d.Hold)
+  {
+    d.Hide = !d.Hide;
+    Schedule(d, t + T_BLINK);
+    Draw(d);
+    return;
+  }
+  Result(d, d.Due);                  //time of gate end
+  d.Due += d.Par[PAR_GATE];
+  if(d.Due < t) d.Due = t;           //host was too slow to keep up
+  std::uniform_int_distribution<int> j(-Opt.Jitter, Opt.Jitter);
+  int64_t n = d.Due + (Opt.Jitter? j(Rnd) : 0);
+  Schedule(d, n > t? n : t + 1);
+}
+
+//Rx_Int: letters, "#nnC" in addressed mode, parameter commands up to
+//CR or LF, a char not of the command drops it and is taken as letter
+
+void Sim::Command(Dev &d, char c, int64_t t)
+{
+  if(t < d.Quiet) return;            //line is down
+  if(d.ParCmd)
+  {
+    if((c >= '0' && c <= '9') || c == '=' || c == '-') { d.RxPar += c; return; }
+    d.ParCmd = 0;
+    if(c == '\r' || c == '\n') { Param(d, t); return; }
+  }
+  int a = d.Par[PAR_ADR];
+  if(a)
+  {
+    if(c == CMD_HDR) { d.RxState = 1; d.RxAddr = 0; return; }
+    if(d.RxState == 1 || d.RxState == 2)
+    {
+      if(c >= '0' && c <= '9') { d.RxAddr = d.RxAddr * 10 + c - '0'; d.RxState++; }
+        else d.RxState = 0;
+      return;
+    }
+    if(d.RxState != 3) return;
+    d.RxState = 0;
+    if(d.RxAddr == ADR_BRD) { if(c == 'R' || c == '?') return; }
+      else if(d.RxAddr != a) return;
+  }
+  d.St.Keys++;
+  switch(c)
+  {
+  case PAR_CMD:
+    d.ParCmd = 1;
+    d.RxPar.clear();
+    d.RxBrd = a && d.RxAddr == ADR_BRD;
+    break;
+  case 'R': Send(d, Head(d) + d.Shown, 0); break;
+  case '?': Send(d, Head(d) + ID_TEXT, 0); break;
+  case 'S':                          //Count_Sync: gate starts now
+    d.Seq = 1;
+    d.Due = t + d.Par[PAR_GATE];
+    if(d.Menu == MNU_MAIN && !d.Hold) Schedule(d, d.Due);
+    break;
+  case 'M': case 'U': case 'D': case 'K': case 'A': case 'C':
+    Key(d, c, t);
+  }
+}
+
+//ParCommand() of Menu.c: query answers Par[], set takes a value of
+//the ParUpDn() grid out of setup menu, restarts the gate if it is new
+
+void Sim::Param(Dev &d, int64_t t)
+{
+  const std::string &s = d.RxPar;
+  size_t n = s.size();
+  if(n < 2 || !isdigit(s[0]) || !isdigit(s[1])) return;
+  int m = (s[0] - '0') * 10 + (s[1] - '0');
+  if(m >= PARAMS) return;
+  if(n > 2)                          //set: "=", optional "-", 1..PAR_DIG digits
+  {
+    size_t i = 3 + (n > 3 && s[3] == '-');
+    if(s[2] != '=' || i >= n || n - i > PAR_DIG ||
+       s.find_first_not_of("0123456789", i) != std::string::npos) return;
+    long v = atol(s.c_str() + 3);
+    if(d.Menu != MNU_SETUP && d.Par[m] != v && Valid(d, m, v))
+    {
+      d.Par[m] = v;
+      if(m == PAR_WIN) d.Par[PAR_WLEN] = v? 1000 : WIN_SIZE;
+      if(d.Menu == MNU_MAIN)         //Count_Start(): new gate
+      {
+        d.Due = t + d.Par[PAR_GATE];
+        Enter(d, MNU_MAIN, t);
+      }
+    }
+  }
+  if(d.RxBrd) return;                //broadcast, no response
+  char a[32];
+  snprintf(a, sizeof(a), "P%02d=%ld", m, d.Par[m]);
+  Send(d, Head(d) + a, 0);
+}
+
+//ParValid(): limits and the grid of Step()
+
+bool Sim::Valid(const Dev &d, int m, long v)
+{
+  long max = FwParLim[m][P_MAX];
+  if(m == PAR_WLEN && !d.Par[PAR_WIN]) max = WIN_SIZE;
+  if(v < FwParLim[m][P_MIN] || v > max) return(0);
+  bool e = m == PAR_SIF || m == PAR_SRF;
+  if(e || m == PAR_GATE || m == PAR_AVG || (m == PAR_WLEN && d.Par[PAR_WIN]))
+  {
+    while(!(v % 10)) v = v / 10;
+    return(v == 1 || (!e && (v == 2 || v == 5)));
+  }
+  return(1);
+}
+
+//keys as Mnu_Splash(), Mnu_Main(), Mnu_Auto(), Mnu_Setup()
+
+void Sim::Key(Dev &d, char k, int64_t t)
+{
+  switch(d.Menu)
+  {
+  case MNU_SPLASH:
+    Enter(d, MNU_MAIN, t);
+    break;
+  case MNU_MAIN:
+    if(k == 'M' && d.Hold) { d.Hold = d.Hide = 0; Enter(d, MNU_MAIN, t); }
+    else if(k == 'M' || k == 'C')
+    {
+      d.Param = k == 'M'? PAR_MODE : PAR_RF;
+      Enter(d, MNU_SETUP, t);
+    }
+    else if(k == 'K')
+    {
+      d.Hold = !d.Hold;
+      d.Hide = d.Hold;
+      Enter(d, MNU_MAIN, t);
+    }
+    else if(k == 'U' && d.Scale < SCALE_MAX) { d.Scale++; Draw(d); }
+    else if(k == 'D' && d.Scale > 0) { d.Scale--; Draw(d); }
+    else if(k == 'A') { d.Auto = !d.Auto; Enter(d, MNU_AUTO, t); }
+    break;
+  case MNU_SETUP:
+    if(k == 'M' && FwParNext[d.Param] != PARAMS) { d.Param = FwParNext[d.Param]; Draw(d); break; }
+    if(k == 'M') k = 'K';            //last parameter: OK
+    if(k == 'K' && (d.Param == PAR_SIF || d.Param == PAR_SRF)) k = 'A'; //back to IF, RF
+    if(k == 'K') Enter(d, MNU_MAIN, t); //SetupExit()
+    else if((k == 'U' || k == 'D') && Step(d, k == 'U')) Draw(d);
+    else if(k == 'A')                //UP + DOWN: IF, RF and their steps
+    {
+      static const int Swap[][2] =
+        {{PAR_IF, PAR_SIF}, {PAR_RF, PAR_SRF}, {PAR_SIF, PAR_IF}, {PAR_SRF, PAR_RF}};
+      for(auto &w : Swap)
+        if(d.Param == w[0]) { d.Param = w[1]; Draw(d); break; }
+    }
+    else if(k == 'C') { d.Par[d.Param] = FwParLim[d.Param][P_NOM]; Draw(d); }
+    break;
+  }                                  //auto scale menu blocks keys
+}
+
+//ParUpDn(): 1-2-5 for gate, average and time window length, decades
+//for the IF and RF steps, steps of the step parameters for IF and RF,
+//1 for others; window type change sets its default length
+
+bool Sim::Step(Dev &d, bool up)
+{
+  int m = d.Param;
+  long v = d.Par[m];
+  long min = FwParLim[m][P_MIN], max = FwParLim[m][P_MAX];
+  if(m == PAR_WLEN && !d.Par[PAR_WIN]) max = WIN_SIZE;
+  if(up? v >= max : v <= min) return(0);
+  if(m == PAR_GATE || m == PAR_AVG || (m == PAR_WLEN && d.Par[PAR_WIN]))
+  {
+    long e = 1;
+    while(e * 10 <= v) e = e * 10;
+    if(up) v = v == 2 * e? v * 5 / 2 : v * 2;
+      else v = v == 5 * e? v * 2 / 5 : v / 2;
+  }
+  else if(m == PAR_SIF || m == PAR_SRF) v = up? v * 10 : v / 10;
+  else
+  {
+    long s = m == PAR_IF? d.Par[PAR_SIF] : m == PAR_RF? d.Par[PAR_SRF] : 1;
+    v = v - v % s + (up? s : -s);
+  }
+  d.Par[m] = std::max(min, std::min(max, v));
+  if(m == PAR_WIN) d.Par[PAR_WLEN] = v? 1000 : WIN_SIZE;
+  return(1);
+}
+
+//---------------------------------- Output: ---------------------------------
+
+void Sim::Result(Dev &d, int64_t t)
+{
+  std::normal_distribution<double> w(0, Opt.Noise);
+  double f = d.F * (1 + w(Rnd));
+  int mode = d.Par[PAR_MODE];
+  d.Value = mode == MODE_P? 1E3 / f : f / 1E3; //ms or kHz
+  d.Num++;
+  d.St.Results++;
+  if(d.Seq) d.Seq++;
+  if(d.Par[PAR_OUT] && !d.Par[PAR_ADR])
+  {
+    char s[64];
+    snprintf(s, sizeof(s), "%u,%lld,%d,%.9f", d.Num, (long long)t, mode, d.Value);
+    Send(d, s, 1);
+  }
+  Draw(d);
+}
+
+//display text (16 chars of LCD line 1), as Show_Main(), Show_Setup()
+
+void Sim::Draw(Dev &d)
+{
+  char s[64];
+  long v = d.Par[d.Param];
+  switch(d.Menu)
+  {
+  case MNU_SPLASH: snprintf(s, sizeof(s), "     FC-510     "); break;
+  case MNU_AUTO:   snprintf(s, sizeof(s), "    Auto %-3s    ", d.Auto? "On" : "Off"); break;
+  case MNU_MAIN:
+    {
+      int mode = d.Par[PAR_MODE];
+      char val[32];
+      int dec = d.Scale;
+      if(!d.Num) snprintf(val, sizeof(val), "%.*f", dec, 0.0);
+        else snprintf(val, sizeof(val), "%.*f", dec, d.Value);
+      if(strlen(val) > VAL_CHR + 1) memset(val, '-', VAL_CHR + 1), val[VAL_CHR + 1] = 0;
+      snprintf(s, sizeof(s), "%s%*s %s", d.Hide? "   " : FwStr_V[mode], VAL_CHR, val,
+               mode == MODE_P? "ms " : "kHz");
+      break;
+    }
+  default:
+    switch(d.Param)
+    {
+    case PAR_MODE: snprintf(s, sizeof(s), "%s%s         ", FwStr_P[d.Param], FwStr_V[v]); break;
+    case PAR_GATE: snprintf(s, sizeof(s), "%s%7ld  ms ", FwStr_P[d.Param], v); break;
+    case PAR_IF:
+    case PAR_SIF:  snprintf(s, sizeof(s), "%s%8.1f kHz", FwStr_P[d.Param], v / 10.0); break;
+    case PAR_RF:
+    case PAR_SRF:  snprintf(s, sizeof(s), "%c%11.6f MHz", FwStr_P[d.Param][0], v / 1E6); break;
+    case PAR_OUT:  snprintf(s, sizeof(s), "%s%s         ", FwStr_P[d.Param], v? "Res" : "LCD"); break;
+    case PAR_FLT:  snprintf(s, sizeof(s), "%s%s         ", FwStr_P[d.Param], v? "Med" : "NLR"); break;
+    case PAR_WIN:  snprintf(s, sizeof(s), "%s%s         ", FwStr_P[d.Param], v? "ms " : "Res"); break;
+    case PAR_INT:  snprintf(s, sizeof(s), "%s%s         ", FwStr_P[d.Param], v? "On " : "Off"); break;
+    case PAR_FAST:
+      if(!v) { snprintf(s, sizeof(s), "%sOff         ", FwStr_P[d.Param]); break; }
+      [[fallthrough]];
+    default:                         //address 0 is blank, as Disp_Val()
+      if(d.Param == PAR_ADR && !v) snprintf(s, sizeof(s), "%s            ", FwStr_P[d.Param]);
+        else snprintf(s, sizeof(s), "%s%7ld     ", FwStr_P[d.Param], v);
+    }
+  }
+  d.Shown.assign(s, 16);
+  //Port_StartTX(): display copy after each redraw
+  if(!d.Par[PAR_ADR] && !d.Par[PAR_OUT]) Send(d, d.Shown, 1);
+}
+
+//"$nn" in addressed mode, as Port_Head()
+
+std::string Sim::Head(const Dev &d) const
+{
+  int a = d.Par[PAR_ADR];
+  if(!a) return("");
+  char s[4] = {RSP_HDR, (char)('0' + a / 10), (char)('0' + a % 10), 0};
+  return(s);
+}
+
+//line with CR/LF: dropouts, garbage, synced sequence number of display
+//copies; a frame the pty does not take at once is dropped
+
+void Sim::Send(Dev &d, const std::string &s, bool unsolicited)
+{
+  int64_t t = Now();
+  if(t < d.Quiet) { d.St.Dropped++; return; }
+  std::uniform_real_distribution<double> u(0, 1);
+  if(unsolicited && Opt.Drop > 0 && u(Rnd) < Opt.Drop)
+  {
+    d.St.Dropped++;
+    if(Opt.Outage) d.Quiet = t + Opt.Outage;
+    return;
+  }
+  std::string b;
+  if(Opt.Garbage > 0 && u(Rnd) < Opt.Garbage)
+  {
+    int n = 1 + Rnd() % GARBAGE;
+    for(int i = 0; i < n; i++)
+    {
+      char c = Rnd() % 256;
+      b += c == '\n'? '~' : c;
+    }
+    b += "\r\n";
+    d.St.Garbage++;
+  }
+  bool disp = s.size() >= 16 && !s.compare(s.size() - 16, 16, d.Shown);
+  if(disp && d.Seq)                  //as Port_Frame()
+  {
+    char q[8];
+    snprintf(q, sizeof(q), "%05u ", (d.Seq - 1) % 100000);
+    b += s.substr(0, s.size() - 16) + q + d.Shown;
+  }
+  else b += s;
+  b += "\r\n";
+  ssize_t n = write(d.Fd, b.data(), b.size());
+  if(n != (ssize_t)b.size()) d.St.Overruns++;
+    else d.St.Frames++;
+}
+
+//----------------------------------------------------------------------------
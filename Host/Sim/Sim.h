@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: simulator of many counters on ptys, header file
+
+//----------------------------------------------------------------------------
+
+#ifndef SimH
+#define SimH
+
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "Menu.h"                    //PAR_xxx of firmware
+
+//------------------------------ Options: ------------------------------------
+
+struct SimOpt
+{
+  double Freq;                       //input of device 0, Hz
+  double Step;                       //relative input step to next device
+  double Noise;                      //white FM noise of results, relative
+  int Jitter;                        //frame time jitter, +/- ms
+  double Drop;                       //frame dropout probability
+  int Outage;                        //dropout length, ms, 0 - one frame
+  double Garbage;                    //garbage line probability, per frame
+  bool Splash;                       //splash screen at start
+  unsigned Seed;                     //random seed
+  long Par[PARAMS];                  //parameters at start
+
+  SimOpt();                          //firmware defaults (ParLim P_NOM)
+  bool Set(const char *s);           //"par=value", names as Emu -s
+};
+
+//------------------------------ Simulator: ----------------------------------
+
+//Behavioural model of the counter as seen on its UART, for load tests
+//of host software. Single thread, single epoll loop over all pty
+//masters, one timer queue for results and menu timeouts.
+//Each device takes the Rx_Int letters (plain or "#nnC") and parameter
+//commands ("Pnn", "Pnn=value") and runs the menus of Menu.c: splash, main with hold and auto scale, setup with
+//the ParUpDn() steps and limits. Results come every gate period with
+//white FM noise; display copies follow each redraw (LCD output),
+//result lines each result (Res output), both with the Port.c rules
+//for addressed mode. All modes show frequency, but the period mode.
+//Output never blocks: bytes not taken by the pty are dropped.
+
+class Sim
+{
+public:
+  struct Stat
+  {
+    uint64_t Frames;                 //lines sent
+    uint64_t Results;                //results made
+    uint64_t Keys;                   //commands taken
+    uint64_t Dropped;                //frames dropped by dropouts
+    uint64_t Garbage;                //garbage lines sent
+    uint64_t Overruns;               //frames not taken by the pty
+  };
+
+  Sim(const SimOpt &o);
+  ~Sim();
+  bool Add(const std::string &link = ""); //new device, link to its pty
+  void Run(int64_t ms = -1);         //run until Stop(), signal or ms
+  void Stop(void);                   //stop Run(), any thread
+  bool Signals(void);                //stop by SIGINT, SIGTERM
+  size_t Devices(void) const { return(Devs.size()); }
+  const Stat &Stats(size_t i) const { return(Devs[i].St); }
+  const std::string &Name(size_t i) const { return(Devs[i].Name); }
+  double Freq(size_t i) const { return(Devs[i].F); }
+
+private:
+  struct Dev
+  {
+    int Fd;                          //pty master
+    int Slave;                       //pty slave, kept open
+    std::string Name;                //pty slave path
+    std::string Link;
+    double F;                        //input, Hz
+    long Par[PARAMS];
+    int Menu;                        //MNU_xxx
+    int Param;                       //setup parameter
+    bool Hold;
+    bool Hide;                       //hold blink phase
+    bool Auto;                       //auto scale flag
+    int Scale;                       //decimals shown, kHz
+    int RxState;                     //addressed command state, as Rx_Int
+    int RxAddr;
+    bool ParCmd;                     //parameter command being received
+    bool RxBrd;                      //its address is broadcast
+    std::string RxPar;               //its chars after 'P'
+    int64_t Due;                     //result time without jitter, ms
+    int64_t Timer;                   //event time, ms
+    int64_t Quiet;                   //dropout end, ms
+    uint32_t Num;                    //result number
+    uint32_t Seq;                    //synced result number, 0 - not synced
+    double Value;                    //last result, display units
+    std::string Shown;               //display text
+    Stat St;
+  };
+  typedef std::pair<int64_t, uint32_t> Event; //time, device
+
+  SimOpt Opt;
+  int Ep;                            //epoll
+  int Ev;                            //stop eventfd
+  int Sig;                           //signalfd, -1 - not used
+  int64_t T0;                        //start, ms
+  std::vector<Dev> Devs;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> Queue;
+  std::mt19937_64 Rnd;
+
+  int64_t Now(void) const;
+  void Schedule(Dev &d, int64_t t);
+  void Tick(Dev &d, int64_t t);
+  void Read(Dev &d, int64_t t);
+  void Command(Dev &d, char c, int64_t t);
+  void Key(Dev &d, char c, int64_t t);
+  void Param(Dev &d, int64_t t);
+  bool Valid(const Dev &d, int m, long v);
+  void Enter(Dev &d, int menu, int64_t t);
+  void Result(Dev &d, int64_t t);
+  bool Step(Dev &d, bool up);
+  void Draw(Dev &d);
+  void Send(Dev &d, const std::string &s, bool unsolicited);
+  std::string Head(const Dev &d) const;
+};
+
+//----------------------------------------------------------------------------
+
+#endif
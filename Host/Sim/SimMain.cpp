@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host: simulator of many counters for load tests
+
+//Usage: Sim [-n devices] [-l dir] [-f Hz] [-w noise] [-j ms] [-d prob]
+//           [-o ms] [-g prob] [-q] [-r seed] [-t s] [-s par=value]
+//-n devices  devices, one pty each (default 1)
+//-l dir      links dir/fc0000... to the ptys
+//-f Hz       input of first device, next ones are 1E-6 higher (1E6)
+//-w noise    white FM noise of results, relative (1E-9)
+//-j ms       frame time jitter, +/- ms (0)
+//-d prob     frame dropout probability (0)
+//-o ms       dropout length, line is down for it (0 - one frame)
+//-g prob     garbage line before frame probability (0)
+//-q          no splash screen
+//-r seed     random seed
+//-t s        run time, s (default - until SIGINT or SIGTERM)
+//-s p=v      parameter at start: mode, gate, avg, if, pre, adr, out,
+//            fast, flt, int, rf
+//Pty names (and links) are written to stdout, one per line, then
+//statistics to stderr at exit.
+
+//----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "Sim.h"
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  SimOpt opt;
+  int devs = 1;
+  double run = -1;
+  const char *dir = nullptr;
+  int o;
+  while((o = getopt(argc, argv, "n:l:f:w:j:d:o:g:qr:t:s:")) != -1)
+  {
+    switch(o)
+    {
+    case 'n': devs = atoi(optarg); break;
+    case 'l': dir = optarg; break;
+    case 'f': opt.Freq = atof(optarg); break;
+    case 'w': opt.Noise = atof(optarg); break;
+    case 'j': opt.Jitter = atoi(optarg); break;
+    case 'd': opt.Drop = atof(optarg); break;
+    case 'o': opt.Outage = atoi(optarg); break;
+    case 'g': opt.Garbage = atof(optarg); break;
+    case 'q': opt.Splash = 0; break;
+    case 'r': opt.Seed = strtoul(optarg, nullptr, 10); break;
+    case 't': run = atof(optarg); break;
+    case 's':
+      if(opt.Set(optarg)) break;
+      fprintf(stderr, "Sim: bad parameter: %s\n", optarg);
+      return(2);
+    default:
+      fprintf(stderr, "Usage: Sim [-n devices] [-l dir] [-f Hz] [-w noise] [-j ms] [-d prob]\n"
+                      "           [-o ms] [-g prob] [-q] [-r seed] [-t s] [-s par=value]\n");
+      return(2);
+    }
+  }
+  //two descriptors per device:
+  struct rlimit rl;
+  if(!getrlimit(RLIMIT_NOFILE, &rl))
+  {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+
+  Sim sim(opt);
+  if(!sim.Signals()) { perror("Sim: signals"); return(2); }
+  for(int i = 0; i < devs; i++)
+  {
+    char link[4096] = "";
+    if(dir) snprintf(link, sizeof(link), "%s/fc%04d", dir, i);
+    if(!sim.Add(link)) { perror("Sim: pty"); break; }
+    if(dir) printf("%s %s\n", link, sim.Name(i).c_str());
+      else printf("%s\n", sim.Name(i).c_str());
+  }
+  fflush(stdout);
+  if(!sim.Devices()) return(1);
+  sim.Run(run < 0? -1 : (int64_t)(run * 1E3));
+
+  Sim::Stat t = {};
+  for(size_t i = 0; i < sim.Devices(); i++)
+  {
+    const Sim::Stat &s = sim.Stats(i);
+    t.Frames += s.Frames; t.Results += s.Results; t.Keys += s.Keys;
+    t.Dropped += s.Dropped; t.Garbage += s.Garbage; t.Overruns += s.Overruns;
+  }
+  fprintf(stderr, "Sim: %zu devices, %llu frames, %llu results, %llu commands, "
+          "%llu dropped, %llu garbage, %llu overruns\n", sim.Devices(),
+          (unsigned long long)t.Frames, (unsigned long long)t.Results,
+          (unsigned long long)t.Keys, (unsigned long long)t.Dropped,
+          (unsigned long long)t.Garbage, (unsigned long long)t.Overruns);
+  return(0);
+}
+
+//----------------------------------------------------------------------------
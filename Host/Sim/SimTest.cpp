@@ -0,0 +1,245 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//host test of counter simulator
+
+//Many simulated counters with jitter, dropouts and garbage lines run
+//in their thread while the capture daemon takes them all: every line
+//sent must be captured, garbage as bad lines, and display copies of
+//each device must show its own input at the gate rate. Then the client
+//library works a few of them by keys: ID, setup menu, result stream,
+//sync and addressed mode.
+
+//Usage: SimTest [-n devices] [-t s]
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include "Sim.h"
+#include "../Capture/Capture.h"
+#include "../Client/Client.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define N_DEVS   2000                //default devices
+#define T_RUN    3                   //default capture time, s
+#define GATE     100                 //gate, ms
+#define JITTER   20                  //frame jitter, ms
+#define DROP     0.01                //dropout probability
+#define GARBAGE  0.05                //garbage line probability
+#define T_TEST   30000               //client test limit, ms
+
+//------------------------------ Variables: ----------------------------------
+
+static int Fails;
+
+//------------------------------- Check: -------------------------------------
+
+static void Check(bool c, const char *what)
+{
+  if(c) return;
+  printf("FAILED: %s\n", what);
+  Fails++;
+}
+
+//----------------------------- Load test: -----------------------------------
+
+static void TestLoad(int devs, int run)
+{
+  char dir[] = "/tmp/SimTestXXXXXX";
+  if(!mkdtemp(dir)) { Check(0, "temp directory"); return; }
+  SimOpt o;
+  o.Jitter = JITTER;
+  o.Drop = DROP;
+  o.Garbage = GARBAGE;
+  o.Splash = 0;
+  o.Par[PAR_GATE] = GATE;
+  Sim sim(o);
+  std::vector<Capture::Stat> cs;
+  std::vector<std::string> names;
+  double dt;
+  {
+    Capture cap(dir);
+    for(int i = 0; i < devs; i++)
+      if(!sim.Add() || !cap.Add(sim.Name(i))) { Check(0, "pty"); return; }
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread c([&]{ cap.Run(); });
+    sim.Run(run * 1000);
+    usleep(300000);                  //last lines are taken
+    cap.Stop();
+    c.join();
+    dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for(int i = 0; i < devs; i++)
+    {
+      cs.push_back(cap.Stats(i));
+      names.push_back(cap.Name(i));
+    }
+  }                                  //capture files are flushed
+
+  Sim::Stat t = {};
+  uint64_t frames = 0, bad = 0;
+  bool lines = 1;
+  for(int i = 0; i < devs; i++)
+  {
+    const Sim::Stat &s = sim.Stats(i);
+    t.Frames += s.Frames; t.Results += s.Results; t.Dropped += s.Dropped;
+    t.Garbage += s.Garbage; t.Overruns += s.Overruns;
+    frames += cs[i].Frames;
+    bad += cs[i].Bad;
+    lines = lines && cs[i].Frames == s.Frames + s.Garbage;
+  }
+  Check(!t.Overruns, "overruns");
+  Check(lines, "lines captured");
+  Check(bad <= t.Garbage && bad > t.Garbage * 9 / 10, "garbage lines"); //16 chars look valid
+  double rate = (double)t.Results / devs / run;
+  Check(fabs(rate * GATE / 1000 - 1) < 0.1, "result rate");
+  Check(t.Dropped > 0 && t.Dropped < t.Results * DROP * 2, "dropouts");
+
+  //display copies of device show its input, at the gate rate:
+  for(int dev : {0, devs - 1})
+  {
+    FILE *f = fopen((std::string(dir) + "/" + names[dev] + ".cap").c_str(), "r");
+    if(!f) { Check(0, "capture file"); continue; }
+    char s[128];
+    long long tp = 0;
+    int n = 0, ok = 0, late = 0;
+    while(fgets(s, sizeof(s), f))
+    {
+      long long ns;
+      char c;
+      int p;
+      if(sscanf(s, "%lld %c %n", &ns, &c, &p) != 2 || c != FRAME_DISP) continue;
+      Frame fr;
+      s[strcspn(s, "\n")] = 0;
+      if(!fr.Parse(s + p, strlen(s + p)) || fr.Text.compare(0, 3, "F  ") || !fr.Mant)
+        continue;                    //zero before first result
+      n++;
+      ok += fabs(fr.Value() - sim.Freq(dev) / 1E3) < 5E-4; //devices are 1E-3 apart
+      if(tp) late += (ns - tp) / 1000000 > GATE + 2 * JITTER + 50;
+      tp = ns;
+    }
+    fclose(f);
+    Check(n > run * 1000 / GATE * 8 / 10 && ok == n, "device display values");
+    Check(late <= n / 20 + 1, "display rate");
+  }
+  printf("%d devices, %llu lines: %.0f lines/s, %llu garbage, %llu dropped\n", devs,
+         (unsigned long long)frames, frames / dt, (unsigned long long)t.Garbage,
+         (unsigned long long)t.Dropped);
+  if(system((std::string("rm -rf ") + dir).c_str())) {}
+}
+
+//---------------------------- Client test: ----------------------------------
+
+static FcTask<void> Work(FcLoop &l, FcCounter &c, FcCounter &a, int &done)
+{
+  FcReply r = co_await c.Id();
+  Check(r.Ok && r.F.Text == "FC-510 V2.1", "ID");
+  r = co_await c.Read();
+  Check(r.Ok && !r.F.Text.compare(0, 3, "F  "), "display");
+
+  FcPar p = co_await c.Get(FC_GATE);
+  Check(p.Ok && p.Value == 1000, "get gate");
+  Check(co_await c.Set(FC_GATE, 200), "set gate");
+  p = co_await c.Get(FC_GATE);
+  Check(p.Ok && p.Value == 200, "gate set");
+  Check(co_await c.Set(FC_RF, 128000010), "set Fref");
+  p = co_await c.Get(FC_RF);
+  Check(p.Ok && p.Value == 128000010, "Fref set");
+  Check(!co_await c.Set(FC_AVG, 3), "average off step grid");
+  Check(co_await c.Set(FC_IF, -1500), "set negative IF");
+  p = co_await c.Get(FC_IF);
+  Check(p.Ok && p.Value == -1500, "IF set");
+  Check(co_await c.Set(FC_IF, 0), "IF back");
+
+  //result stream of new gate:
+  Check(co_await c.Set(FC_OUT, 1), "set stream mode");
+  FcReply q = {};
+  int n = 0;
+  for(int i = 0; i < 4; i++)
+  {
+    r = co_await c.Next(1000);
+    if(!r.Ok) break;
+    if(i) n += r.F.Seq == q.F.Seq + 1 && r.F.Ms - q.F.Ms == 200 && fabs(r.F.Value() - 1000) < 1E-3;
+    q = r;
+  }
+  Check(n == 3, "stream results");
+  Check(co_await c.Set(FC_OUT, 0), "set display mode");
+
+  //sync: display copies get sequence numbers
+  Check(co_await c.Sync(), "sync");
+  co_await FcLoop::Sleep{l, 500};
+  r = co_await c.Read();
+  Check(r.Ok && r.F.Seq > 0, "synced display");
+
+  //addressed counter: requests only, "$nn" responses
+  r = co_await a.Id();
+  Check(r.Ok && r.F.Addr == 7, "addressed ID");
+  p = co_await a.Get(FC_ADR);
+  Check(p.Ok && p.Value == 7, "addressed get");
+  Check(co_await a.Set(FC_GATE, 500), "addressed set");
+  done = 1;
+  l.Stop();
+}
+
+static void TestClient(void)
+{
+  SimOpt o;
+  o.Splash = 0;
+  o.Noise = 0;
+  Sim sim(o);
+  o.Par[PAR_ADR] = 7;
+  Sim adr(o);
+  if(!sim.Add() || !adr.Add()) { Check(0, "pty"); return; }
+  std::thread s([&]{ sim.Run(); });
+  std::thread t([&]{ adr.Run(); });
+  int done = 0;
+  {
+    FcLoop l;
+    FcCounter c(l, sim.Name(0));
+    FcCounter a(l, adr.Name(0), 7);
+    l.Spawn(Work(l, c, a, done));
+    l.After(T_TEST, [&]{ l.Stop(); });
+    l.Run();
+  }
+  sim.Stop();
+  adr.Stop();
+  s.join();
+  t.join();
+  Check(done, "client done");
+  //Id, Read, 11 parameter commands, Sync, Read: one command each
+  Check(sim.Stats(0).Keys == 15 && !sim.Stats(0).Overruns, "commands");
+}
+
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  int devs = N_DEVS, run = T_RUN;
+  int o;
+  while((o = getopt(argc, argv, "n:t:")) != -1)
+  {
+    if(o == 'n') devs = atoi(optarg);
+    else if(o == 't') run = atoi(optarg);
+    else { fprintf(stderr, "Usage: SimTest [-n devices] [-t s]\n"); return(2); }
+  }
+  struct rlimit rl;                  //three descriptors per device
+  if(!getrlimit(RLIMIT_NOFILE, &rl))
+  {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+  TestLoad(devs, run);
+  TestClient();
+  printf(Fails? "FAILED\n" : "PASSED\n");
+  return(Fails? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//result calculation module
+
+//Module has no hardware dependencies, so it can be compiled
+//on host to check the arithmetic against reference values.
+
+//----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include "Calc.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define LL_MAX 0x7FFFFFFFFFFFFFFF //max long long value
+#define N_FAST 0x200000000        //nx * pre below this never overflows
+#define P_MAX  10000000           //max scale factor for DivScale
+
+//------------------------- Function prototypes: -----------------------------
+
+unsigned long long MulDiv(unsigned long long a, unsigned long long b,
+                          unsigned long long c); //a * b / c
+unsigned long long DivScale(unsigned long long a, unsigned long long b,
+                            long p); //a * p / b
+
+//-------------------------- Exact a * b / c: -------------------------------
+
+//bit-serial multiplication with reduction modulo c,
+//a * b may exceed 64 bits, c < 2^63, result must fit 64 bits
+
+unsigned long long MulDiv(unsigned long long a, unsigned long long b,
+                          unsigned long long c)
+{
+  unsigned long long aq = a / c; //a = aq * c + ar
+  unsigned long long ar = a % c;
+  unsigned long long q = 0;      //product = q * c + r
+  unsigned long long r = 0;
+  for(char i = 0; i < 64; i++)
+  {
+    q = q << 1;                  //product * 2
+    r = r << 1;
+    if(r >= c) { r -= c; q++; }
+    if(b & 0x8000000000000000)   //product + a
+    {
+      q += aq;
+      r += ar;
+      if(r >= c) { r -= c; q++; }
+    }
+    b = b << 1;
+  }
+  return(q);
+}
+
+//--------------------------- Exact a * p / b: -------------------------------
+
+//a / b * p must fit 64 bits, p <= P_MAX,
+//remainder is scaled separately, so no precision is lost;
+//MulDiv is needed only if r * p may overflow (long gates)
+
+unsigned long long DivScale(unsigned long long a, unsigned long long b,
+                            long p)
+{
+  unsigned long long q = a / b;
+  unsigned long long r = a - q * b;
+  q = q * p;
+  if(p > 1)
+  {
+    if(r < LL_MAX / P_MAX) q += r * p / b;
+      else q += MulDiv(r, p, b);
+  }
+  return(q);
+}
+
+//----------------------------------------------------------------------------
+//--------------------------- Exported functions: ----------------------------
+//----------------------------------------------------------------------------
+
+//--------------------------- Calculate result: ------------------------------
+
+//mx - total reference pulses count
+//nx - total input pulses count
+//ix - interpolator count
+//cal - interpolator calibration sum, 0 - interpolator off
+//ncal - calibration cycles count in cal sum
+//fref - reference frequency, x0.1 Hz
+//pre - prescaler ratio
+//per - period calculation flag
+//returns period in ps (per = 1) or frequency in uHz (per = 0)
+
+long long Calc_Result(long long mx, long long nx, int ix, int cal, char ncal,
+                      long fref, int pre, bool per)
+{
+  long long res = 0;
+  //Scale pulse number:
+  //2 GHz max * 10 s * 128000000 (x0.1 Hz) =
+  //2560000000000000000 (23 86 F2 6F C1 00 00 00)
+  //longer gates may overflow, then exact MulDiv is used
+  long long np = nx * pre;
+  bool big = (np >= N_FAST) && (np > LL_MAX / fref);
+  long long Nx = big? 0 : np * fref;
+
+  //scale to 1/100 of resolution:
+  //256000000 (F 42 40 00) * 100 = 25600000000 (5 F5 E1 00 00)
+  //1000 s gate: 25600000000 * 100 = 2560000000000 (2 54 0B E4 00 00)
+  long long Mx = mx * 100;
+
+  //Calculate total interpolated pulse number, scaled by 100:
+  //127 * 100 * 2 * 5 (nom) = 127000
+  if(cal)
+    Mx += ((long)ix * (100 * ncal)) / (-cal);
+
+  if(per)
+  //period calculation, ps:
+  //10 s max = 10 000 000 000 000 (9 18 4E 72 A0 00)
+  {
+    long pm = 1000;
+    if(big)
+    {
+      res = MulDiv(Mx, 100000000000, fref) / np;
+    }
+    else if(Nx && Mx >= LL_MAX / 100000000)
+    {
+      res = MulDiv(Mx, 100000000000, Nx);
+    }
+    else if(Nx)
+    {
+      while(Mx < (0x7FFFFFFFFFFFFFFF / 1000000000) && pm > 1)
+      {
+        Mx = Mx * 10;
+        pm = pm / 10;
+      }
+      res = DivScale(Mx * 100000000, Nx, pm);
+    }
+  }
+  //frequency calculation, uHz
+  //2 GHz max with prescaler = 2 000 000 000 000 000 uHz (7 1A FD 49 8D 00 00)
+  else
+  {
+    long pm = 10000000;
+    if(big && Mx)
+    {
+      res = MulDiv(np, (long long)fref * 10000000, Mx);
+    }
+    else if(Mx)
+    {
+      while(Nx < (0x7FFFFFFFFFFFFFFF / 10) && pm > 1)
+      {
+        Nx = Nx * 10;
+        pm = pm / 10;
+      }
+      res = DivScale(Nx, Mx, pm);
+    }
+  }
+  return(res);
+}
+
+//------------------------- Integer square root: -----------------------------
+
+//returns floor(sqrt(x)), bit by bit
+
+unsigned long Calc_Sqrt(unsigned long long x)
+{
+  unsigned long long r = 0;
+  unsigned long long b = 1ULL << 62; //highest power of 4
+  while(b > x) b = b >> 2;
+  while(b)
+  {
+    if(x >= r + b)
+    {
+      x = x - r - b;
+      r = (r >> 1) + b;
+    }
+    else
+    {
+      r = r >> 1;
+    }
+    b = b >> 2;
+  }
+  return((unsigned long)r);
+}
+
+//----------------------------------------------------------------------------
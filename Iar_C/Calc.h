@@ -0,0 +1,19 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//result calculation module: header file
+
+//----------------------------------------------------------------------------
+
+#ifndef CalcH
+#define CalcH
+
+//------------------------- Function prototypes: -----------------------------
+
+long long Calc_Result(long long mx, long long nx, int ix, int cal, char ncal,
+                      long fref, int pre, bool per); //calculate result
+unsigned long Calc_Sqrt(unsigned long long x); //integer square root
+
+//----------------------------------------------------------------------------
+
+#endif
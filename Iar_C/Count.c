@@ -7,13 +7,27 @@
 
 #include "Main.h"
 #include "Count.h"
+#include "Calc.h"
+#include "Pre.h"
 
 //----------------------------- Constants: -----------------------------------
 
 #define N_CALIB    5 //pre- and post- calibrate cycles count
 #define T_PAUSE  100 //default pause time, ms
 #define MAX_AVG  100 //max number of averages
+#define AVG_DEV 32767 //max averaging filter deviation, steps (int)
 #define NLR       16 //window for non-linear filter, E-1 (6.25% for NLR = 16)
+#define VAL_MAX (0x7FFFFFFFLL * 100000000) //max value, 1E-9 of display units
+#define MED_SIZE   5 //median window size for robust filter
+#define HAMPEL    45 //outlier threshold in MADs, E-1 (4.5 MAD = 3 sigma)
+#define T_PROBE   10 //auto mode probe gate time, ms
+#define HYST      10 //auto mode switch hysteresis, E-1 (10% for HYST = 10)
+#define FAST_TOUT 3000 //fast mode wait/finish timeout, ms
+#define DUTY_SUB   4 //duty cycle mode HI/LO sub-gate pairs
+#define WIN_MASK (WIN_SIZE - 1)
+#define WIN_DMAX 700000000 //max deviation from window base
+#define T_PATH  10000 //two-path ratio: other path result age, ms (+3 gates)
+#define PRE_TOL  1000 //two-path ratio: tolerance, E-1 (0.1% for PRE_TOL = 1000)
 
 //Counter states:
 
@@ -22,6 +36,7 @@ enum
   ST_STOP,   //counter is stopping
   ST_START,  //counter is starting
   ST_PAUSE,  //counter waits for pause
+  ST_ARMED,  //counter waits for sync command
   ST_WAIT,   //counter waits for input signal
   ST_COUNT,  //count in progress
   ST_FINISH, //counter completes count
@@ -34,12 +49,14 @@ enum
 
 static long Fref;              //reference frequency, x0.1 Hz
 static char Count_N;           //MCU input pulses count
-static int Count_M;            //MCU reference pulses count
-static long Count_Nx;          //total input pulses count
-static long Count_Mx;          //total reference pulses count
+static char Count_NH;          //MCU input pulses count, high byte
+static unsigned short Count_M; //MCU reference pulses count
+static char Count_MH;          //MCU reference pulses count, high byte
+static long long Count_Nx;     //total input pulses count
+static long long Count_Mx;     //total reference pulses count
 static int Count_Ix;           //interpolator count
 static int Cal;                //interpolator calibration value
-static int Cnt_Timer;          //counter timer
+static long Cnt_Timer;         //counter timer
 static long long Freq;         //current  frequency
 static bool First;             //first measure flag
 static long long Fmax;         //statistics: max frequency
@@ -47,22 +64,71 @@ static long long Fmin;         //statistics: min frequency
 static long long Fnom;         //statistics: nom frequency
 static long long Fdev;         //statistics: dev frequency
 
+static long long WinBase;      //window: base value
+static long Win[WIN_SIZE];     //window: deviations from base
+static unsigned long WinTm[WIN_SIZE]; //window: result times, ticks
+static char WinLen;            //window: length, results
+static unsigned long WinT;     //window: length, ticks (0 - results mode)
+static char WinSh;             //window: deviations scale shift
+static char WinSeq;            //window: next result number
+static char WinCnt;            //window: results count
+static char MaxQ[WIN_SIZE];    //window: max deque (result numbers)
+static char MaxH;              //window: max deque head
+static char MaxN;              //window: max deque length
+static char MinQ[WIN_SIZE];    //window: min deque (result numbers)
+static char MinH;              //window: min deque head
+static char MinN;              //window: min deque length
+static long long WinSum;       //window: deviations sum
+static long long WinSq;        //window: deviation squares sum
+
 static char State;             //counter state
 static char Mode;              //counter mode
 static char Scale;             //output value scale
-static long Avg[MAX_AVG];      //averaging filter array
-static long long AvgVal;       //sum averaging value
+static long long AvgBase;      //averaging filter base value
+static int Avg[MAX_AVG];       //averaging filter deviations from base
+static long AvgSum;            //averaging filter deviations sum
+static char AvgSh;             //averaging filter deviation step, 2^AvgSh
 static bool DutyH;             //duty H-pulse measure phase
-static long PulseH;            //duty H-pulse width
-static long PulseL;            //duty L-pulse width
-
-static int  T_Gate;            //gate time, ms
+static char DutySub;           //duty sub-gates left
+static long long PulseH;       //duty H-pulse widths sum
+static long long PulseL;       //duty L-pulse widths sum
+static bool AutoP;             //auto mode: period measure
+static bool Probe;             //auto mode: probe gate
+static long AutoF;             //auto mode: F/P switch frequency, x0.1 Hz
+
+static long T_Gate;            //gate time, ticks
 static int  T_Pause;           //pause time, ms
 static char Average;           //number of averages
 static char AvgPnt;            //averaging filter pointer
+static bool Robust;            //robust (median) filter enable
+static long long MedRing[MED_SIZE]; //median window, arrival order
+static long long MedSort[MED_SIZE]; //median window, sorted
+static char MedPnt;            //median window pointer
+static char MedCnt;            //median window values count
 static long IFreq;             //IF value
 static int  Prescale;          //prescaler ratio
+static long long PathF[2];     //two-path ratio: last frequency at path output
+static unsigned long PathTm[2]; //two-path ratio: its time, ticks
+static bool PathDiv;           //two-path ratio: path of last result
+static char PathCnt;           //two-path ratio: results on this path
+static int  PreMeas;           //two-path ratio: new measured ratio, 0 - none
 static bool Interpolate;       //interpolator enable
+static char Fast;              //fast mode periods per result (0 - off)
+static long FastGate;          //fast mode gate time, ticks
+static bool FastRun;           //fast mode gate without calibration
+
+static bool Sync;              //sync mode (gate start by command)
+static bool SyncArm;           //sync mode request
+static bool Synced;            //gate started by sync command
+static unsigned int SyncSeq;   //sync commands count
+static unsigned int GateSeq;   //sequence number of current gate
+static unsigned int ResSeq;    //sequence number of result
+
+static unsigned long Ticks;    //system ticks count
+static unsigned long ResTime;  //result time, ticks
+static unsigned int ResNum;    //result number
+static long long ResVal;       //result value
+static bool ResNew;            //new result flag
 
 //------------------------- Function prototypes: -----------------------------
 
@@ -75,7 +141,27 @@ __interrupt void Timer1(void); //timer 1 overflow interrupt (input)
 char Get_CPLD(void);           //read data byte from CPLD
 void Count_Read(void);         //read counters
 void Count_Make(void);         //calculate frequency
-void PresetFilter(long v);     //preset averaging filter array
+bool Count_Duty(void);         //duty cycle sub-gate done
+void Count_DutyMode(void);     //set CPLD mode for duty sub-gate
+long Count_Gate(void);         //count interval
+void Count_AutoF(void);        //auto mode switch frequency
+void PresetFilter(long long v); //preset averaging filter array
+bool AvgAdd(long long v);      //add value to averaging filter
+long long AvgMean(void);       //averaging filter mean value
+void MedianAdd(long long v);   //add value to median window
+long long Median(void);        //median of window values
+long long MedianDev(void);     //median absolute deviation of window
+long long Count_Filter(long long v); //averaging filter
+long long Count_Value(void);   //calculate mode value
+void Count_WinClear(void);     //clear statistics window
+void Count_WinAdd(long long v); //add result to statistics window
+void Count_WinDrop(void);      //remove oldest result from window
+long long Count_WinVal(long d); //window deviation to value
+long Count_WinDev(long long v, long long b, char s); //value to deviation
+void Count_WinBase(long long b, char s); //rebase statistics window
+long long Count_WinStat(char m); //read window statistics
+void Count_Result(void);       //save result for output
+int  Count_PathRatio(long long f, bool div); //two-path prescaler ratio
 
 //------------------------- Counter module init: -----------------------------
 
@@ -87,6 +173,7 @@ void Count_Init(void)
   TIFR = (1 << TOIE1) | (1 << TOIE0);   //clear pending interrupts
   TIMSK |= (1 << TOIE1) | (1 << TOIE0); //OVF0 and OVF1 interrupts enable
 
+  WinLen = WIN_SIZE;         //statistics window of WIN_SIZE results
   Count_ClearStat();         //statistics clear
   T_Pause = ms2sys(T_PAUSE); //load default pause time
   First = 1;                 //first measure flag set
@@ -100,12 +187,13 @@ void Count_Exe(bool t)
   if(t)
   {
     if(Cnt_Timer) Cnt_Timer--;
+    Ticks++;
 
     switch(State)
     {
     case ST_START:            //START state:
       {
-        Cnt_Timer = T_Pause;  //load pause interval
+        Cnt_Timer = Fast? 0 : T_Pause; //load pause interval
         State = ST_PAUSE;     //switch to PAUSE state
         break;
       }
@@ -113,8 +201,29 @@ void Count_Exe(bool t)
       {
         if(Cnt_Timer) break;  //wait for pause time
         Cal = Count_Calib();  //pre-calibration
+        FastRun = 0;          //calibrated gate
+        if(SyncArm)           //enter sync mode
+        {
+          SyncArm = 0;
+          SyncSeq = 0;
+          Sync = 1;
+        }
+        if(Sync)              //gate will be opened by sync command
+        {
+          Probe = 0;          //no probe gate in sync mode
+          Synced = 0;
+          State = ST_ARMED;   //switch to ARMED state
+          break;
+        }
         Count_Clear();        //counters clear
         Port_GATE_1;          //enable count
+        Cnt_Timer = Fast? ms2sys(FAST_TOUT) : T_Gate; //load wait interval
+        State = ST_WAIT;      //switch to WAIT state
+        break;
+      }
+    case ST_ARMED:            //ARMED state:
+      {
+        if(!Synced) break;    //wait for sync command
         Cnt_Timer = T_Gate;   //load gate interval
         State = ST_WAIT;      //switch to WAIT state
         break;
@@ -124,7 +233,7 @@ void Count_Exe(bool t)
         if(Pin_SDATA)         //check for start:
         {                     //start occurs,
           Port_LED_1;         //GATE LED on
-          Cnt_Timer = T_Gate; //reload gate interval
+          Cnt_Timer = Count_Gate(); //reload gate interval
           State = ST_COUNT;   //switch to COUNT state
         }
         else                  //no start
@@ -139,7 +248,7 @@ void Count_Exe(bool t)
         if(!Cnt_Timer)        //check for gate time
         {                     //if count time is over
           Port_GATE_0;        //disable count
-          Cnt_Timer = T_Gate; //reload gate interval
+          Cnt_Timer = Fast? ms2sys(FAST_TOUT) : T_Gate; //reload interval
           State = ST_FINISH;  //switch to FINISH state
         }
         break;
@@ -150,8 +259,25 @@ void Count_Exe(bool t)
         {                     //count is over
           Port_LED_0;         //GATE LED off
           Count_Read();       //read counters
-          Cal += Count_Calib(); //post-calibration
+          if(Mode == MODE_D && Count_Duty()) //next duty sub-gate
+          {
+            Count_Clear();    //counters clear
+            Port_GATE_1;      //enable count
+            Cnt_Timer = Fast? ms2sys(FAST_TOUT) : T_Gate; //load wait interval
+            State = ST_WAIT;  //switch to WAIT state
+            break;
+          }
+          if(!FastRun) Cal += Count_Calib(); //post-calibration
           Count_Make();       //calculate frequency
+          if(Probe)           //auto mode F/P is chosen,
+          {
+            Probe = 0;
+            Cnt_Timer = 0;
+            State = ST_PAUSE; //start measure gate at once
+            break;
+          }
+          ResSeq = GateSeq;   //tag result
+          Count_Result();     //save result for output
           State = ST_READY;   //switch to READY state
         }
         else                  //count not over
@@ -175,6 +301,8 @@ void Count_Exe(bool t)
       Port_GATE_0;            //disable count
       Port_LED_0;             //GATE LED off
       Freq = PulseH = PulseL = 0; //clear count
+      ResSeq = GateSeq;       //tag result
+      Count_Result();         //save result for output
       State = ST_READY;       //switch to READY state
     }
   }
@@ -188,7 +316,9 @@ void Count_Clear(void)
   TCNT0 = 0;    //timer 0 clear
   TCNT1 = 0;    //timer 1 clear
   Count_M = 0;  //reference pulse count clear
+  Count_MH = 0;
   Count_N = 0;  //input pulse count clear
+  Count_NH = 0;
   Port_RESET_1; //release CPLD reset
 }
 
@@ -197,7 +327,7 @@ void Count_Clear(void)
 #pragma vector = TIMER0_OVF_vect
 __interrupt void Timer0(void)
 {
-  Count_M++;
+  if(!++Count_M) Count_MH++;
 }
 
 //------------ Timer 1 overflow interrupt (input pulses count): --------------
@@ -205,13 +335,19 @@ __interrupt void Timer0(void)
 #pragma vector = TIMER1_OVF_vect
 __interrupt void Timer1(void)
 {
-  Count_N++;
+  if(!++Count_N) Count_NH++;
 }
 
 //-------------------------- Read data from CPLD: ----------------------------
 
+//CPLD serial frame (see FCnt.tdf):
+//FSYNC = 1: SDATA = FinGate (count in progress)
+//FSYNC = 0: SDATA bit is shifted on SCLOCK rise, LSB first:
+//           FrefCnt[7..0], FinCnt[7..0], IntCnt[7..0]
+
 char Get_CPLD(void)
 {
+  Bench_Start(BENCH_CPLD);
   char d = 0;
   for(char i = 0; i < 8; i++) //bit count
   {
@@ -221,6 +357,7 @@ char Get_CPLD(void)
     Port_SCLOCK_0;            //clock 1 -> 0
     if(Pin_SDATA) d |= 0x80;  //shift data bit
   }
+  Bench_Stop(BENCH_CPLD);
   return(d);
 }
 
@@ -228,6 +365,7 @@ char Get_CPLD(void)
 
 int Count_Calib(void)
 {
+  Bench_Start(BENCH_CALIB);
   signed char d;
   int cal = 0;
   for(char i = 0; i < N_CALIB; i++)
@@ -246,6 +384,7 @@ int Count_Calib(void)
     Port_FSYNC_1;
     cal += d;       //summ calibration values
   }
+  Bench_Stop(BENCH_CALIB);
   return(cal);
 }
 
@@ -261,85 +400,472 @@ void Count_Read(void)
   Count_Ix = (signed char)Get_CPLD(); //read interpolator
   Port_FSYNC_1;
 
-  //Total reference pulse number:
+  //Total reference pulse number, 40 bits:
   //12.8 MHz * 10 s * 2 (finishing) = 256000000 (F 42 40 00)
-  Count_Mx = ((long)Count_M << 16) + ((long)TCNT0 << 8) + CntM0;
-  //Total input pulse number:
+  //12.8 MHz * 1000 s * 2 (finishing) = 25600000000 (5 F5 E1 00 00)
+  Count_Mx = ((unsigned long)Count_M << 16) + ((long)TCNT0 << 8) + CntM0;
+  if(Count_MH) Count_Mx += (long long)Count_MH << 32; //long gate only
+  //Total input pulse number, 40 bits:
   //100 MHz max * 10 s = 1000000000 (3B 9A CA 00)
-  Count_Nx = ((long)Count_N << 24) + ((long)TCNT1 << 8) + CntN0;
+  //100 MHz max * 1000 s = 100000000000 (17 48 76 E8 00)
+  Count_Nx = ((unsigned long)Count_N << 24) + ((long)TCNT1 << 8) + CntN0;
+  if(Count_NH) Count_Nx += (long long)Count_NH << 32; //long gate only
 }
 
 //------------------------- Calculate frequency: -----------------------------
 
-//updates Freq, Fmin, Fmax, Fdev, PulseH, PulseL
+//updates Freq, Fmin, Fmax, Fdev
 
 void Count_Make(void)
 {
-  //Scale pulse number:
-  //2 GHz max * 10 s * 128000000 (x0.1 Hz) =
-  //2560000000000000000 (23 86 F2 6F C1 00 00 00)
-  int pre = Pin_FDIV? Prescale : 1;
-  long long Nx = (long long)Count_Nx * Fref * pre;
-
-  //save pulse width for duty cycle calculation:
-  if(DutyH) PulseH = Count_Mx;
-    else PulseL = Count_Mx;
-
-  //scale to 1/100 of resolution:
-  //256000000 (F 42 40 00) * 100 = 25600000000 (5 F5 E1 00 00)
-  long long Mx = (long long)Count_Mx * 100;
-
-  //Calculate total interpolated pulse number, scaled by 100:
-  //127 * 100 * 2 * 5 (nom) = 127000
-  if(Interpolate && !((Mode == MODE_HI) || (Mode == MODE_LO)))
-    Mx += ((long)Count_Ix * (100 * 2 * N_CALIB)) / (-Cal);
-
-  Freq = 0;
-  if((Mode == MODE_HI) || (Mode == MODE_LO) || (Mode == MODE_P))
-  //period calculation, ps:
-  //10 s max = 10 000 000 000 000 (9 18 4E 72 A0 00)
+  Bench_Start(BENCH_MAKE);
+  bool div = Pin_FDIV;
+  int pre = div? Prescale : 1;
+  bool hl = (Mode == MODE_HI) || (Mode == MODE_LO);
+
+  //auto mode: period below AutoF of counted frequency, frequency above,
+  //statistics are restarted in new units:
+  if(Mode == MODE_A)
   {
-    long pm = 1000;
-    if(Nx)
+    bool p = AutoP;
+    if(!Count_Nx) AutoP = 1;
+    else
     {
-      while(Mx < (0x7FFFFFFFFFFFFFFF / 1000000000) && pm > 1)
-      {
-        Mx = Mx * 10;
-        pm = pm / 10;
-      }
-      Freq = Mx * 100000000 / Nx * pm;
+      long long f = (long long)Fref * Count_Nx; //counted F * Mx, x0.1 Hz
+      long long m = Count_Mx * AutoF;           //switch F * Mx, x0.1 Hz
+      if(f > m + m / HYST) AutoP = 0;
+      if(f < m - m / HYST) AutoP = 1;
+    }
+    if(AutoP != p)
+    {
+      PresetFilter(0);                //other units
+      First = 1;                      //clear statistics
     }
   }
-  //frequency calculation, uHz
-  //2 GHz max with prescaler = 2 000 000 000 000 000 uHz (7 1A FD 49 8D 00 00)
+
+  //interpolator is not used for pulse duration:
+  int cal = (Interpolate && !hl)? Cal : 0;
+  bool per = hl || (Count_GetMode() == MODE_P);
+  Freq = Calc_Result(Count_Mx, Count_Nx, Count_Ix, cal, 2 * N_CALIB,
+                     Fref, pre, per);
+  //actual prescaler ratio from frequencies before and after
+  //the divider is switched, this result is corrected at once:
+  if(!per && Mode != MODE_D && !Probe)
+  {
+    int n = Count_PathRatio(Freq / pre, div);
+    if(n)
+    {
+      if(div) Freq = Freq / pre * n;
+      Prescale = n;
+      PreMeas = n;
+    }
+  }
+  //fast mode gate for next result, CPLD extends gate to the
+  //next counted edge, so 1 tick gives 1 period of counted signal
+  //(Fast input periods are Fast / pre counted periods);
+  //in HI, LO and D modes Mx is pulse time only, so period is
+  //unknown and each gate is 1 tick long (one pulse):
+  if(Fast && Count_Nx && !hl && Mode != MODE_D)
+  {
+    long long t = 0;
+    if(Fast > pre)
+      t = Count_Mx * (Fast - pre) * (long)(1E7 / T_SYS) /
+        (Count_Nx * Fref * pre); //Fast input periods less 1 counted, ticks
+    if(t > T_Gate) t = T_Gate;
+    FastGate = (long)t + 1;
+  }
+  //statistics, probe gate result is for mode choice only:
+  if(!Probe)
+  {
+    if(Freq < Fmin) Fmin = Freq;
+    if(Freq > Fmax) Fmax = Freq;
+    Fdev = Freq - Fnom;
+    if(First) { Count_ClearStat(); First = 0; };
+    Count_WinAdd(Freq);
+  }
+  Bench_Stop(BENCH_MAKE);
+}
+
+//------------------------ Duty cycle sub-gate done: -------------------------
+
+//HI and LO pulses are measured by DUTY_SUB pairs of short sub-gates
+//in one measurement window, so both widths come from the same time,
+//widths are summed in PulseH, PulseL, they are read only
+//by Count_Result after the last sub-gate,
+//returns 1 if next sub-gate needed
+
+bool Count_Duty(void)
+{
+  if(DutyH) PulseH += Count_Mx;
+    else PulseL += Count_Mx;
+  DutyH = !DutyH;
+  Count_DutyMode();
+  return(--DutySub != 0);
+}
+
+//------------------- Set CPLD mode for duty sub-gate: -----------------------
+
+void Count_DutyMode(void)
+{
+  if(DutyH) { Port_MODE0_1; Port_MODE1_0; Port_MODE2_0; }
+    else { Port_MODE0_0; Port_MODE1_1; Port_MODE2_0; }
+}
+
+//--------------------------- Count interval: --------------------------------
+
+long Count_Gate(void)
+{
+  if(Probe && T_Gate > ms2sys(T_PROBE))
+    return(ms2sys(T_PROBE));           //auto mode probe gate
+  if(Fast) return(FastGate);           //fast mode
+  if(Mode == MODE_D) return(T_Gate / (2 * DUTY_SUB) + 1); //duty sub-gate
+  return(T_Gate);
+}
+
+//----------------------- Clear statistics window: --------------------------
+
+void Count_WinClear(void)
+{
+  WinBase = Freq;
+  WinSh = 0;
+  WinCnt = 0;
+  MaxN = MinN = 0;
+  WinSum = WinSq = 0;
+}
+
+//------------------- Add result to statistics window: -----------------------
+
+//window keeps last WinLen results (or results of last WinT ticks,
+//WIN_SIZE max) as deviations from base,
+//min and max are the heads of monotonic deques, mean and
+//std. deviation are made from running sums, all O(1) per result;
+//if result does not fit WIN_DMAX, window is moved to the middle
+//of its range, if the range is too wide (jump or glitch),
+//deviations are kept with lower resolution (scale step 2^WinSh),
+//resolution is restored when the range is narrow again
+
+void Count_WinAdd(long long v)
+{
+  if(WinT)                            //time mode, drop expired:
+    while(WinCnt && Ticks - WinTm[(WinSeq - WinCnt) & WIN_MASK] >= WinT)
+      Count_WinDrop();
+  if(WinCnt == WinLen) Count_WinDrop(); //window full, drop oldest
+  if(WinCnt)
+  {
+    long long lo = Count_WinVal(Win[MinQ[MinH] & WIN_MASK]);
+    long long hi = Count_WinVal(Win[MaxQ[MaxH] & WIN_MASK]);
+    if(v < lo) lo = v;
+    if(v > hi) hi = v;
+    long long r = hi - lo;            //window range with new result
+    char sh = WinSh;
+    while((r >> sh) > 2 * (WIN_DMAX - 1)) sh++; //too wide, lower resolution
+    if(sh == WinSh && sh && (r >> (sh - 1)) < WIN_DMAX) sh--; //narrow
+    long dv = Count_WinDev(v, WinBase, WinSh);
+    if(sh != WinSh || dv > WIN_DMAX || dv < -WIN_DMAX)
+      Count_WinBase(lo + r / 2, sh);  //move window base
+  }
   else
   {
-    long pm = 10000000;
-    if(Mx)
+    WinBase = v;
+    WinSh = 0;
+  }
+  long d = Count_WinDev(v, WinBase, WinSh);
+  char i = WinSeq & WIN_MASK;
+  WinCnt++;
+  Win[i] = d;
+  WinTm[i] = Ticks;
+  WinSum += d;
+  WinSq += (long long)d * d;
+  //drop smaller values from max deque tail, push new:
+  while(MaxN && Win[MaxQ[(MaxH + MaxN - 1) & WIN_MASK] & WIN_MASK] <= d) MaxN--;
+  MaxQ[(MaxH + MaxN++) & WIN_MASK] = WinSeq;
+  //drop bigger values from min deque tail, push new:
+  while(MinN && Win[MinQ[(MinH + MinN - 1) & WIN_MASK] & WIN_MASK] >= d) MinN--;
+  MinQ[(MinH + MinN++) & WIN_MASK] = WinSeq;
+  WinSeq++;
+}
+
+//------------------ Remove oldest result from window: -----------------------
+
+void Count_WinDrop(void)
+{
+  char s = WinSeq - WinCnt;           //oldest result number
+  long o = Win[s & WIN_MASK];
+  WinSum -= o;
+  WinSq -= (long long)o * o;
+  if(MaxN && MaxQ[MaxH] == s) { MaxH = (MaxH + 1) & WIN_MASK; MaxN--; }
+  if(MinN && MinQ[MinH] == s) { MinH = (MinH + 1) & WIN_MASK; MinN--; }
+  WinCnt--;
+}
+
+//------------------ Window deviation to value and back: ---------------------
+
+//deviations are signed, so they are scaled by multiplication
+//and division, not by shifts
+
+long long Count_WinVal(long d)
+{
+  return(WinBase + (long long)d * (1LL << WinSh));
+}
+
+long Count_WinDev(long long v, long long b, char s)
+{
+  return((long)((v - b) / (1LL << s)));
+}
+
+//------------------------ Rebase statistics window: -------------------------
+
+//b - new base, s - new scale shift,
+//window deviations and running sums are recalculated
+
+void Count_WinBase(long long b, char s)
+{
+  WinSum = WinSq = 0;
+  for(char n = 1; n <= WinCnt; n++)
+  {
+    char i = (WinSeq - n) & WIN_MASK;
+    long d = Count_WinDev(Count_WinVal(Win[i]), b, s);
+    Win[i] = d;
+    WinSum += d;
+    WinSq += (long long)d * d;
+  }
+  WinBase = b;
+  WinSh = s;
+}
+
+//------------------------ Read window statistics: ---------------------------
+
+long long Count_WinStat(char m)
+{
+  if(!WinCnt) return(0);
+  switch(m)
+  {
+  case MODE_FHW: //window max:
+    return(Count_WinVal(Win[MaxQ[MaxH] & WIN_MASK]));
+  case MODE_FLW: //window min:
+    return(Count_WinVal(Win[MinQ[MinH] & WIN_MASK]));
+  case MODE_FMW: //window mean:
+    return(WinBase + WinSum / WinCnt * (1LL << WinSh));
+  case MODE_FSW: //window sample std. deviation:
+    if(WinCnt > 1)
     {
-      while(Nx < (0x7FFFFFFFFFFFFFFF / 10) && pm > 1)
-      {
-        Nx = Nx * 10;
-        pm = pm / 10;
-      }
-      Freq = Nx / Mx * pm;
+      //sum of squares from integer mean m = S / n, r = S - n * m:
+      //sum (d - m)^2 = Q - m * (S + r), |m * (S + r)| <= S^2 / n <= Q,
+      //so no overflow, then sum (d - S / n)^2 = sum (d - m)^2 - r^2 / n
+      long long m = WinSum / WinCnt;
+      long long r = WinSum - m * WinCnt;
+      long long q = WinSq - m * (WinSum + r) - r * r / WinCnt;
+      if(q > 0) return((long long)Calc_Sqrt(q / (WinCnt - 1)) * (1LL << WinSh));
     }
   }
-  //statistics:
-  if(Freq < Fmin) Fmin = Freq;
-  if(Freq > Fmax) Fmax = Freq;
-  Fdev = Freq - Fnom;
-  if(First) { Count_ClearStat(); First = 0; };
+  return(0);
+}
+
+//------------------------ Save result for output: ---------------------------
+
+void Count_Result(void)
+{
+  ResVal = Count_Filter(Count_Value());
+  ResTime = Ticks;
+  ResNum++;
+  ResNew = 1;
+}
+
+//------------------ Prescaler ratio, two-path measurement: ------------------
+
+//the same signal is counted through the direct input and through
+//the divider, before and after the divider is switched (Pin_FDIV),
+//so the ratio of the path output frequencies is the actual one,
+//the first result on a path is skipped (the switch may be in its gate),
+//f - frequency at the path output, div - divider path,
+//returns the measured ratio once per switch, 0 - none
+
+int Count_PathRatio(long long f, bool div)
+{
+  if(div != PathDiv) { PathDiv = div; PathCnt = 0; }
+  if(PathCnt < 2) PathCnt++;
+  if(PathCnt < 2 || f <= 0) return(0);
+  PathF[div] = f;
+  PathTm[div] = Ticks;
+  long long o = PathF[!div];
+  if(!o || Ticks - PathTm[!div] > (unsigned long)(ms2sys(T_PATH) + 3 * T_Gate))
+    return(0);                        //too old
+  PathF[!div] = 0;                    //once per switch
+  long long d = div? o : f;           //direct input
+  long long q = div? f : o;           //divider output
+  long long n = (d + q / 2) / q;
+  if(n > 32767 || !Pre_Valid((int)n)) return(0);
+  long long e = d - n * q;
+  if(e < 0) e = -e;
+  if(e > d / PRE_TOL) return(0);      //signal changed meanwhile
+  return((int)n);
 }
 
 //----------------------- Preset averaging filter: ---------------------------
 
-void PresetFilter(long v)
+void PresetFilter(long long v)
 {
   for(char i = 0; i < Average; i++)
-    Avg[i] = v;
+    Avg[i] = 0;
+  AvgBase = v;
+  AvgSum = 0;
+  AvgSh = 0;
   AvgPnt = 0;
-  AvgVal = (long long)v * Average;
+  MedPnt = 0;
+  MedCnt = 0;
+}
+
+//------------------- Add value to averaging filter: ------------------------
+
+//values are kept as int deviations from AvgBase in steps of 2^AvgSh,
+//the step is doubled when a deviation does not fit,
+//returns 0 if value is over 1/4 of base away (filter must be preset)
+
+bool AvgAdd(long long v)
+{
+  long long d = v - AvgBase;
+  long long b = AvgBase < 0? -AvgBase : AvgBase;
+  if(d > b / 4 || d < -b / 4) return(0);
+  long long q;
+  for(;;)
+  {
+    long long s = 1LL << AvgSh;        //deviation step
+    q = (d < 0? d - s / 2 : d + s / 2) / s;
+    if(q >= -AVG_DEV && q <= AVG_DEV) break;
+    AvgSh++;                           //double the step
+    AvgSum = 0;
+    for(char i = 0; i < Average; i++)
+    {
+      Avg[i] /= 2;
+      AvgSum += Avg[i];
+    }
+  }
+  AvgSum = AvgSum - Avg[AvgPnt] + (int)q;
+  Avg[AvgPnt] = q;
+  if(++AvgPnt >= Average) AvgPnt = 0;
+  return(1);
+}
+
+//------------------- Averaging filter mean value: ---------------------------
+
+long long AvgMean(void)
+{
+  long long s = (long long)AvgSum * (1LL << AvgSh);
+  return(AvgBase + (s < 0? s - Average / 2 : s + Average / 2) / Average);
+}
+
+//---------------------- Add value to median window: -------------------------
+
+//MedSort is kept sorted: the oldest value is removed,
+//the new one inserted, O(MED_SIZE) per value
+
+void MedianAdd(long long v)
+{
+  char i = MedCnt;
+  if(MedCnt < MED_SIZE) MedCnt++;
+    else
+    {
+      long long o = MedRing[MedPnt];  //remove oldest value:
+      for(i = 0; MedSort[i] != o; i++);
+      for(; i < MED_SIZE - 1; i++)
+        MedSort[i] = MedSort[i + 1];
+    }
+  for(; i > 0 && MedSort[i - 1] > v; i--) //insert new value
+    MedSort[i] = MedSort[i - 1];
+  MedSort[i] = v;
+  MedRing[MedPnt] = v;
+  if(++MedPnt >= MED_SIZE) MedPnt = 0;
+}
+
+//------------------------ Median of window values: --------------------------
+
+long long Median(void)
+{
+  return(MedSort[MedCnt / 2]);
+}
+
+//-------------------- Median absolute deviation (MAD): ----------------------
+
+//deviations from the median grow both ways from it in MedSort,
+//so the rank MedCnt / 2 one is found by merging the two sides
+
+long long MedianDev(void)
+{
+  signed char m = MedCnt / 2;
+  signed char l = m - 1, h = m + 1;
+  long long med = MedSort[m];
+  long long d = 0;
+  for(char k = 0; k < MedCnt / 2; k++)
+  {
+    if(l >= 0 && (h >= MedCnt || med - MedSort[l] <= MedSort[h] - med))
+      d = med - MedSort[l--];
+        else d = MedSort[h++] - med;
+  }
+  return(d);
+}
+
+//--------------------------- Averaging filter: ------------------------------
+
+//runs once per result on full precision values,
+//so the display and the result stream get the same average,
+//v - value, 1E-9 of display units, returns averaged value
+
+long long Count_Filter(long long v)
+{
+  if(v > VAL_MAX) v = VAL_MAX;        //display limit, also
+  if(v < -VAL_MAX) v = -VAL_MAX;      //keeps sum in long long
+  //robust averaging:
+  if(Average > 1 && Robust)
+  {
+    long long av = AvgMean();
+    long long top = av + av / NLR;
+    long long bot = av - av / NLR;
+    MedianAdd(v);
+    long long med = Median();
+    if(v > top || v < bot)            //value out of window:
+    {
+      if(MedCnt < MED_SIZE / 2 + 1 || med > top || med < bot)
+      {
+        PresetFilter(v);              //median moved too, new value
+        MedianAdd(v);
+        return(v);
+      }
+      v = med;                        //isolated outlier, use median
+    }
+    else if(MedCnt == MED_SIZE)       //Hampel identifier in window:
+    {
+      long long d = v > med? v - med : med - v;
+      long long mad = MedianDev();
+      if(mad && d * 10 > mad * HAMPEL)
+        v = med;                      //outlier, use median
+    }
+    if(!AvgAdd(v))
+    {
+      PresetFilter(v);                //too far from base, new value
+      MedianAdd(v);
+      return(v);
+    }
+    v = AvgMean();
+  }
+  //averaging:
+  else if(Average > 1)
+  {
+    //add to array and sum:
+    if(!AvgAdd(v))
+    {
+      PresetFilter(v);                //too far from base, new value
+      return(v);
+    }
+    //calculate averaged value:
+    long long av = AvgMean();
+    //non-linear filtering:
+    long long top = av + av / NLR;
+    long long bot = av - av / NLR;
+    if(v > top || v < bot)
+      PresetFilter(v);
+        else v = av;
+  }
+  return(v);
 }
 
 //----------------------------------------------------------------------------
@@ -351,6 +877,7 @@ void PresetFilter(long v)
 void Count_SetFref(long f)
 {
   Fref = f;
+  Count_AutoF();
 }
 
 //-------------------------- Set counter mode: -------------------------------
@@ -362,16 +889,43 @@ void Count_SetMode(char m)
   if(m == MODE_HI) { Port_MODE0_1; Port_MODE1_0; Port_MODE2_0; }
   else if(m == MODE_LO) { Port_MODE0_0; Port_MODE1_1; Port_MODE2_0; }
   else { Port_MODE0_0; Port_MODE1_0; Port_MODE2_0; }
+  //auto mode starts with probe gate:
+  Probe = (m == MODE_A);
+  AutoP = 0;
   //clear count:
   Freq = PulseH = PulseL = 0;
+  ResVal = 0;
   PresetFilter(0);
 }
 
+//------------------------ Get actual counter mode: --------------------------
+
+//returns MODE_F or MODE_P for auto mode
+
+char Count_GetMode(void)
+{
+  if(Mode == MODE_A) return(AutoP? MODE_P : MODE_F);
+  return(Mode);
+}
+
 //--------------------------- Set gate time: ---------------------------------
 
-void Count_SetGate(int g)
+void Count_SetGate(long g)
+{
+  T_Gate = (g * 1000) / (int)T_SYS;
+  Count_AutoF();
+}
+
+//------------------- Auto mode F/P switch frequency: ------------------------
+
+//F/P switch is at sqrt(Fref / Tgate) of counted frequency: frequency
+//(counted pulses) and period (reference pulses per counted period)
+//resolutions are the same there, 3.6 kHz for 1 s gate
+
+void Count_AutoF(void)
 {
-  T_Gate = (g * 1000L) / (int)T_SYS;
+  if(!T_Gate) return;
+  AutoF = Calc_Sqrt((unsigned long long)Fref * (long)(1E7 / T_SYS) / T_Gate);
 }
 
 //----------------------- Set number of averages: ----------------------------
@@ -393,10 +947,36 @@ void Count_SetIF(long f)
 
 //------------------------ Set prescaler ratio: ------------------------------
 
-void Count_SetPre(int p)
+//ratio is sent to the prescaler MCU only if the divider is on,
+//the answer is the ratio the MCU has loaded into the LMX2324
+//(it is not read back from the LMX2324 itself),
+//m - ratio measured with p loaded (Count_GetPreMeas), 0 - none,
+//it is used over the answer: it is the one the signal sees,
+//returns 0 if the answered or the measured ratio is other
+
+bool Count_SetPre(int p, int m)
 {
   if(p < 1) p = 1;
   Prescale = p;
+  int a = 0;
+  if(Pin_FDIV)                  //divider is on, query
+    a = Pre_Load(Pre_Valid(p)? p : 0); //load LMX2324 ratio
+  if(m) a = m;                  //measured ratio
+  if(!a || a == p) return(1);   //no answer or ratio loaded
+  Prescale = a;                 //count with the actual ratio
+  return(0);
+}
+
+//--------------------- Get measured prescaler ratio: ------------------------
+
+//returns the ratio measured by two paths since the last call,
+//0 - none (see Count_PathRatio)
+
+int Count_GetPreMeas(void)
+{
+  int n = PreMeas;
+  PreMeas = 0;
+  return(n);
 }
 
 //-------------------- Interpolator enable/disable: --------------------------
@@ -406,6 +986,50 @@ void Count_SetInt(bool s)
   Interpolate = s;
 }
 
+//---------------------- Robust filter enable/disable: -----------------------
+
+//0 - value out of av/NLR window presets averaging filter,
+//1 - isolated outliers are replaced by median of MED_SIZE values:
+//    out of the window, or over HAMPEL MADs from the median in it,
+//    filter is preset when the median leaves the window
+
+void Count_SetFilter(bool r)
+{
+  Robust = r;
+  PresetFilter(0);
+}
+
+//----------------------- Set statistics window: -----------------------------
+
+//t = 0 - last l results (WIN_SIZE max),
+//t = 1 - results of last l ms (WIN_SIZE results max),
+//results are expired when a new one is added
+
+void Count_SetWin(bool t, long l)
+{
+  if(l < 1) l = 1;
+  WinT = t? l * (long)(1000 / T_SYS) : 0;
+  WinLen = (t || l > WIN_SIZE)? WIN_SIZE : (char)l;
+  Count_WinClear();
+}
+
+//------------------ Set fast mode periods per result: -----------------------
+
+//k = 0 - gate time is used, pause between gates
+//k > 0 - gate of k input periods, wait for input edge
+//is limited by FAST_TOUT; next gate is opened as soon as
+//the result is taken, without pause and calibration,
+//but CPLD starts it on the next edge after the finishing
+//one, so one counted period is lost between gates
+//(k = 1 measures every second period), more if the
+//period is shorter than result processing (~1 ms)
+
+void Count_SetFast(char k)
+{
+  Fast = k;
+  FastGate = 1;
+}
+
 //------------------------- Set result scale: --------------------------------
 
 void Count_SetScale(char s)
@@ -422,6 +1046,8 @@ void Count_Stop(void)
 {
   Port_GATE_0;         //disable count
   Port_LED_0;          //GATE LED off
+  Sync = SyncArm = 0;  //leave sync mode
+  GateSeq = ResSeq = 0;
   State = ST_STOP;
 }
 
@@ -431,11 +1057,81 @@ void Count_Start(void)
 {
   if(Mode == MODE_D)
   {
-    DutyH = !DutyH;
-    if(DutyH) { Port_MODE0_1; Port_MODE1_0; Port_MODE2_0; }
-      else { Port_MODE0_0; Port_MODE1_1; Port_MODE2_0; }
+    DutyH = 1;                //window starts with H-pulse
+    DutySub = 2 * DUTY_SUB;
+    PulseH = PulseL = 0;
+    Count_DutyMode();
+  }
+  if(Fast && State == ST_READY && !Sync && !SyncArm)
+  {                           //fast mode: next gate at once
+    Count_Clear();            //counters clear
+    Port_GATE_1;              //enable count
+    Cnt_Timer = ms2sys(FAST_TOUT); //load wait interval
+    FastRun = 1;              //keep calibration value
+    State = ST_WAIT;          //switch to WAIT state
   }
-  State = ST_START;
+  else State = ST_START;
+}
+
+//------------------------- Sync command received: ---------------------------
+
+//called from UART RX interrupt:
+//first command arms counter, so it stops after current measure
+//and waits with pre-calibration done; every next command opens
+//the gate immediately, so latency is defined by UART only
+
+void Count_Sync(void)
+{
+  if(!Sync)
+  {
+    SyncArm = 1;       //request sync mode
+    return;
+  }
+  SyncSeq++;           //sync sequence number
+  if(State == ST_ARMED && !Synced)
+  {
+    Count_Clear();     //counters clear
+    Port_GATE_1;       //enable count
+    GateSeq = SyncSeq; //sequence number of the command that opened the gate
+    Synced = 1;
+  }
+}
+
+//-------------------- Read result sequence number: --------------------------
+
+//returns 0 if result was not started by sync command
+
+unsigned int Count_GetSeq(void)
+{
+  return(ResSeq);
+}
+
+//---------------------------- Check new result: -----------------------------
+
+//returns 1 once per measurement
+
+bool Count_NewResult(void)
+{
+  if(!ResNew) return(0);
+  ResNew = 0;
+  return(1);
+}
+
+//---------------------------- Read last result: -----------------------------
+
+//n - result number
+//t - result time, ms
+//m - counter mode
+//returns averaged value, 1E-9 of display units:
+//frequency - uHz (kHz * 1E-9), period - ps (ms * 1E-9),
+//rpm - rpm * 1E-9, duty cycle - 1E-9
+
+long long Count_GetResult(unsigned int *n, unsigned long *t, char *m)
+{
+  *n = ResNum;
+  *t = (unsigned long long)ResTime * (long)T_SYS / 1000;
+  *m = Count_GetMode();
+  return(ResVal);
 }
 
 //---------------------- Enter calibration mode: -----------------------------
@@ -466,45 +1162,22 @@ void Count_ClearStat(void)
 {
   Fmax = Fmin = Fnom = Freq;
   Fdev = 0;
+  Count_WinClear();
 }
 
-//------------------------ Read counter result: ------------------------------
+//------------------------- Calculate mode value: ----------------------------
 
-//8-dig:
-//0.0000000  Scale = 2 Res = 100 uHz F = Freq / 100
-//0000000.0  Scale = 8 Res = 100 Hz  F = Freq / 100000000
-//9-dig:
-//0.00000000 Scale = 1 Res = 10 uHz  F = Freq / 10
-//00000000.0 Scale = 8 Res = 100 Hz  F = Freq / 100000000
+//returns value of current mode, 1E-9 of display units
 
-//8-dig:
-//0.0000000  Scale = 2 Res = 100 ps  P = Per / 100
-//0000000.0  Scale = 8 Res = 100 us  P = Per / 100000000
-//9-dig:
-//0.00000000 Scale = 1 Res = 10 ps   P = Per / 10
-//00000000.0 Scale = 8 Res = 100 us  P = Per / 100000000
-
-const __flash long ScaleTable[] =
+long long Count_Value(void)
 {
-  10,
-  100,
-  1000,
-  10000,
-  100000,
-  1000000,
-  10000000,
-  100000000
-};
-
-long Count_GetValue(void)
-{
-  long s = ScaleTable[Scale - 1]; //scale factor
   long long v = 0; //result
 
   switch(Mode)
   {
   case MODE_F:   //frequency:
-    v = Freq;    //Freq - frequency, uHz
+  case MODE_A:   //auto frequency/period:
+    v = Freq;    //Freq - frequency, uHz or period, ps
     break;
   case MODE_FIF: //frequency  IF:
     v = Freq + (long long)IFreq * 100000000;
@@ -517,8 +1190,14 @@ long Count_GetValue(void)
   case MODE_D:   //duty cycle:
     if(PulseH && PulseL)
     {
-      v = ((long long)PulseH * 1000000000 +
-             (PulseL + PulseH) / 2) / (PulseL + PulseH);
+      long long h = PulseH;
+      long long s = PulseL + PulseH;
+      while(s > 0x7FFFFFFFFFFFFFFF / 1000000000) //long gate
+      {
+        h = h >> 1;
+        s = s >> 1;
+      }
+      v = (h * 1000000000 + s / 2) / s;
     }
     break;
   case MODE_R:   //rpm:
@@ -533,33 +1212,55 @@ long Count_GetValue(void)
   case MODE_DF:  //frequency deviation:
     v = Fdev;
     break;
+  case MODE_FHW: //window statistics:
+  case MODE_FLW:
+  case MODE_FMW:
+  case MODE_FSW:
+    v = Count_WinStat(Mode);
+    break;
   }
+  return(v);
+}
+
+//------------------------ Read counter result: ------------------------------
 
+//8-dig:
+//0.0000000  Scale = 2 Res = 100 uHz F = Freq / 100
+//0000000.0  Scale = 8 Res = 100 Hz  F = Freq / 100000000
+//9-dig:
+//0.00000000 Scale = 1 Res = 10 uHz  F = Freq / 10
+//00000000.0 Scale = 8 Res = 100 Hz  F = Freq / 100000000
+
+//8-dig:
+//0.0000000  Scale = 2 Res = 100 ps  P = Per / 100
+//0000000.0  Scale = 8 Res = 100 us  P = Per / 100000000
+//9-dig:
+//0.00000000 Scale = 1 Res = 10 ps   P = Per / 10
+//00000000.0 Scale = 8 Res = 100 us  P = Per / 100000000
+
+const __flash long ScaleTable[] =
+{
+  10,
+  100,
+  1000,
+  10000,
+  100000,
+  1000000,
+  10000000,
+  100000000
+};
+
+long Count_GetValue(void)
+{
+  Bench_Start(BENCH_VALUE);
+  long s = ScaleTable[Scale - 1]; //scale factor
+  long long v = ResVal; //averaged result
   if(v < 0) v = (v - s / 2) / s;
     else v = (v + s / 2) / s;
   if(v > 0x7FFFFFFF) v = 0x7FFFFFFF;   //limit to long
   if(v < -0x7FFFFFFF) v = -0x7FFFFFFF;
-  long res = (long)v;
-
-  //averaging:
-  if(Average > 1)
-  {
-    //calculate sum:
-    AvgVal = AvgVal - Avg[AvgPnt] + res;
-    //update array:
-    Avg[AvgPnt] = res;
-    //calculate averaged value:
-    long av = (AvgVal + Average / 2) / Average;
-    //advance pointer:
-    if(++AvgPnt >= Average) AvgPnt = 0;
-    //non-linear filtering:
-    long top = av + av / NLR;
-    long bot = av - av / NLR;
-    if(res > top || res < bot)
-      PresetFilter(res);
-        else res = av;
-  }
-  return(res);
+  Bench_Stop(BENCH_VALUE);
+  return((long)v);
 }
 
 //----------------------------------------------------------------------------
@@ -10,7 +10,7 @@
 
 //------------------------------- Constants: ---------------------------------
 
-//Counter modes:
+//Counter modes (EEPROM order: new ones are appended):
 
 enum
 {
@@ -24,10 +24,16 @@ enum
   MODE_FH,  //frequency high statictic mode
   MODE_FL,  //frequency low statictic mode
   MODE_DF,  //frequency deviation statictic mode
+  MODE_A,   //auto frequency/period meter mode
+  MODE_FHW, //frequency high window statistic mode
+  MODE_FLW, //frequency low window statistic mode
+  MODE_FMW, //frequency mean window statistic mode
+  MODE_FSW, //frequency std. deviation window statistic mode
   MODES     //modes count
 };
 
 #define MAX_SCALE 8 //max scaling factor
+#define WIN_SIZE  8 //statistics window size, results (power of 2)
 
 //------------------------- Function prototypes: -----------------------------
 
@@ -36,20 +42,29 @@ void Count_Exe(bool t);      //execute count process
 
 void Count_SetFref(long f);  //set reference frequency
 void Count_SetMode(char m);  //set counter mode
-void Count_SetGate(int g);   //set gate time, ms
+char Count_GetMode(void);    //get actual counter mode
+void Count_SetGate(long g);  //set gate time, ms
 void Count_SetAvg(char n);   //set number of averages
 void Count_SetIF(long f);    //set IF value
-void Count_SetPre(int p);    //set prescaler ratio
+bool Count_SetPre(int p, int m); //set prescaler ratio
+int  Count_GetPreMeas(void); //get measured prescaler ratio
 void Count_SetInt(bool s);   //interpolator enable/disable
+void Count_SetFast(char k);  //set fast mode periods per result
+void Count_SetFilter(bool r); //robust filter enable/disable
+void Count_SetWin(bool t, long l); //set statistics window
 void Count_SetScale(char s); //set result scale
 
 void Count_Stop(void);       //stop counter
 void Count_Start(void);      //start counter
 bool Count_Ready(void);      //read counter ready
 long Count_GetValue(void);   //read counter result
+bool Count_NewResult(void);  //check new result
+long long Count_GetResult(unsigned int *n, unsigned long *t, char *m); //read last result
 void Count_StartCalib(void); //enter calibration mode
 int  Count_GetCalib(void);   //read interpolator calibration value
 void Count_ClearStat(void);  //clear statistics
+void Count_Sync(void);       //sync command received
+unsigned int Count_GetSeq(void); //read result sequence number
 
 //----------------------------------------------------------------------------
 
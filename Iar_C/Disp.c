@@ -13,6 +13,7 @@
 
 #define MSG_SIZE 16        //size of message string
 #define DIGITS   10        //number of BCD digits
+#define LDIGITS  20        //number of BCD digits for long long
 
 //------------------------------ Variables: ----------------------------------
 
@@ -26,6 +27,7 @@ static char Pos;           //current position
 //------------------------- Function prototypes: -----------------------------
 
 void Long2BCD(unsigned long x, char *buff); //convert long to BCD
+void LLong2BCD(unsigned long long x, char *buff); //convert long long to BCD
 
 //------------------------- Long2BCD conversion: -----------------------------
 
@@ -35,6 +37,7 @@ void Long2BCD(unsigned long x, char *buff); //convert long to BCD
 
 void Long2BCD(unsigned long x, char *buff)
 {
+  Bench_Start(BENCH_BCD);
   for(char i = 0; i < 10; i++)
     buff[i] = 0;                      //output buffer clear
   for(char i = 0; i < 32; i++)        //cycle for input bits count
@@ -50,6 +53,48 @@ void Long2BCD(unsigned long x, char *buff)
       buff[p] = s;                    //save digit
     }
   }
+  Bench_Stop(BENCH_BCD);
+}
+
+//------------------------ LLong2BCD conversion: -----------------------------
+
+//Convert binary digit to BCD:
+//x - input binary digit (64 bits, unsigned)
+//buff - output array (20 digits)
+
+const __flash unsigned long long Pow10[LDIGITS] =
+{
+  10000000000000000000ULL,
+  1000000000000000000,
+  100000000000000000,
+  10000000000000000,
+  1000000000000000,
+  100000000000000,
+  10000000000000,
+  1000000000000,
+  100000000000,
+  10000000000,
+  1000000000,
+  100000000,
+  10000000,
+  1000000,
+  100000,
+  10000,
+  1000,
+  100,
+  10,
+  1
+};
+
+void LLong2BCD(unsigned long long x, char *buff)
+{
+  for(char i = 0; i < LDIGITS; i++)   //cycle for digits number
+  {
+    unsigned long long p = Pow10[i];  //digit weight
+    char d = 0;
+    while(x >= p) { x -= p; d++; }    //subtract weight
+    buff[i] = d;                      //save digit
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -74,6 +119,7 @@ static __flash char Str_UniN[] = "   "; //no units
 
 void Disp_Update(void)
 {
+  Bench_Start(BENCH_UPDATE);
   char pos = Pos;
   //add units:
   Disp_SetPos(14);
@@ -132,6 +178,7 @@ void Disp_Update(void)
   }
   Pos = pos;
   Port_StartTX(); //request to TX
+  Bench_Stop(BENCH_UPDATE);
 }
 
 //---------------------------- Clear display: --------------------------------
@@ -184,6 +231,7 @@ void Disp_PutString(char __flash *s)
 
 void Disp_Val(char s, char p, long v)
 {
+  Bench_Start(BENCH_VAL);
   char i; bool minus = 0;
   s--; p--; //align to 0..9 range
   char n = s;
@@ -226,6 +274,7 @@ void Disp_Val(char s, char p, long v)
       if(i == p) Msg[n++] = '.'; //insert point
     }
   }
+  Bench_Stop(BENCH_VAL);
 }
 
 //--------------------- Get char from message buffer: ------------------------
@@ -235,4 +284,28 @@ char Disp_GetChar(char n)
   return(Msg[n]);
 }
 
+//-------------------------- Format long long: -------------------------------
+
+//b - output buffer (LDIGITS + 2 chars min)
+//v - value
+//d - decimals, 0 - no point
+//returns text length
+
+char Disp_Fmt(char *b, long long v, char d)
+{
+  char bcd[LDIGITS];
+  char n = 0;
+  unsigned long long x = v;
+  if(v < 0) { x = -v; b[n++] = '-'; }
+  LLong2BCD(x, bcd);
+  bool z = 1;                         //leading zero flag
+  for(char i = 0; i < LDIGITS; i++)
+  {
+    if(bcd[i] || (i >= LDIGITS - d - 1)) z = 0;
+    if(!z) b[n++] = bcd[i] + 0x30;
+    if(d && (i == LDIGITS - d - 1)) b[n++] = '.'; //insert point
+  }
+  return(n);
+}
+
 //----------------------------------------------------------------------------
@@ -15,6 +15,7 @@
   #define LCD_SIZE 10       //size of LCD10
 #endif
 #define POINT 0x80          //decimal point
+#define FULL_DEC 9          //full precision value decimals
 
 //------------------------- Function prototypes: -----------------------------
 
@@ -26,6 +27,7 @@ void Disp_PutChar(char ch); //display char
 void Disp_PutString(char __flash *s);  //display string
 void Disp_Val(char s, char p, long t); //display value
 char Disp_GetChar(char n);  //get char from display buffer
+char Disp_Fmt(char *b, long long v, char d); //format long long value
 
 //----------------------------------------------------------------------------
 
@@ -30,6 +30,7 @@ void Keyboard_Init(void)
 
 char Keyboard_Scan(void)
 {
+  Bench_Start(BENCH_SCAN);
   char d = 0xEF;
   for(char i = 0; i < 8; i++)
   {
@@ -40,6 +41,7 @@ char Keyboard_Scan(void)
     Port_SCLK_1;
     if(Pin_RETL) d = d | 1;
   }
+  Bench_Stop(BENCH_SCAN);
   return(~d & 0x0F);
 }
 
@@ -23,6 +23,24 @@
 #ifdef LCD1602
   //#define DIG_DISPLAY   //enable digital level display in dBm
 #endif
+//#define BENCH BENCH_MAKE  //enable hot path cycle measurement probe
+
+//---------------------------- Hot path probe: -------------------------------
+
+//In BENCH build the selected hot path drives PROBE pin high for its
+//duration. The pulse width measured under simavr (ATmega8, 8 MHz) or by
+//a logic analyzer gives the exact cycle count of the path. PROBE is the
+//gate LED pin, the LED is not driven by the firmware in BENCH build.
+//Host/Bench runs all paths under simavr ("make bench" in Host).
+
+#define BENCH_MAKE   1 //Count_Make
+#define BENCH_VALUE  2 //Count_GetValue
+#define BENCH_BCD    3 //Long2BCD
+#define BENCH_VAL    4 //Disp_Val
+#define BENCH_UPDATE 5 //Disp_Update
+#define BENCH_CPLD   6 //Get_CPLD
+#define BENCH_CALIB  7 //Count_Calib
+#define BENCH_SCAN   8 //Keyboard_Scan
 
 //------------------------------- Constants: ---------------------------------
 
@@ -55,13 +73,16 @@
 #define LOAD   (1 << PB3) //OL - LCD load strobe
 #define DATA   (1 << PB4) //OX - LCD serial data
 #define SCLK   (1 << PB5) //OX - LCD serial clock
-#define NC_PB6 (1 << PB6) //IL - not used
-#define NC_PB7 (1 << PB7) //IL - not used
+#define NC_PB6 (1 << PB6) //IL - not used (XTAL1)
+#define PLINK  (1 << PB7) //BL - prescaler link (open drain)
+
+//PB7 (XTAL2) is free with both external clock and internal RC,
+//so the link works with either of them.
 
 //Direction:
 #define I_DDRB  (SCLOCK | LOAD | DATA | SCLK)
 //Pull-ups (in) or initial state (out):
-#define I_PORTB (SDATA | RETL | LOAD | DATA | SCLK | NC_PB6 | NC_PB7)
+#define I_PORTB (SDATA | RETL | LOAD | DATA | SCLK | NC_PB6 | PLINK)
 //Port control macros:
 #define Port_SCLOCK_0 (PORTB &= ~SCLOCK)
 #define Port_SCLOCK_1 (PORTB |= SCLOCK)
@@ -73,6 +94,9 @@
 #define Port_DATA_1   (PORTB |= DATA)
 #define Port_SCLK_0   (PORTB &= ~SCLK)
 #define Port_SCLK_1   (PORTB |= SCLK)
+#define Port_PLINK_0  (PORTB &= ~PLINK, DDRB |= PLINK) //drive low
+#define Port_PLINK_1  (DDRB &= ~PLINK, PORTB |= PLINK) //release, pull-up
+#define Pin_PLINK     (PINB & PLINK)
 
 //------------------------------- Port C: ------------------------------------
 
@@ -83,6 +107,7 @@
 #define RESET  (1 << PC4) //OL - CPLD reset
 #define CALIB  (1 << PC5) //OH - CPLD calibrate
 #define NC_PC6 (1 << PC6) //IL - not used
+#define PROBE  LED        //OH - hot path probe (BENCH build only)
 
 //Direction:
 #define I_DDRC  (LED | SND | FSYNC | RESET | CALIB)
@@ -90,8 +115,15 @@
 #define I_PORTC (FDIV | SND | FSYNC | RESET | NC_PC6)
 //Port control macros:
 #define Pin_FDIV      (PINC & FDIV)
+#ifdef BENCH
+#define Port_LED_0    ((void)0)     //LED pin is PROBE
+#define Port_LED_1    ((void)0)
+#define Port_PROBE_0  (PORTC &= ~PROBE)
+#define Port_PROBE_1  (PORTC |= PROBE)
+#else
 #define Port_LED_0    (PORTC &= ~LED)
 #define Port_LED_1    (PORTC |= LED)
+#endif
 #define Port_SND_0    (PORTC &= ~SND)
 #define Port_SND_1    (PORTC |= SND)
 #define Port_SND      (PORTC & SND)
@@ -134,6 +166,13 @@
 #define Delay_us(x) __delay_cycles((int)(x * F_CLK + 0.5))
 #define ms2sys(x) ((int)(1E3 * x / T_SYS))
 #define ABS(x) ((x < 0)? (-x) : (x))
+#ifdef BENCH
+  #define Bench_Start(x) do { if(BENCH == (x)) Port_PROBE_1; } while(0)
+  #define Bench_Stop(x)  do { if(BENCH == (x)) Port_PROBE_0; } while(0)
+#else
+  #define Bench_Start(x) do { } while(0)
+  #define Bench_Stop(x)  do { } while(0)
+#endif
 
 //----------------------------------------------------------------------------
 
@@ -12,14 +12,20 @@
 #include "Port.h"
 #include "Sound.h"
 #include "Count.h"
+#include "Meter.h"
+#include "Pre.h"
 #ifdef LCD1602
-  #include "Meter.h"
   #include "Lcd.h"
 #endif
 
 //----------------------------- Constants: -----------------------------------
 
-#define SIGNATURE 0xBEDE //EEPROM signature
+#define SIGNATURE 0xBEE6 //EEPROM signature
+#define OLD_SIGN  0xBEDE //EEPROM signature of the original layout
+#define OLD_PARAMS     9 //params of the original layout (PAR_MODE..PAR_SRF)
+#define OLD_MODES     10 //modes of the original layout (MODE_F..MODE_DF)
+#define PAR_ROOM      24 //EEPROM room for params, PARAMS max
+#define MODE_ROOM     24 //EEPROM room for scales, MODES max
 #define T_SPLASH    2500 //splash screen indication delay, ms
 #define T_CALIB      300 //calibration update period, ms
 #define T_AUTO      2000 //auto scale indication time, ms
@@ -33,41 +39,58 @@ enum
   MNU_SPLASH, //splash screen menu code
   MNU_MAIN,   //main menu code
   MNU_AUTO,   //auto scale indication menu
+  MNU_PRE,    //prescaler ratio mismatch menu
   MNU_SETUP,  //setup menu code
 };
 
-enum
-{
-  PAR_MODE, //mode parameter index
-  PAR_GATE, //gate parameter index
-  PAR_AVG,  //average parameter index
-  PAR_IF,   //IF parameter index
-  PAR_PRE,  //prescaler parameter index
-  PAR_INT,  //interpolator parameter index
-  PAR_RF,   //RF parameter index
-  PAR_SIF,  //IF step parameter index
-  PAR_SRF,  //RF step parameter index
-  PARAMS    //params count
-};
-
-enum
-{ P_MIN,    //min value
-  P_NOM,    //nom value
-  P_MAX,    //max value
-  LIMS
-};
-
 const __flash long ParLim[PARAMS][LIMS] =
 {
   {        0,    MODE_F, MODES - 1 }, //PAR_MODE
-  {        1,      1000,     10000 }, //PAR_GATE
+#ifdef HI_RES
+  {        1,      1000,   1000000 }, //PAR_GATE
+#else
+  {        1,      1000,    500000 }, //PAR_GATE
+#endif
   {        1,         1,       100 }, //PAR_AVG
   {  -999999,         0,    999999 }, //PAR_IF
-  {        1,         1,      1000 }, //PAR_PRE
+  {        1,         1,     32767 }, //PAR_PRE
   {        0,         1,         1 }, //PAR_INT
   { 10000000, 128000000, 999999999 }, //PAR_RF
   {        1,        10,    100000 }, //PAR_SIF
   {        1,         1, 100000000 }, //PAR_SRF
+  {        0,         0,        99 }, //PAR_ADR
+  {        0,         0,         1 }, //PAR_OUT
+  {        0,         0,       100 }, //PAR_FAST
+  {        0,         0,         1 }, //PAR_FLT
+  {  CAL_MIN,         0,   CAL_MAX }, //PAR_LVL
+  {        0,         0,         1 }, //PAR_WIN
+  {        1,  WIN_SIZE,    100000 }, //PAR_WLEN
+};
+
+//setup menu order, param of MENU key (PARAMS - last param, exit):
+
+static __flash char ParNext[PARAMS] =
+{
+  PAR_GATE, //PAR_MODE
+  PAR_AVG,  //PAR_GATE
+  PAR_IF,   //PAR_AVG
+  PAR_PRE,  //PAR_IF
+  PAR_ADR,  //PAR_PRE
+  PARAMS,   //PAR_INT
+#ifdef DIG_DISPLAY
+  PAR_LVL,  //PAR_RF
+#else
+  PARAMS,   //PAR_RF
+#endif
+  PARAMS,   //PAR_SIF
+  PARAMS,   //PAR_SRF
+  PAR_OUT,  //PAR_ADR
+  PAR_FAST, //PAR_OUT
+  PAR_FLT,  //PAR_FAST
+  PAR_WIN,  //PAR_FLT
+  PARAMS,   //PAR_LVL
+  PAR_WLEN, //PAR_WIN
+  PAR_INT,  //PAR_WLEN
 };
 
 //----------------------------- Variables: -----------------------------------
@@ -80,18 +103,35 @@ static char KeyCode;     //last pressed key code
 static bool Repeat;      //repeat flag
 static bool Hold;        //display hold flag
 static bool Hide;        //display hide flag
+static bool PreErr;      //prescaler ratio mismatch flag
+static bool Fdiv;        //divider state at last prescaler setup
 static char Scale;       //current value scale
 static long Par[PARAMS]; //params array
 
+//Original layout, read once to migrate it: params and modes are
+//appended to the enums, so the old ones keep their indexes.
+__no_init __eeprom int  EOldSign;   //EEPROM signature
+__no_init __eeprom long EOldPar[OLD_PARAMS];
+__no_init __eeprom char EOldScale[OLD_MODES];
+
+//Layout with room for params and modes appended later,
+//the ones not saved yet get their defaults:
 __no_init __eeprom int  ESignature; //EEPROM signature
-__no_init __eeprom long EPar[PARAMS];
-__no_init __eeprom char EScale[MODES]; //Scales in EEPROM
+__no_init __eeprom char EParams;    //params saved
+__no_init __eeprom char EModes;     //scales saved
+__no_init __eeprom long EPar[PAR_ROOM];
+__no_init __eeprom char EScale[MODE_ROOM]; //Scales in EEPROM
+
+//Prescaler ratio measured by two paths, PAR_PRE it was measured with:
+__no_init __eeprom int  EPreMeas;
+__no_init __eeprom int  EPreFor;
 
 //------------------------- Function prototypes: -----------------------------
 
 void Mnu_Splash(bool ini);    //splash screen menu
 void Mnu_Main(bool ini);      //main menu
 void Mnu_Auto(bool ini);      //auto scale indication menu
+void Mnu_Pre(bool ini);       //prescaler ratio mismatch menu
 void Mnu_Setup(bool ini);     //setup menu
 
 void ParToEEPROM(void);       //save params to the EEPROM
@@ -100,6 +140,10 @@ void Show_Setup(char m);      //show setup menu
 bool MoveDP(char key);        //move DP
 bool ParUpDn(char m, bool dir); //param step up/down
 void SetupCounter(void);      //send params to counter
+int  PreMeasured(void);       //measured prescaler ratio for PAR_PRE
+void SetupExit(void);         //save params and exit setup menu
+void ParCommand(void);        //parameter command via UART
+bool ParValid(char m, long v); //check param value
 
 //------------------------------ Menu init: ----------------------------------
 
@@ -112,19 +156,32 @@ void Menu_Init(void)
   Meter_Init();               //level meter init
 #endif
 
-  if(ESignature != SIGNATURE) //check EEPROM signature, if error, init params:
+  char np = 0, nm = 0;        //params and scales saved
+  bool old = 0;               //original layout
+  if(ESignature == SIGNATURE) //check EEPROM signature
+  {
+    np = EParams;
+    nm = EModes;
+  }
+  else if(EOldSign == OLD_SIGN) //original layout, migrate
   {
-    for(char i = 0; i < PARAMS; i++)
-      Par[i] = ParLim[i][P_NOM];
-    ParToEEPROM();                        //params init
-    for(char i = 0; i < MODES; i++)
-      EScale[i] = SCALE_NOM + AUTO_SCALE; //scales init
+    np = OLD_PARAMS;
+    nm = OLD_MODES;
+    old = 1;
   }
-  else
+  for(char i = 0; i < PARAMS; i++)        //read params from EEPROM
   {
-    for(char i = 0; i < PARAMS; i++)
-      Par[i] = EPar[i];                   //read params from EEPROM
+    Par[i] = ParLim[i][P_NOM];            //not saved: default
+    if(i < np) Par[i] = old? EOldPar[i] : EPar[i];
   }
+  for(char i = 0; i < MODES; i++)         //read scales from EEPROM
+  {
+    char s = SCALE_NOM + AUTO_SCALE;      //not saved: default
+    if(i < nm) s = old? EOldScale[i] : EScale[i];
+    if(EScale[i] != s) EScale[i] = s;
+  }
+  ParToEEPROM();                          //save in new layout
+  PreErr = 0;
   SetupCounter();
   Count_Start();              //start counter
 
@@ -149,6 +206,8 @@ void Menu_Exe(bool t)
     if(MenuTimer) MenuTimer--;    //menu timer processing
   }
 
+  ParCommand();                   //parameter command via UART
+
   KeyCode = Keyboard_GetCode();   //read key code
   Repeat = KeyCode & REP_R;       //set/clear repeat flag
   KeyCode &= ~REP_R;              //clear repeat flag in key code
@@ -161,6 +220,7 @@ void Menu_Exe(bool t)
   case MNU_SPLASH:  Mnu_Splash(MnuIni); break; //splash screen menu
   case MNU_MAIN:    Mnu_Main(MnuIni);   break; //main menu
   case MNU_AUTO:    Mnu_Auto(MnuIni);   break; //auto scale menu
+  case MNU_PRE:     Mnu_Pre(MnuIni);    break; //prescaler mismatch menu
   case MNU_SETUP:   Mnu_Setup(MnuIni);  break; //setup menu
   }
 
@@ -205,7 +265,7 @@ void Mnu_Splash(bool ini)
 #ifdef LCD1602
     Meter_Clear();
 #endif
-    Menu = MNU_MAIN;             //go to main menu
+    Menu = PreErr? MNU_PRE : MNU_MAIN; //go to main menu
   }
 }
 
@@ -233,6 +293,22 @@ void Mnu_Main(bool ini)
   {
     DispMenu = MNU_NO;           //redraw menu
   }
+  //divider switched, query prescaler MCU:
+  if((bool)Pin_FDIV != Fdiv)
+  {
+    Fdiv = !Fdiv;
+    if(!Count_SetPre(Par[PAR_PRE], PreMeasured()))
+      Menu = MNU_PRE;            //mismatch indication
+  }
+  //ratio measured on the switch, save it:
+  int n = Count_GetPreMeas();
+  if(n)
+  {
+    if(EPreMeas != n) EPreMeas = n;
+    if(EPreFor != Par[PAR_PRE]) EPreFor = Par[PAR_PRE];
+    if(n != Par[PAR_PRE])
+      Menu = MNU_PRE;            //mismatch indication
+  }
 #ifdef LCD1602
   if(Meter_Updated())
   {
@@ -331,6 +407,41 @@ void Mnu_Auto(bool ini)
   }
 }
 
+//----------------------------------------------------------------------------
+//--------------------- Prescaler ratio mismatch menu: -----------------------
+//----------------------------------------------------------------------------
+
+//prescaler MCU reported or two-path measurement found the ratio
+//other than PAR_PRE, counter uses that ratio, PAR_PRE is not changed
+
+void Mnu_Pre(bool ini)
+{
+  static char __flash Str_PreErr[] = "Pre Err";
+  //draw menu:
+  if(ini)                        //if redraw needed
+  {
+    Sound_Bell();                //error bell
+    Disp_Clear();                //clear display
+    Disp_SetPos(LCD_SIZE / 2 - 3);
+    Disp_PutString(Str_PreErr);  //show menu text
+    Disp_Update();               //display update
+    MenuTimer = ms2sys(T_AUTO);  //load menu timer
+    PreErr = 0;                  //error indicated
+    DispMenu = Menu;             //menu displayed
+  }
+  //check any key press:
+  if(KeyCode != KEY_NO)          //any key
+  {
+    MenuTimer = 0;               //timer clear
+    KeyCode = KEY_NO;            //key code processed
+  }
+  //check timer:
+  if(!MenuTimer)                 //timer overflow,
+  {
+    Menu = MNU_MAIN;             //go to main menu
+  }
+}
+
 //----------------------------------------------------------------------------
 //----------------------------- Setup menu: ----------------------------------
 //----------------------------------------------------------------------------
@@ -354,19 +465,33 @@ void Mnu_Setup(bool ini)
   {
     DispMenu = MNU_NO;           //redraw menu
   }
+#ifdef DIG_DISPLAY
+  //update level value:
+  if(Param == PAR_LVL && Meter_Updated())
+  {
+    Meter_Display();             //display meter line
+  }
+#endif
   //MENU key:
   if(KeyCode == KEY_MN)
   {
-    if(Param >= PAR_INT)
+    if(ParNext[Param] != PARAMS)
     {
-      KeyCode = KEY_OK;          //last param, exit
+      Param = ParNext[Param];    //new param
+      DispMenu = MNU_NO;         //redraw menu request
+      KeyCode = KEY_NO;          //key code processed
     }
-    else
+#ifdef DIG_DISPLAY
+    else if(Param == PAR_LVL)
     {
-      Param++;                   //new param
-      DispMenu = MNU_NO;         //redraw menu request
+      SetupExit();               //last param, exit
       KeyCode = KEY_NO;          //key code processed
     }
+#endif
+    else
+    {
+      KeyCode = KEY_OK;          //last param, exit
+    }
   }
   //DOWN key:
   if(KeyCode == KEY_DN)
@@ -393,12 +518,14 @@ void Mnu_Setup(bool ini)
     {
       KeyCode = KEY_UD;          //key code processed
     }
+    else if(Param == PAR_LVL)
+    {
+      Meter_CalPoint(Par[PAR_LVL]); //save level code for this point
+      KeyCode = KEY_NO;          //key code processed
+    }
     else
     {
-      ParToEEPROM();             //save parameters to EEPROM
-      SetupCounter();
-      Count_Start();             //start counter
-      Menu = MNU_MAIN;           //go to main menu
+      SetupExit();               //save parameters, exit
       KeyCode = KEY_NO;          //key code processed
     }
   }
@@ -460,9 +587,17 @@ static __flash char Str_V[MODES][4] =
   "Rot", //RPM
   "FH ", //maximum frequency
   "FL ", //minimum frequency
-  "dF "  //variation of frequency
+  "dF ", //variation of frequency
+  "A  ", //auto frequency/period
+  "FHw", //maximum frequency in window
+  "FLw", //minimum frequency in window
+  "FMw", //mean frequency in window
+  "FSw"  //std. deviation of frequency in window
 };
 
+static __flash char Str_FA[4] = "FA "; //auto mode, frequency
+static __flash char Str_PA[4] = "PA "; //auto mode, period
+
 void Show_Main(char n)
 {
   long min, max; char s;
@@ -473,7 +608,9 @@ void Show_Main(char n)
   {
     if(n == MODE_FIF)
       Disp_PutChar('f');                //display "f"
-        else Disp_PutString(Str_V[n]);  //show value name
+    else if(n == MODE_A)                //show actual auto mode
+      Disp_PutString((Count_GetMode() == MODE_P)? Str_PA : Str_FA);
+    else Disp_PutString(Str_V[n]);      //show value name
   }
 
   long v = Count_GetValue();          //read counter
@@ -486,6 +623,7 @@ void Show_Main(char n)
   case MODE_F:
   case MODE_FIF:
   case MODE_P:
+  case MODE_A:
   case MODE_D:
     s = 3;
     min = 100000000L;
@@ -504,6 +642,7 @@ void Show_Main(char n)
   case MODE_F:
   case MODE_FIF:
   case MODE_P:
+  case MODE_A:
   case MODE_D:
     s = 3;
     min = 10000000L;
@@ -555,11 +694,23 @@ static __flash char Str_P[PARAMS][5] =
   "Int ", //interpolator on/off
   "C   ", //calibration Fref
   "S   ", //IF step
-  "S   "  //Fref step
+  "S   ", //Fref step
+  "Adr ", //bus address
+  "Out ", //output mode
+  "Fast", //fast mode periods per result
+  "Flt ", //averaging filter type
+  "L   ", //level calibration point
+  "Win ", //statistics window type
+  "WLen"  //statistics window length
 };
 
 static __flash char Str_On[4] = "On ";
 static __flash char Str_Off[4] = "Off";
+static __flash char Str_Lcd[4] = "LCD";
+static __flash char Str_Res[4] = "Res";
+static __flash char Str_Nlr[4] = "NLR";
+static __flash char Str_Med[4] = "Med";
+static __flash char Str_Ms[4] = "ms ";
 
 void Show_Setup(char m)
 {
@@ -570,8 +721,13 @@ void Show_Setup(char m)
   switch(m)
   {
   case PAR_GATE:
+  case PAR_WLEN:
+    Disp_Val(5, 0, v);              //show Gate value
+    break;
   case PAR_AVG:
   case PAR_PRE:
+  case PAR_ADR:
+  case PAR_LVL:
     Disp_Val(6, 0, v);              //show Gate value
     break;
   case PAR_IF:
@@ -586,6 +742,29 @@ void Show_Setup(char m)
     Disp_SetPos(5);                 //set display position
     Disp_PutString(Str_V[(char)v]); //show value name
     break;
+  case PAR_FAST:
+    if(v) Disp_Val(6, 0, v);        //show periods per result
+    else
+    {
+      Disp_SetPos(5);               //set display position
+      Disp_PutString(Str_Off);      //fast mode off
+    }
+    break;
+  case PAR_FLT:
+    Disp_SetPos(5);                 //set display position
+    if((char)v) Disp_PutString(Str_Med); //median filter
+      else Disp_PutString(Str_Nlr); //non-linear filter
+    break;
+  case PAR_WIN:
+    Disp_SetPos(5);                 //set display position
+    if((char)v) Disp_PutString(Str_Ms); //last T ms
+      else Disp_PutString(Str_Res); //last N results
+    break;
+  case PAR_OUT:
+    Disp_SetPos(5);                 //set display position
+    if((char)v) Disp_PutString(Str_Res); //result stream
+      else Disp_PutString(Str_Lcd); //display copy
+    break;
   case PAR_INT:
     Disp_SetPos(5);                   //set display position
     if((char)v)                       //show interpolator state
@@ -620,20 +799,26 @@ bool MoveDP(char key)
   case MODE_F:
   case MODE_FIF:
   case MODE_P:
+  case MODE_A:
   case MODE_D:
-    if(s < 1) s = 1; break;
+    if(s < 1) s = 1;
+    break;
   case MODE_R:
-    if(s < 3) s = 3; break;
+    if(s < 3) s = 3;
+    break;
   default:
     if(s < 2) s = 2;
 #else
   case MODE_F:
   case MODE_FIF:
   case MODE_P:
+  case MODE_A:
   case MODE_D:
-    if(s < 2) s = 2; break;
+    if(s < 2) s = 2;
+    break;
   case MODE_R:
-    if(s < 4) s = 4; break;
+    if(s < 4) s = 4;
+    break;
   default:
     if(s < 3) s = 3;
 #endif
@@ -654,25 +839,28 @@ bool ParUpDn(char m, bool dir)
   long Max = ParLim[m][P_MAX];
   if(m == PAR_IF) s = Par[PAR_SIF];
   if(m == PAR_RF) s = Par[PAR_SRF];
+  if(m == PAR_LVL) s = CAL_STP;
+  if(m == PAR_WLEN && !Par[PAR_WIN]) Max = WIN_SIZE; //results window
   if(!dir) s = -s;
   if((dir && v < Max) || (!dir && v > Min))
   {
-    if(m == PAR_GATE || m == PAR_AVG)
+    if(m == PAR_GATE || m == PAR_AVG || (m == PAR_WLEN && Par[PAR_WIN]))
     {
-      int n = v;
+      long d = 1;
+      while(d * 10 <= v) d = d * 10; //decade of value
       if(dir)
       {
-        if(n == 2 || n == 20 || n == 200 || n == 2000)
-          n = (n * 5) / 2;  // * 2.5
-            else n = n * 2; // * 2
+        if(v == 2 * d)
+          v = (v * 5) / 2;  // * 2.5
+            else v = v * 2; // * 2
       }
       else
       {
-        if(n == 5 || n == 50 || n == 500 || n == 5000)
-          n = (n * 2) / 5;  // / 2.5
-            else n = n / 2; // / 2
+        if(v == 5 * d)
+          v = (v * 2) / 5;  // / 2.5
+            else v = v / 2; // / 2
       }
-      v = n;
+      if(v > Max) v = Max;
     }
     else if(m == PAR_SIF || m == PAR_SRF)
     {
@@ -685,6 +873,8 @@ bool ParUpDn(char m, bool dir)
       if(v < Min) v = Min;
     }
     Par[m] = v;
+    if(m == PAR_WIN)               //new window type, default length
+      Par[PAR_WLEN] = v? 1000 : WIN_SIZE;
     return(1);
   }
   return(0);
@@ -696,6 +886,8 @@ void ParToEEPROM(void)
 {
   for(char i = 0; i < PARAMS; i++)
     if(EPar[i] != Par[i]) EPar[i] = Par[i];
+  if(EParams != PARAMS) EParams = PARAMS;
+  if(EModes != MODES) EModes = MODES;
   if(ESignature != SIGNATURE) ESignature = SIGNATURE;
 }
 
@@ -707,14 +899,93 @@ void SetupCounter(void)
   Count_SetGate(Par[PAR_GATE]);  //set gate time
   Count_SetAvg(Par[PAR_AVG]);    //set number of averages
   Count_SetIF(Par[PAR_IF]);      //set IF
-  Count_SetPre(Par[PAR_PRE]);    //set prescaler ratio
+  Fdiv = Pin_FDIV;               //divider state
+  if(!Count_SetPre(Par[PAR_PRE], PreMeasured())) //set prescaler ratio,
+    PreErr = 1;                  //mismatch indication request
   Count_SetInt(Par[PAR_INT]);    //interpolator enable/disable
+  Count_SetFast(Par[PAR_FAST]);  //set fast mode
+  Count_SetFilter(Par[PAR_FLT]); //set filter type
+  Count_SetWin(Par[PAR_WIN], Par[PAR_WLEN]); //set statistics window
   Count_SetFref(Par[PAR_RF]);    //set Fref
+  Port_SetAddr(Par[PAR_ADR]);    //set bus address
+  Port_SetStream(Par[PAR_OUT]);  //set output mode
 
   Scale = EScale[Par[PAR_MODE]];
   Count_SetScale(Scale);         //set scale
 }
 
+//----------------- Measured prescaler ratio for PAR_PRE: --------------------
+
+//ratio measured by two paths is valid while PAR_PRE is the same,
+//returns 0 if not measured
+
+int PreMeasured(void)
+{
+  if(EPreFor != Par[PAR_PRE] || !Pre_Valid(EPreMeas)) return(0);
+  return(EPreMeas);
+}
+
+//------------------------ Exit from setup menu: -----------------------------
+
+void SetupExit(void)
+{
+  ParToEEPROM();                 //save parameters to EEPROM
+  SetupCounter();
+  Count_Start();                 //start counter
+  Menu = PreErr? MNU_PRE : MNU_MAIN; //go to main menu
+}
+
+//-------------------- Parameter command via UART: ---------------------------
+
+//query answers Par[] and changes nothing; set takes a value the
+//setup menu could show (ParValid), then saves params and restarts
+//the counter as SetupExit() does, only if the value is new;
+//set is refused while setup menu is open; the answer is always
+//the value after the command
+
+void ParCommand(void)
+{
+  char m; long v;
+  char c = Port_GetPar(&m, &v);
+  if(!c || m >= PARAMS) return;  //no command or no such param
+  if((c & PC_SET) && Menu != MNU_SETUP && Par[m] != v && ParValid(m, v))
+  {
+    Count_Stop();                //stop counter
+    Par[m] = v;
+    if(m == PAR_WIN)             //new window type, default length
+      Par[PAR_WLEN] = v? 1000 : WIN_SIZE;
+    ParToEEPROM();               //save parameters to EEPROM
+    SetupCounter();
+    Count_Start();               //start counter
+    if(Menu == MNU_MAIN)
+    {
+      if(PreErr) Menu = MNU_PRE; //prescaler mismatch indication
+      DispMenu = MNU_NO;         //redraw menu
+    }
+  }
+  if(!(c & PC_BRD))
+    Port_ParAnswer(m, Par[m]);   //answer value
+}
+
+//------------------------- Check param value: -------------------------------
+
+//value is in limits and on the grid of ParUpDn() steps:
+//1-2-5 for gate, averages and time window, decades for steps
+
+bool ParValid(char m, long v)
+{
+  long Max = ParLim[m][P_MAX];
+  if(m == PAR_WLEN && !Par[PAR_WIN]) Max = WIN_SIZE; //results window
+  if(v < ParLim[m][P_MIN] || v > Max) return(0);
+  bool d = m == PAR_SIF || m == PAR_SRF;
+  if(d || m == PAR_GATE || m == PAR_AVG || (m == PAR_WLEN && Par[PAR_WIN]))
+  {
+    while(!(v % 10)) v = v / 10; //mantissa
+    return(v == 1 || (!d && (v == 2 || v == 5)));
+  }
+  return(1);
+}
+
 //----------------------------------------------------------------------------
 
 
@@ -8,6 +8,40 @@
 #ifndef MenuH
 #define MenuH
 
+//------------------------------- Constants: ---------------------------------
+
+//Parameters (Par[] of Menu.c, EEPROM order: new ones are appended):
+
+enum
+{
+  PAR_MODE, //mode parameter index
+  PAR_GATE, //gate parameter index
+  PAR_AVG,  //average parameter index
+  PAR_IF,   //IF parameter index
+  PAR_PRE,  //prescaler parameter index
+  PAR_INT,  //interpolator parameter index
+  PAR_RF,   //RF parameter index
+  PAR_SIF,  //IF step parameter index
+  PAR_SRF,  //RF step parameter index
+  PAR_ADR,  //bus address parameter index
+  PAR_OUT,  //output mode parameter index
+  PAR_FAST, //fast mode parameter index
+  PAR_FLT,  //filter type parameter index
+  PAR_LVL,  //level calibration point parameter index
+  PAR_WIN,  //statistics window type parameter index
+  PAR_WLEN, //statistics window length parameter index
+  PARAMS    //params count
+};
+
+//Limits (ParLim columns of Menu.c):
+
+enum
+{ P_MIN,    //min value
+  P_NOM,    //nom value
+  P_MAX,    //max value
+  LIMS
+};
+
 //------------------------- Function prototypes: -----------------------------
 
 void Menu_Init(void);  //menu init
@@ -13,7 +13,12 @@
 
 #define MUX_INP     6   //ADC channel 6 (main input level)
 #define MUX_PRE     7   //ADC channel 7 (prescaler input level)
-#define ADC_RES   255   //ADC resolution
+#define CH_INP      0   //main input channel index
+#define CH_PRE      1   //prescaler input channel index
+#define ADC_BLK    16   //conversions per channel before switch
+#define ADC_SKIP    2   //conversions skipped after channel switch
+#define LVL_OVS     4   //oversampling extra bits
+#define ADC_RES  (1023 << LVL_OVS) //level code resolution
 #define BAR_INT   100   //level bar integration time, ms
 #define BAR_DEC  1000   //level bar decay time, ms
 #ifdef DIG_DISPLAY
@@ -26,31 +31,113 @@
 
 #define BAR_BRS (BAR_LNG * BAR_BPC)  //total bars count
 #define BAR_STP (BAR_BRS * BAR_INT / BAR_DEC) //bar decay step
-#define BAR_FIR ((int)(BAR_INT * 1E3 / T_SYS)) //level bar FIR points
+#define BAR_FIR ((int)(BAR_INT * 1E3 / T_SYS)) //level bar integration ticks
 
 #ifdef DIG_DISPLAY
   #define DIG_INT   300   //digital level integration time, ms
-  #define DIG_SLP    20   //25   //digital level slope, mV/dBm
-  #define DIG_REF  1770   //2100   //digital level reference point, mV at 0 dBm
+  #define DIG_SLP    20   //25   //default level slope, mV/dBm
+  #define DIG_REF  1770   //2100   //default level reference point, mV at 0 dBm
   #define V_REF    2560   //reference voltage, mV
+  #define CAL_SIGN 0xCA1B //calibration table EEPROM signature
 
   #define DIG_FIR (DIG_INT / BAR_INT) //level digs FIR points
 #endif
 
-#define ADCSR_VAL ((1 << ADEN) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0))
-#define ADMUX_VAL ((1 << REFS1) | (1 << REFS0) | (1 << ADLAR))
+//free running, ADC clock = F_CLK / 128, 13 clocks per conversion
+#define ADCSR_VAL ((1 << ADEN) | (1 << ADFR) | (1 << ADIE) | \
+                   (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0))
+#define ADMUX_VAL ((1 << REFS1) | (1 << REFS0))
 #define ADC_START (1 << ADSC)
 
 //------------------------------ Variables: ----------------------------------
 
 static char BarFilter;    //bar filter points counter
-static unsigned int AdcCode; //ADC code
+static unsigned int AdcCode; //level code
+static unsigned long AdcSum[2]; //ADC codes sum for channels
+static unsigned int AdcCnt[2];  //ADC codes count for channels
+static char AdcChan;      //current ADC channel index
+static char AdcN;         //conversions count in block
+static char AdcSkip;      //conversions to skip
 static char BarPos;       //current bar position
 static bool BarUpdated;   //bar update flag
 #ifdef DIG_DISPLAY
   static char DigFilter;  //digit filter points counter
   static unsigned int DigCode; //code for digital level display
-  static char DigVal;     //value for digital level display
+  static unsigned int DigVal; //value for digital level display
+
+  __no_init __eeprom int ECalSign; //calibration table signature
+  __no_init __eeprom unsigned int ECal[2][CAL_PTS]; //level codes at CAL_MIN..CAL_MAX
+#endif
+
+//------------------------- Function prototypes: -----------------------------
+
+#pragma vector = ADC_vect
+__interrupt void Adc_Int(void);   //ADC conversion complete interrupt
+__monitor void Meter_Take(char ch, unsigned long *s, unsigned int *n); //take channel sum
+#ifdef DIG_DISPLAY
+  signed char Meter_dBm(unsigned int c); //level code to dBm conversion
+#endif
+
+//------------------- ADC conversion complete interrupt: ---------------------
+
+//ADC runs continuously and both channels are sampled in turn
+//by ADC_BLK conversions, 10 bit codes are summed per channel
+
+#pragma vector = ADC_vect
+__interrupt void Adc_Int(void)
+{
+  unsigned int a = ADC;
+  if(AdcSkip)
+  {
+    AdcSkip--;          //conversion started before channel switch
+  }
+  else
+  {
+    AdcSum[AdcChan] += a;
+    AdcCnt[AdcChan]++;
+  }
+  if(++AdcN >= ADC_BLK)
+  {
+    AdcN = 0;
+    AdcChan = !AdcChan; //switch channel,
+    ADMUX = ADMUX_VAL | (AdcChan? MUX_PRE : MUX_INP); //next conversion
+    AdcSkip = ADC_SKIP; //uses new channel
+  }
+}
+
+//------------------------- Take channel sum: --------------------------------
+
+//returns sum and count of channel codes,
+//sums of both channels are cleared
+
+__monitor void Meter_Take(char ch, unsigned long *s, unsigned int *n)
+{
+  *s = AdcSum[ch];
+  *n = AdcCnt[ch];
+  AdcSum[CH_INP] = AdcSum[CH_PRE] = 0;
+  AdcCnt[CH_INP] = AdcCnt[CH_PRE] = 0;
+}
+
+#ifdef DIG_DISPLAY
+
+//----------------------- Level code to dBm conversion: ----------------------
+
+//piecewise-linear interpolation between calibration points,
+//end segments are extrapolated, result is rounded to 1 dB
+
+signed char Meter_dBm(unsigned int c)
+{
+  char ch = Pin_FDIV? CH_PRE : CH_INP;
+  char i = 0;
+  while(i < CAL_PTS - 2 && c > ECal[ch][i + 1]) i++; //find segment
+  int c0 = ECal[ch][i];
+  int d = ECal[ch][i + 1] - c0;      //segment codes span
+  if(d <= 0) d = 1;                  //bad table protection
+  int x = (long)((int)c - c0) * (CAL_STP * 2) / d; //offset, 0.5 dB
+  x = (x < 0)? (x - 1) / 2 : (x + 1) / 2;          //rounding
+  return(CAL_MIN + i * CAL_STP + x);
+}
+
 #endif
 
 //----------------------------------------------------------------------------
@@ -61,13 +148,30 @@ static bool BarUpdated;   //bar update flag
 
 void Meter_Init(void)
 {
-  ADCSR = ADCSR_VAL;
+  AdcChan = CH_INP;
+  AdcN = 0;
+  AdcSkip = ADC_SKIP;
+  AdcSum[CH_INP] = AdcSum[CH_PRE] = 0;
+  AdcCnt[CH_INP] = AdcCnt[CH_PRE] = 0;
+  ADMUX = ADMUX_VAL | MUX_INP;
+  ADCSR = ADCSR_VAL | ADC_START; //start free running conversions
   BarFilter = BAR_FIR;
   AdcCode = 0;
   BarUpdated = 0;
 #ifdef DIG_DISPLAY
   DigFilter = DIG_FIR;
   DigCode = 0;
+  if(ECalSign != CAL_SIGN)   //no calibration, use default slope:
+  {
+    for(char i = 0; i < CAL_PTS; i++)
+    {
+      unsigned int c = (long)(DIG_REF + (CAL_MIN + i * CAL_STP) * DIG_SLP) *
+        ADC_RES / V_REF;
+      ECal[CH_INP][i] = c;
+      ECal[CH_PRE][i] = c;
+    }
+    ECalSign = CAL_SIGN;
+  }
 #endif
 }
 
@@ -79,18 +183,20 @@ void Meter_Exe(bool t)
   {
     if(BarFilter)
     {
-      AdcCode += ADCH;     //read and accumulate ADC.9..ADC.2
       BarFilter--;         //next point
     }
     else
     {
-      char bar = AdcCode / BAR_FIR * BAR_BRS / ADC_RES;
+      unsigned long s; unsigned int n;
+      Meter_Take(Pin_FDIV? CH_PRE : CH_INP, &s, &n);
+      if(n) AdcCode = (s << LVL_OVS) / n; //averaged level code
+      char bar = (long)AdcCode * BAR_BRS / ADC_RES;
       if(BarPos > bar + BAR_STP) BarPos = BarPos - BAR_STP;
         else BarPos = bar;
 #ifdef DIG_DISPLAY
       if(DigFilter)
       {
-        DigCode += AdcCode / BAR_FIR;
+        DigCode += AdcCode;
         DigFilter--;
       }
       else
@@ -102,10 +208,7 @@ void Meter_Exe(bool t)
 #endif
       BarUpdated = 1;
       BarFilter = BAR_FIR;  //new cycle
-      AdcCode = 0;
     }
-    ADMUX = ADMUX_VAL | (Pin_FDIV? MUX_PRE : MUX_INP);
-    ADCSR |= ADC_START;
   }
 }
 
@@ -137,8 +240,7 @@ void Meter_Display(void)
   LCD_WrCmd(LINE2 + 0); //line = 2, pos = 1
 #ifdef DIG_DISPLAY
   //digital display:
-  int v = (long)DigVal * V_REF / ADC_RES;
-  signed char dB = (v - DIG_REF) / DIG_SLP;
+  signed char dB = Meter_dBm(DigVal);
   if(dB < 0)
   {
     LCD_WrData('-');
@@ -172,4 +274,22 @@ void Meter_Display(void)
   }
 }
 
+//------------------------ Capture calibration point: ------------------------
+
+//current level code of active input is saved to EEPROM
+//as the code for dbm level, the generator must be set to this level
+
+void Meter_CalPoint(signed char dbm)
+{
+#ifdef DIG_DISPLAY
+  if(dbm >= CAL_MIN && dbm <= CAL_MAX)
+  {
+    char ch = Pin_FDIV? CH_PRE : CH_INP;
+    ECal[ch][(dbm - CAL_MIN) / CAL_STP] = DigVal;
+  }
+#else
+  (void)dbm;                          //no digital level meter
+#endif
+}
+
 //----------------------------------------------------------------------------
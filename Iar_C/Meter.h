@@ -10,6 +10,10 @@
 //----------------------------- Constants: -----------------------------------
 
 #define LINE2 0xC0           //line 2 code for 1602 LCD
+#define CAL_MIN  -40         //level calibration min point, dBm
+#define CAL_MAX   20         //level calibration max point, dBm
+#define CAL_STP   10         //level calibration step, dBm
+#define CAL_PTS ((CAL_MAX - CAL_MIN) / CAL_STP + 1) //calibration points
 
 //------------------------- Function prototypes: -----------------------------
 
@@ -18,6 +22,7 @@ void Meter_Exe(bool t);      //level measure
 void Meter_Clear(void);      //clear meter line
 bool Meter_Updated(void);    //check meter update
 void Meter_Display(void);    //display meter line
+void Meter_CalPoint(signed char dbm); //capture calibration point
 
 //----------------------------------------------------------------------------
 
@@ -8,23 +8,62 @@
 #include "Port.h"
 #include "Disp.h"
 #include "Keyboard.h"
+#include "Count.h"
 
 //----------------------------- Constants: -----------------------------------
 
 #define BAUD 19200 //UART baud rate
-#define TX_CR 16   //CR symbol index
-#define TX_LF 17   //LF symbol index
+#define TX_CHR 16  //display chars in TX frame
+#define TX_SIZE 44 //TX frame size (max of: address + seq + text + CR + LF,
+                   //result line: 5 + 10 + 2 + 21 chars, 3 commas, CR + LF)
+#define CMD_HDR '#' //addressed command header ("#nnC")
+#define RSP_HDR '$' //addressed response header ("$nn...")
+#define ADR_BRD  0  //broadcast address (no response)
+#define PAR_CMD 'P' //parameter command ("Pnn", "Pnn=value")
+#define PAR_DIG  9  //max value digits
+
+//parameter command receive states:
+
+#define RP_NO    0  //no command
+#define RP_NUM   1  //number digits (1, 2)
+#define RP_EQU   3  //'=' or end
+#define RP_SGN   4  //sign or first value digit
+#define RP_VAL   5  //value digits
+#define RP_GET   6  //query received
+#define RP_SET   7  //set received
+#define RX_NEG 0x80 //RxDig: negative value
+#define RX_BRD 0x40 //RxDig: broadcast command (no response)
+#define RX_DIG 0x3F //RxDig: value digits mask
 
 #define UBRRV (int)((F_CLK * 1E6)/(16.0 * BAUD) - 0.5)
 
 //------------------------------ Variables: ----------------------------------
 
+static char TxBuf[TX_SIZE]; //TX frame buffer
 static char TxPtr;         //TX buffer pointer
+static char TxLen;         //TX frame length
+static bool TxReq;         //TX request pending
+static bool TxId;          //ID TX request pending
+static char Addr;          //bus address, 0 - not addressed mode
+static char RxState;       //addressed command receive state
+static char RxAddr;        //addressed command address
+static bool Stream;        //result stream mode
+static char RxPar;         //parameter command receive state
+static char RxNum;         //parameter number
+static long RxVal;         //parameter value
+static char RxDig;         //value digits, RX_NEG, RX_BRD flags
+static char TxPar;         //parameter to TX, PAR_NONE - none
+static long TxVal;         //parameter value to TX
 
 //------------------------- Function prototypes: -----------------------------
 
 #pragma vector = USART_RXC_vect
 __interrupt void Rx_Int(void); //RX complete interrupt
+void Port_Frame(void);         //load TX frame
+void Port_IdFrame(void);       //load ID frame
+char Port_Head(void);          //load response header
+void Port_ResFrame(void);      //load result line
+void Port_ParFrame(void);      //load parameter frame
 
 //----------------------------------------------------------------------------
 //--------------------------- Exported functions: ----------------------------
@@ -37,7 +76,14 @@ void Port_Init(void)
   UBRRL = LO(UBRRV);   //set up baud rate
   UBRRH = HI(UBRRV);
   UCSRB = (1 << RXCIE) | (1 << RXEN) | (1 << TXEN); //RX, TX enable
-  TxPtr = TX_LF + 1;   //do not TX
+  TxPtr = TxLen = 0;   //TX buffer empty
+  TxReq = 0;           //do not TX
+  TxId = 0;
+  Addr = 0;            //not addressed mode
+  Stream = 0;          //display copy mode
+  RxState = 0;
+  RxPar = RP_NO;
+  TxPar = PAR_NONE;
 }
 
 //----------------------- TX display copy via UART: --------------------------
@@ -46,17 +92,38 @@ void Port_Exe(bool t)
 {
   if(t)
   {
-    if(!TxPtr) UDR = Disp_GetChar(TxPtr++);
-    else if(TxPtr <= TX_LF)
+    if(TxPtr < TxLen)      //frame TX in progress
     {
-      if(UCSRA & (1 << TXC))
+      if(UCSRA & (1 << UDRE))
       {
-        UCSRA = 1 << TXC; //reset TXC flag
-        if(TxPtr == TX_CR) { UDR = '\r'; TxPtr++; }
-        else if(TxPtr == TX_LF) { UDR = '\n'; TxPtr++; }
-        else UDR = Disp_GetChar(TxPtr++);
+        UCSRA = 1 << TXC;  //reset TXC flag
+        UDR = TxBuf[TxPtr++];
       }
     }
+    else if(Addr && (UCSRB & (1 << TXEN)))
+    {
+      if(UCSRA & (1 << TXC))
+        UCSRB &= ~(1 << TXEN); //last bit sent, release bus
+    }
+    else if(TxId)          //ID requested
+    {
+      TxId = 0;
+      Port_IdFrame();      //load ID
+    }
+    else if(TxPar != PAR_NONE) //parameter answer
+    {
+      Port_ParFrame();     //load parameter
+      TxPar = PAR_NONE;
+    }
+    else if(TxReq)         //TX requested
+    {
+      TxReq = 0;
+      Port_Frame();        //take display copy
+    }
+    else if(Count_NewResult() && Stream && !Addr)
+    {
+      Port_ResFrame();     //load result line
+    }
   }
 }
 
@@ -67,6 +134,82 @@ __interrupt void Rx_Int(void)
 {
   char data = UDR;
   char code = KEY_NO;
+  if(RxPar && RxPar < RP_GET)     //parameter command: "Pnn[=value]"
+  {
+    if(RxPar < RP_EQU)
+    {
+      if(data >= '0' && data <= '9')
+      {
+        RxNum = RxNum * 10 + data - '0'; //number digit
+        RxPar++;
+        return;
+      }
+    }
+    else if(data == '\r' || data == '\n')
+    {
+      if(RxPar == RP_EQU)         //query
+      {
+        RxPar = (RxDig & RX_BRD)? RP_NO : RP_GET; //no response allowed
+        return;
+      }
+      if(RxPar == RP_VAL)         //set
+      {
+        RxPar = RP_SET;
+        return;
+      }
+    }
+    else if(RxPar == RP_EQU)
+    {
+      if(data == '=') { RxPar = RP_SGN; return; }
+    }
+    else if(RxPar == RP_SGN && data == '-')
+    {
+      RxDig |= RX_NEG;            //negative value
+      return;
+    }
+    else if(data >= '0' && data <= '9' && (RxDig & RX_DIG) < PAR_DIG)
+    {
+      RxVal = RxVal * 10 + data - '0'; //value digit
+      RxDig++;
+      RxPar = RP_VAL;
+      return;
+    }
+    RxPar = RP_NO;                //wrong command, skip it
+  }
+  if(Addr)                        //addressed mode: "#nnC"
+  {
+    if(data == CMD_HDR)           //header received
+    {
+      RxState = 1;
+      RxAddr = 0;
+      return;
+    }
+    if(RxState == 1 || RxState == 2)
+    {
+      if(data >= '0' && data <= '9')
+      {
+        RxAddr = RxAddr * 10 + data - '0'; //address digit
+        RxState++;
+      }
+      else RxState = 0;           //wrong address, skip command
+      return;
+    }
+    if(RxState != 3) return;      //no header, not for us
+    RxState = 0;
+    if(RxAddr == ADR_BRD)         //broadcast command:
+    {
+      if(data == 'R' || data == '?') return; //no response allowed
+    }
+    else if(RxAddr != Addr) return; //command for another device
+  }
+  if(data == PAR_CMD && RxPar == RP_NO) //parameter command start
+  {
+    RxPar = RP_NUM;
+    RxNum = 0;
+    RxVal = 0;
+    RxDig = (Addr && RxAddr == ADR_BRD)? RX_BRD : 0;
+    return;
+  }
   switch(data)
   {
   case 'M': code = KEY_MN; break; //"MENU" code
@@ -75,16 +218,193 @@ __interrupt void Rx_Int(void)
   case 'K': code = KEY_OK; break; //"OK" code
   case 'A': code = KEY_UD; break; //"DOWN" + "UP" ("Auto Scale") code
   case 'C': code = KEY_MK; break; //"MENU" + "OK" ("Calibrate") code
+  case 'R': TxReq = 1; break;     //"Read" code, TX display copy now
+  case '?': TxId = 1; break;      //"Identify" code, TX ID frame
+  case 'S': Count_Sync(); break;  //"Sync" code, arm or start gate
   }
   Keyboard_SetCode(code);  
 }
 
+//--------------------------- Load TX frame: ---------------------------------
+
+//Display copy is taken at once, so frame is never torn
+//by display redraw while it is transmitted
+
+void Port_Frame(void)
+{
+  char n = Port_Head();
+  unsigned int q = Count_GetSeq();
+  if(q)                  //synced result, add sequence number
+  {
+    for(signed char i = 4; i >= 0; i--)
+    {
+      TxBuf[n + i] = q % 10 + 0x30;
+      q = q / 10;
+    }
+    TxBuf[n + 5] = ' ';
+    n = n + 6;
+  }
+  for(char i = 0; i < TX_CHR; i++)
+    TxBuf[n++] = Disp_GetChar(i);
+  TxBuf[n++] = '\r';
+  TxBuf[n++] = '\n';
+  TxLen = n;
+  TxPtr = 0;
+}
+
+//--------------------------- Load ID frame: ---------------------------------
+
+static __flash char Str_Id[] = "FC-510 V";
+
+void Port_IdFrame(void)
+{
+  char n = Port_Head();
+  for(char __flash *s = Str_Id; *s; s++)
+    TxBuf[n++] = *s;
+  TxBuf[n++] = (char)VERSION + 0x30;
+  TxBuf[n++] = '.';
+  TxBuf[n++] = (char)(VERSION * 10) % 10 + 0x30;
+  TxBuf[n++] = '\r';
+  TxBuf[n++] = '\n';
+  TxLen = n;
+  TxPtr = 0;
+}
+
+//--------------------------- Load result line: ------------------------------
+
+//one line per measurement: number,time,mode,value
+//time - result time from power on, ms
+//value - full precision, display units (kHz, ms, rpm, ...)
+//example: 123,45678,0,10000.000012345
+
+void Port_ResFrame(void)
+{
+  unsigned int num; unsigned long tm; char m;
+  long long v = Count_GetResult(&num, &tm, &m);
+  char n = Disp_Fmt(TxBuf, num, 0);
+  TxBuf[n++] = ',';
+  n = n + Disp_Fmt(&TxBuf[n], tm, 0);
+  TxBuf[n++] = ',';
+  n = n + Disp_Fmt(&TxBuf[n], m, 0);
+  TxBuf[n++] = ',';
+  n = n + Disp_Fmt(&TxBuf[n], v, FULL_DEC);
+  TxBuf[n++] = '\r';
+  TxBuf[n++] = '\n';
+  TxLen = n;
+  TxPtr = 0;
+}
+
+//-------------------------- Load parameter frame: ---------------------------
+
+//answer to parameter command: Pnn=value
+//value as Par[] of Menu.c, example: P01=1000
+
+void Port_ParFrame(void)
+{
+  char n = Port_Head();
+  TxBuf[n++] = PAR_CMD;
+  TxBuf[n++] = TxPar / 10 + 0x30;
+  TxBuf[n++] = TxPar % 10 + 0x30;
+  TxBuf[n++] = '=';
+  n = n + Disp_Fmt(&TxBuf[n], TxVal, 0);
+  TxBuf[n++] = '\r';
+  TxBuf[n++] = '\n';
+  TxLen = n;
+  TxPtr = 0;
+}
+
+//------------------------ Load response header: ----------------------------
+
+//in addressed mode response starts with "$nn" and
+//bus is driven only while response is transmitted
+
+char Port_Head(void)
+{
+  if(!Addr) return(0);
+  TxBuf[0] = RSP_HDR;
+  TxBuf[1] = Addr / 10 + 0x30;
+  TxBuf[2] = Addr % 10 + 0x30;
+  UCSRB |= 1 << TXEN;    //take bus
+  return(3);
+}
+
 //------------------------------ Start TX: -----------------------------------
 
+//if TX is busy, request is kept and the latest
+//display state is sent after current frame,
+//in addressed mode and in result stream mode
+//display copy is sent by request only
+
 void Port_StartTX(void)
 {
-  if(TxPtr == TX_LF + 1) //TX ready,
-    TxPtr = 0;           //request to TX 
+  if(!Addr && !Stream)
+    TxReq = 1;           //request to TX
+}
+
+//-------------------------- Set output mode: --------------------------------
+
+//s = 1 - result stream (not used in addressed mode)
+//s = 0 - display copy
+
+void Port_SetStream(bool s)
+{
+  Stream = s;
+}
+
+//------------------------- Get parameter command: ---------------------------
+
+//returns PC_NO if no command received,
+//PC_GET - query of parameter m, PC_SET - set parameter m to v;
+//the command is taken, next one is received after that
+
+char Port_GetPar(char *m, long *v)
+{
+  char c = PC_NO;
+  if(RxPar == RP_GET) c = PC_GET;
+  if(RxPar == RP_SET) c = PC_SET;
+  if(c)
+  {
+    *m = RxNum;
+    *v = (RxDig & RX_NEG)? -RxVal : RxVal;
+    if(RxDig & RX_BRD) c = c | PC_BRD; //broadcast, no answer
+    RxPar = RP_NO;
+  }
+  return(c);
+}
+
+//---------------------------- Parameter answer: -----------------------------
+
+//answer to parameter command, sent when TX is free
+
+void Port_ParAnswer(char m, long v)
+{
+  TxPar = m;
+  TxVal = v;
+}
+
+//---------------------------- Set bus address: ------------------------------
+
+//a = 1..99 - addressed multi-drop mode
+//a = 0 - display copy is sent after each redraw
+
+void Port_SetAddr(char a)
+{
+  UCSRB &= ~(1 << TXEN); //abort TX
+  TxPtr = TxLen = 0;
+  TxReq = TxId = 0;
+  TxPar = PAR_NONE;
+  RxState = 0;
+  RxPar = RP_NO;
+  Addr = a;
+  if(Addr)
+  {
+    DDRD &= ~TXD;        //release bus, TXD pull-up
+  }
+  else
+  {
+    DDRD |= TXD;
+    UCSRB |= 1 << TXEN;  //TX enable
+  }
 }
 
 //----------------------------------------------------------------------------
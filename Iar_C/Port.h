@@ -7,11 +7,26 @@
 #ifndef PortH
 #define PortH
 
+//----------------------------- Constants: -----------------------------------
+
+#define PAR_NONE 0xFF //no parameter
+
+//parameter commands (Port_GetPar):
+
+#define PC_NO    0    //no command
+#define PC_GET   1    //query
+#define PC_SET   2    //set
+#define PC_BRD   4    //flag: broadcast command, no answer
+
 //------------------------- Function prototypes: -----------------------------
 
 void Port_Init(void);       //port init
 void Port_Exe(bool t);      //TX display copy via UART
 void Port_StartTX(void);    //TX request
+void Port_SetAddr(char a);  //set bus address
+void Port_SetStream(bool s); //set output mode
+char Port_GetPar(char *m, long *v); //get parameter command
+void Port_ParAnswer(char m, long v); //answer to parameter command
 
 //----------------------------------------------------------------------------
 
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//prescaler link module
+
+//----------------------------------------------------------------------------
+
+//Single wire open drain link to the prescaler MCU (ATmega8 PB7 to
+//ATtiny25 PB4, both are XTAL2 pins, free with external clock).
+//Each bit is a low phase followed by a high phase, bit value is coded
+//by the phases ratio, so the link does not depend on the slave clock:
+//0 - low 1T, high 3T; 1 - low 3T, high 1T. Frame is PRE_BITS bits,
+//MSB first, terminated by the stop low pulse. Prescaler MCU answers
+//by the same frame with the ratio actually loaded into the LMX2324,
+//it saves the ratio to its EEPROM after the answer, so LINK_WAIT
+//covers the LMX2324 load only. ATtiny25 (Prescaler_C) and ATtiny12
+//(Prescaler.asm, PB4) firmwares have the same link.
+
+#include "Main.h"
+#include "Pre.h"
+
+//----------------------------- Constants: -----------------------------------
+
+#define LINK_T     100 //link time unit, us
+#define LINK_POLL    2 //answer wait poll period, us
+#define LINK_WAIT   20 //answer timeout, ms
+
+//------------------------- Function prototypes: -----------------------------
+
+void Pre_Phase(bool p, char t); //link phase generation
+int  Pre_Answer(void);          //receive prescaler MCU answer
+
+//---------------------------- Phase generation: -----------------------------
+
+void Pre_Phase(bool p, char t)
+{
+  if(p) Port_PLINK_1;
+    else Port_PLINK_0;
+  while(t--) Delay_us(LINK_T);
+}
+
+//----------------------- Receive prescaler MCU answer: ----------------------
+
+//returns answered ratio or 0 if no answer or frame error
+
+int Pre_Answer(void)
+{
+  unsigned int n = 0;
+  unsigned int t = 0;
+  while(Pin_PLINK)
+  {
+    Delay_us(LINK_POLL);
+    if(++t > LINK_WAIT * 1000 / LINK_POLL) return(0); //no answer
+  }
+  for(char i = 0; i < PRE_BITS; i++)
+  {
+    unsigned int lo = 0, hi = 0;
+    while(!Pin_PLINK) if(!++lo) return(0); //low phase
+    while(Pin_PLINK) if(!++hi) return(0);  //high phase
+    n = (n << 1) | (lo > hi);
+  }
+  t = 0;
+  while(!Pin_PLINK) if(!++t) return(0);    //stop pulse
+  return(Pre_Valid(n)? n : 0);
+}
+
+//----------------------------------------------------------------------------
+//--------------------------- Exported functions: ----------------------------
+//----------------------------------------------------------------------------
+
+//-------------------------- Check LMX2324 ratio: ----------------------------
+
+//N = NB * 32 + NA, NB = 3..1023, NA = 0..31, NA <= NB
+
+bool Pre_Valid(int n)
+{
+  int nb = n / PRE_LMX;
+  int na = n % PRE_LMX;
+  return(n > 0 && nb >= 3 && nb <= 1023 && na <= nb);
+}
+
+//----------------------- Send ratio to prescaler MCU: -----------------------
+
+//invalid ratio (0) is not loaded, so it can be used as a query,
+//returns the ratio loaded into the LMX2324 or 0 if no answer
+
+int Pre_Load(int n)
+{
+  for(char i = 0; i < PRE_BITS; i++)
+  {
+    bool b = n & (1 << (PRE_BITS - 1));
+    Pre_Phase(0, b? 3 : 1);     //low phase
+    Pre_Phase(1, b? 1 : 3);     //high phase
+    n = n << 1;
+  }
+  Pre_Phase(0, 1);              //stop pulse
+  Port_PLINK_1;                 //release line
+  return(Pre_Answer());
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,23 @@
+//----------------------------------------------------------------------------
+
+//Frequency Counter FC-510
+//prescaler link module: header file
+
+//----------------------------------------------------------------------------
+
+#ifndef PreH
+#define PreH
+
+//----------------------------- Constants: -----------------------------------
+
+#define PRE_LMX     32 //LMX2324 built-in prescaler ratio
+#define PRE_BITS    16 //link frame length, bits
+
+//------------------------- Function prototypes: -----------------------------
+
+bool Pre_Valid(int n);       //check LMX2324 ratio
+int  Pre_Load(int n);        //send ratio to prescaler MCU
+
+//----------------------------------------------------------------------------
+
+#endif